@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-rate-controller.h"
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xRateController controller(sht3x);
+
+// Setup the serial communications and start at the slowest mode
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    // react to 0.03C/s already and never go slower than 1 mps
+    Sht3xRateController::Policy policy = controller.get_policy();
+    policy.temperature_up = 3;
+    policy.min_mps = Mps::MPS_1;
+    controller.set_policy(policy);
+
+    controller.start();
+}
+
+
+void loop() {
+    // the period follows the mode selected by the controller
+    delay(sht3x.get_period_ms());
+    if (controller.fetch() != Sht3x::I2C_STATUS::SUCCESS) {
+        return;
+    }
+
+    Serial.print("Temperature: ");
+    Serial.print(sht3x.get_temperature());
+    Serial.print("C rh: ");
+    Serial.print(sht3x.get_rh());
+    Serial.print("% period: ");
+    Serial.print(sht3x.get_period_ms());
+    Serial.println("ms");
+}
@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+/*
+ * Threshold monitoring with the ALERT pin.
+ * The sensor measures periodically and compares every reading
+ * with the alert limits itself. The bus is only used when the
+ * ALERT pin goes high, instead of fetching every reading.
+ */
+
+#define ALERT_PIN 4
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+
+void on_alert() {
+    sht3x.notify_alert();
+}
+
+
+// Setup the serial communications, the limits and the interrupt
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    // alert above 30C or 70%, cleared again below 29C and 68%
+    sht3x.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 3000, 7000);
+    sht3x.write_alert_limit(Sht3x::AlertLimit::HIGH_CLEAR, 2900, 6800);
+    // alert below 5C or 20%, cleared again above 6C and 22%
+    sht3x.write_alert_limit(Sht3x::AlertLimit::LOW_SET, 500, 2000);
+    sht3x.write_alert_limit(Sht3x::AlertLimit::LOW_CLEAR, 600, 2200);
+
+    int16_t temperature = 0;
+    uint16_t rh = 0;
+    sht3x.read_alert_limit(Sht3x::AlertLimit::HIGH_SET, temperature, rh);
+    Serial.print("High set limit stored as ");
+    Serial.print(temperature / 100.0f);
+    Serial.print("C ");
+    Serial.print(rh / 100.0f);
+    Serial.println("%");
+
+    pinMode(ALERT_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(ALERT_PIN), on_alert, RISING);
+
+    // alerts are only evaluated in periodic data acquisition mode
+    // 1 mps medium repeatability
+    sht3x.set_periodic_data_acquisition(5);
+}
+
+
+void loop() {
+    if (!sht3x.alert_pending()) {
+        // nothing to do, the bus stays idle
+        return;
+    }
+
+    Sht3x::AlertStatus alert;
+    if (sht3x.service_alert(alert) != Sht3x::I2C_STATUS::SUCCESS) {
+        Serial.println("Error reading the alert status");
+        return;
+    }
+
+    sht3x.fetch_data();
+    Serial.println("===================================================");
+    if (alert.temperature_alert) {
+        Serial.print("Temperature alert: ");
+        Serial.print(sht3x.get_temperature());
+        Serial.println("C");
+    }
+    if (alert.rh_alert) {
+        Serial.print("rh alert: ");
+        Serial.print(sht3x.get_rh());
+        Serial.println("%");
+    }
+    Serial.println("===================================================");
+}
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-sampler.h"
+
+// This example runs on ESP32, where the sampler uses a FreeRTOS task
+#if !defined(SHT3X_EXECUTOR_FREERTOS)
+#error "This example needs an ESP32"
+#endif
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xFreeRtosExecutor executor;
+Sht3xSampler sampler(sht3x, executor);
+
+// Any number of tasks can read the latest values
+void reader_task(void *name) {
+    Sht3xSnapshot snapshot;
+    while (true) {
+        if (sampler.read(snapshot) && snapshot.status == Sht3x::I2C_STATUS::SUCCESS) {
+            Serial.print((const char *)name);
+            Serial.print(": ");
+            Serial.print(snapshot.timestamp_ms);
+            Serial.print("ms ");
+            Serial.print(sht3x_temperature_centi(snapshot.temperature_raw) / 100.0f);
+            Serial.print("C ");
+            Serial.print(sht3x_rh_centi(snapshot.rh_raw) / 100.0f);
+            Serial.println("%");
+        }
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+
+// Setup the serial communications, the sampler and two readers
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    // the sampler task owns the bus from now on
+    sampler.start(Mps::MPS_10);
+    xTaskCreate(reader_task, "reader 1", 2048, (void *)"reader 1", 1, nullptr);
+    xTaskCreate(reader_task, "reader 2", 2048, (void *)"reader 2", 1, nullptr);
+}
+
+
+void loop() {
+    vTaskDelay(pdMS_TO_TICKS(1000));
+}
@@ -0,0 +1,385 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+/*
+ * Benchmarks every public Sht3x operation in each of its modes,
+ * and the CPU cost of the conversion, command lookup and, with
+ * SHT3X_TRACE, the decode path of fetch_data() and
+ * read_device_status() replayed without the bus.
+ *
+ * Each run prints one JSON object, for example:
+ * {"benchmarks":[
+ *   {"name":"temperature_to_float","ns":...,"max_ns":0,"pass":true},
+ *   {"name":"fetch_data","mode":1,"status":0,"us":914,"max_us":2280,"bytes":8,"max_bytes":8,"pass":true},
+ *   ...
+ * ],"sizeof_sht3x":...,"result":"pass"}
+ *
+ * Bus operations fail the run when they take longer than the
+ * maximum conversion time of the datasheet plus the transfers
+ * at BENCHMARK_I2C_CLOCK_HZ, with a margin. With
+ * -DSHT3X_PERF_COUNTERS=1 they also fail when more bytes than
+ * needed go over the bus. CPU costs depend on the board, their
+ * baselines are 0 (not checked) until they are set below from
+ * a first run. No board run has been recorded yet. The host
+ * build runs this sketch against a simulated sensor in
+ * test/host/test-benchmark.cpp, which checks the CPU costs
+ * against x86-64 baselines of 1-2 ns per conversion and
+ * command and 35-50 ns per replayed decode. Those are far
+ * below any MCU and are not used here. Flash and RAM used by the library come from the
+ * size report of the build, sizeof_sht3x is the RAM per sensor.
+ */
+
+#define BENCHMARK_I2C_CLOCK_HZ          100000
+#define BENCHMARK_MARGIN_PERCENT        20
+#define BENCHMARK_OVERHEAD_US           1200  /*delay(1) polling and CPU time*/
+#define BENCHMARK_ITERATIONS            1000
+#define BENCHMARK_ART_PERIOD_MS         250
+
+/*CPU baselines in ns per call, 0 = not checked*/
+#define BASELINE_TEMPERATURE_TO_FLOAT_NS        0
+#define BASELINE_RH_TO_FLOAT_NS                 0
+#define BASELINE_PERIODIC_COMMAND_NS            0
+#define BASELINE_SINGLE_SHOT_COMMAND_NS         0
+#define BASELINE_REPLAYED_FETCH_DATA_NS         0
+#define BASELINE_REPLAYED_DEVICE_STATUS_NS      0
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+
+bool first_entry;
+bool all_passed;
+
+volatile uint16_t raw_source = 0x6666; /*keeps the compiler from folding the loops*/
+volatile float float_sink;
+volatile uint16_t command_sink;
+
+// Setup the serial communications and the bus
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+}
+
+
+/**
+ * @brief Bus bytes counted by the driver so far
+ */
+uint32_t bus_bytes() {
+#if SHT3X_PERF_COUNTERS
+    const Sht3xPerfCounters &counters = sht3x.get_perf_counters();
+    return counters.bytes_written + counters.bytes_read;
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * @brief Time of one transaction with its address byte at
+ *        the benchmark clock, 9 clocks per byte
+ */
+uint32_t transfer_us(uint8_t bytes) {
+    return bytes == 0 ? 0 : (uint32_t)(bytes + 1) * 9 * 1000000UL / BENCHMARK_I2C_CLOCK_HZ;
+}
+
+
+void print_entry_start(const __FlashStringHelper *name) {
+    Serial.print(first_entry ? "\n  {\"name\":\"" : ",\n  {\"name\":\"");
+    Serial.print(name);
+    Serial.print("\"");
+    first_entry = false;
+}
+
+
+void print_entry_end(bool pass) {
+    Serial.print(pass ? ",\"pass\":true}" : ",\"pass\":false}");
+    all_passed = all_passed && pass;
+}
+
+
+/**
+ * @brief Time one bus operation and report it against its
+ *        datasheet budget
+ *
+ * @param name name of the Sht3x method
+ * @param mode mode of the method, 0 when it has none
+ * @param written bytes the method writes
+ * @param read bytes the method reads
+ * @param conversion_us time the sensor needs before the read
+ * @param operation the call, returns the I2C_STATUS
+ */
+template <typename Operation>
+void bench_bus(const __FlashStringHelper *name, uint8_t mode, uint8_t written,
+    uint8_t read, uint32_t conversion_us, Operation operation) {
+    uint32_t bytes = bus_bytes();
+    unsigned long start = micros();
+    Sht3x::I2C_STATUS status = operation();
+    unsigned long duration = micros() - start;
+    bytes = bus_bytes() - bytes;
+
+    uint32_t budget_us = (conversion_us + transfer_us(written) + transfer_us(read))
+        * (100 + BENCHMARK_MARGIN_PERCENT) / 100 + BENCHMARK_OVERHEAD_US;
+    bool pass = status == Sht3x::I2C_STATUS::SUCCESS && duration <= budget_us;
+
+    print_entry_start(name);
+    Serial.print(",\"mode\":");
+    Serial.print(mode);
+    Serial.print(",\"status\":");
+    Serial.print((uint8_t)status);
+    Serial.print(",\"us\":");
+    Serial.print(duration);
+    Serial.print(",\"max_us\":");
+    Serial.print(budget_us);
+#if SHT3X_PERF_COUNTERS
+    Serial.print(",\"bytes\":");
+    Serial.print(bytes);
+    Serial.print(",\"max_bytes\":");
+    Serial.print((uint32_t)(written + read));
+    pass = pass && bytes <= (uint32_t)(written + read);
+#endif
+    print_entry_end(pass);
+}
+
+
+/**
+ * @brief Report the CPU cost of an operation against its
+ *        baseline
+ *
+ * @param name name of the operation
+ * @param duration_us time of BENCHMARK_ITERATIONS calls
+ * @param baseline_ns largest accepted ns per call, 0 to
+ *        only report
+ */
+void report_cpu(const __FlashStringHelper *name, unsigned long duration_us, uint32_t baseline_ns) {
+    uint32_t ns = duration_us * 1000UL / BENCHMARK_ITERATIONS;
+    bool pass = baseline_ns == 0
+        || ns <= baseline_ns * (100 + BENCHMARK_MARGIN_PERCENT) / 100;
+
+    print_entry_start(name);
+    Serial.print(",\"ns\":");
+    Serial.print(ns);
+    Serial.print(",\"max_ns\":");
+    Serial.print(baseline_ns);
+    print_entry_end(pass);
+}
+
+
+void bench_cpu() {
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        float_sink = sht3x_temperature_centi(raw_source) / 100.0f;
+    }
+    report_cpu(F("temperature_to_float"), micros() - start, BASELINE_TEMPERATURE_TO_FLOAT_NS);
+
+    start = micros();
+    for (uint16_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        float_sink = sht3x_rh_centi(raw_source) / 100.0f;
+    }
+    report_cpu(F("rh_to_float"), micros() - start, BASELINE_RH_TO_FLOAT_NS);
+
+    start = micros();
+    for (uint16_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        uint8_t mode = raw_source + i;
+        command_sink = sht3x_periodic_command(static_cast<Mps>(mode % 5),
+            static_cast<Repeatability>(mode % 3));
+    }
+    report_cpu(F("periodic_command"), micros() - start, BASELINE_PERIODIC_COMMAND_NS);
+
+    start = micros();
+    for (uint16_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        uint8_t mode = raw_source + i;
+        command_sink = sht3x_single_shot_command(static_cast<Repeatability>(mode % 3),
+            static_cast<ClockStretching>(mode & 1));
+    }
+    report_cpu(F("single_shot_command"), micros() - start, BASELINE_SINGLE_SHOT_COMMAND_NS);
+}
+
+
+#if SHT3X_TRACE
+/*Print that keeps a short trace in RAM*/
+class TraceBuffer : public Print {
+    public:
+        uint8_t data[32];
+        size_t size = 0;
+
+        size_t write(uint8_t byte) override {
+            if (this->size >= sizeof(this->data)) {
+                return 0;
+            }
+            this->data[this->size++] = byte;
+            return 1;
+        }
+};
+
+
+/**
+ * @brief Replay a command and its answer many times into a
+ *        sensor that is not on the bus, to time the CPU part
+ *        of an operation: command, CRC checks and decoding
+ */
+template <typename Operation>
+void bench_replayed(const __FlashStringHelper *name, uint16_t command,
+    const uint8_t *answer, uint8_t answer_size, uint32_t baseline_ns, Operation operation) {
+    TraceBuffer trace;
+    Sht3xTraceRecorder recorder(trace);
+    recorder.start();
+    uint8_t cmds[2] = {(uint8_t)(command >> 8), (uint8_t)command};
+    recorder.record(TRACE_RECORD_WRITE, DEVICE_ADDRESS_B, 0, cmds, 2, 0);
+    recorder.record(TRACE_RECORD_READ, DEVICE_ADDRESS_B, 0, answer, answer_size, 0);
+
+    Sht3x replayed(DEVICE_ADDRESS_B);
+    Sht3xTraceReplay replay(trace.data, trace.size);
+    replayed.set_trace_replay(&replay);
+
+    unsigned long start = micros();
+    for (uint16_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        replay.rewind();
+        operation(replayed);
+    }
+    report_cpu(name, micros() - start, baseline_ns);
+}
+
+
+void bench_decode() {
+    const uint8_t measurement[6] = {0xBE, 0xEF, sht3x_crc8_word(0xBEEF),
+        0x66, 0x66, sht3x_crc8_word(0x6666)};
+    bench_replayed(F("replayed_fetch_data"), (FETCH_DATA_MSB << 8) | FETCH_DATA_LSB,
+        measurement, 6, BASELINE_REPLAYED_FETCH_DATA_NS, [](Sht3x &sensor) {
+        sensor.fetch_data();
+        float_sink = sensor.get_temperature() + sensor.get_rh();
+    });
+
+    const uint8_t status_word[3] = {0x80, 0x10, sht3x_crc8_word(0x8010)};
+    bench_replayed(F("replayed_read_device_status"), (READ_STATUS_REGISTER_MSB << 8) | READ_STATUS_REGISTER_LSB,
+        status_word, 3, BASELINE_REPLAYED_DEVICE_STATUS_NS, [](Sht3x &sensor) {
+        Sht3x::DeviceStatus device_status;
+        sensor.read_device_status(device_status);
+    });
+}
+#endif
+
+
+void bench_single_shot() {
+    for (uint8_t mode = 1; mode <= 6; mode++) {
+        uint32_t conversion_us = sht3x_measurement_duration_us(static_cast<Repeatability>((mode - 1) % 3));
+        bench_bus(F("perform_single_shot_measurement"), mode, 2, 6, conversion_us, [mode]() {
+            return sht3x.perform_single_shot_measurement(mode);
+        });
+    }
+
+    for (uint8_t mode = 1; mode <= 3; mode++) {
+        bench_bus(F("start_single_shot"), mode, 2, 0, 0, [mode]() {
+            return sht3x.start_single_shot(mode);
+        });
+        delayMicroseconds(sht3x_measurement_duration_us(static_cast<Repeatability>(mode - 1)));
+        bench_bus(F("poll_collect"), mode, 0, 6, 0, []() {
+            sht3x.poll();
+            return sht3x.collect();
+        });
+    }
+}
+
+
+void bench_periodic() {
+    for (uint8_t mode = 1; mode <= 15; mode++) {
+        Repeatability repeatability = static_cast<Repeatability>((mode - 1) % 3);
+        bench_bus(F("set_periodic_data_acquisition"), mode, 2, 0, 0, [mode]() {
+            return sht3x.set_periodic_data_acquisition(mode);
+        });
+        /*the first result is ready after one period*/
+        delay(sht3x_period_ms(static_cast<Mps>((mode - 1) / 3)));
+        delayMicroseconds(sht3x_measurement_duration_us(repeatability) + 1000);
+        bench_bus(F("fetch_data"), mode, 2, 6, 0, []() {
+            return sht3x.fetch_data();
+        });
+        bench_bus(F("send_break_command"), mode, 2, 0, 0, []() {
+            return sht3x.send_break_command();
+        });
+        delay(1);
+    }
+
+    bench_bus(F("art_4_hz_measurements"), 0, 2, 0, 0, []() {
+        return sht3x.art_4_hz_measurements();
+    });
+    delay(BENCHMARK_ART_PERIOD_MS + 10);
+    bench_bus(F("fetch_data"), 16, 2, 6, 0, []() {
+        return sht3x.fetch_data();
+    });
+    sht3x.send_break_command();
+    delay(1);
+}
+
+
+void bench_status() {
+    bench_bus(F("read_device_status"), 0, 2, 3, 0, []() {
+        Sht3x::DeviceStatus device_status;
+        return sht3x.read_device_status(device_status);
+    });
+    bench_bus(F("clear_status_register"), 0, 2, 0, 0, []() {
+        return sht3x.clear_status_register();
+    });
+    bench_bus(F("enable_heater"), 0, 2, 0, 0, []() {
+        return sht3x.enable_heater();
+    });
+    bench_bus(F("disable_heater"), 0, 2, 0, 0, []() {
+        return sht3x.disable_heater();
+    });
+    bench_bus(F("write_alert_limit"), 0, 5, 0, 0, []() {
+        return sht3x.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 6000, 8000);
+    });
+    bench_bus(F("read_alert_limit"), 0, 2, 3, 0, []() {
+        int16_t temperature_centi;
+        uint16_t rh_centi;
+        return sht3x.read_alert_limit(Sht3x::AlertLimit::HIGH_SET, temperature_centi, rh_centi);
+    });
+    bench_bus(F("soft_reset"), 0, 2, 0, 0, []() {
+        return sht3x.soft_reset();
+    });
+    delay(2);
+}
+
+
+void loop() {
+    first_entry = true;
+    all_passed = true;
+
+    Serial.print("{\"benchmarks\":[");
+    bench_cpu();
+#if SHT3X_TRACE
+    bench_decode();
+#endif
+    bench_single_shot();
+    bench_periodic();
+    bench_status();
+    Serial.print("\n],\"sizeof_sht3x\":");
+    Serial.print((uint32_t)sizeof(Sht3x));
+    Serial.println(all_passed ? ",\"result\":\"pass\"}" : ",\"result\":\"fail\"}");
+    delay(10000);
+}
@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-recovery.h"
+
+// SDA and SCL pins of the bus for the bus clear step, these are the
+// Arduino Uno pins. Use -1 for both to skip the step.
+#define SDA_PIN 18
+#define SCL_PIN 19
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xRecovery recovery(sht3x, SDA_PIN, SCL_PIN);
+
+// Setup the serial communications and start the 1Hz acquisition
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+    sht3x.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::HIGH_REPEATABILITY);
+    // with other sensors on the bus, skip the general call reset that would reset them too
+    // recovery.set_shared_bus(true);
+}
+
+
+void loop() {
+    delay(1000);
+    Sht3x::I2C_STATUS status = sht3x.fetch_data();
+
+    // a sample that is not ready yet is not a fault
+    if (status != Sht3x::I2C_STATUS::SUCCESS
+        && status != Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) {
+        Serial.println("Fetch failed, recovering");
+        if (recovery.recover() != Sht3x::I2C_STATUS::SUCCESS) {
+            // retried after a holdoff, the rest of the bus keeps working
+            Serial.println("Sensor not responding");
+            return;
+        }
+        Serial.print("Recovered at level ");
+        Serial.println((uint8_t)recovery.get_last_level());
+        return;
+    }
+
+    Serial.print("Temperature: ");
+    Serial.print(sht3x.get_temperature());
+    Serial.print("C rh: ");
+    Serial.print(sht3x.get_rh());
+    Serial.println("%");
+}
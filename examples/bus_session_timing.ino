@@ -0,0 +1,123 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+/*
+ * Compares the cost of fetch_data() and perform_single_shot_measurement()
+ * with the persistent bus session against the previous behaviour, where
+ * the bus was started and stopped around every single transaction.
+ * The previous behaviour is emulated by restarting the bus before each call.
+ */
+
+#define TIMING_ITERATIONS 20
+
+unsigned long time_single_shot(Sht3x &sht3x, bool restart_bus);
+unsigned long time_fetch(Sht3x &sht3x, bool restart_bus);
+void print_result(const char *name, unsigned long before, unsigned long after);
+
+// Setup the serial communications
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+}
+
+
+void loop() {
+    // create an instance of the sht3x sensor with the address B
+    // ADDR pin connted to VDD
+    Sht3x sht3x(DEVICE_ADDRESS_B);
+    sht3x.begin();
+
+    while(true) {
+        // single shot mode 1 stretches the clock so both figures
+        // include the conversion time of the sensor
+        unsigned long before = time_single_shot(sht3x, true);
+        unsigned long after = time_single_shot(sht3x, false);
+        print_result("perform_single_shot_measurement(1)", before, after);
+
+        // 10 mps high repeatability so a new sample is ready on every fetch
+        sht3x.set_periodic_data_acquisition(13);
+        before = time_fetch(sht3x, true);
+        after = time_fetch(sht3x, false);
+        print_result("fetch_data()", before, after);
+        sht3x.send_break_command();
+
+        delay(5000);
+    }
+}
+
+
+/**
+ * @brief Average duration of a single shot measurement in us.
+ *        Includes the conversion time of the sensor.
+ */
+unsigned long time_single_shot(Sht3x &sht3x, bool restart_bus) {
+    unsigned long total = 0;
+    for (size_t i = 0; i < TIMING_ITERATIONS; i++) {
+        unsigned long start = micros();
+        if (restart_bus) {
+            Wire.end();
+            Wire.begin();
+        }
+        sht3x.perform_single_shot_measurement(1);
+        total += micros() - start;
+        delay(20);
+    }
+    return total / TIMING_ITERATIONS;
+}
+
+
+/**
+ * @brief Average duration of a fetch in us.
+ */
+unsigned long time_fetch(Sht3x &sht3x, bool restart_bus) {
+    unsigned long total = 0;
+    for (size_t i = 0; i < TIMING_ITERATIONS; i++) {
+        delay(100);
+        unsigned long start = micros();
+        if (restart_bus) {
+            Wire.end();
+            Wire.begin();
+        }
+        sht3x.fetch_data();
+        total += micros() - start;
+    }
+    return total / TIMING_ITERATIONS;
+}
+
+
+void print_result(const char *name, unsigned long before, unsigned long after) {
+    Serial.println("===================================================");
+    Serial.println(name);
+    Serial.print("bus restarted per call: ");
+    Serial.print(before);
+    Serial.println("us");
+    Serial.print("persistent bus session: ");
+    Serial.print(after);
+    Serial.println("us");
+    Serial.println("===================================================");
+}
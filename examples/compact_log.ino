@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-encoder.h"
+
+#define LOG_SIZE 512 /*Bytes of RAM used for the log*/
+
+// Print that stores the stream in RAM, a File on an SD card works the same way
+class MemoryLog : public Print {
+    public:
+        uint8_t data[LOG_SIZE];
+        size_t size = 0;
+
+        size_t write(uint8_t c) override {
+            if (size >= LOG_SIZE) {
+                return 0;
+            }
+            data[size++] = c;
+            return 1;
+        }
+};
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+MemoryLog memory_log;
+Sht3xLogEncoder encoder(memory_log);
+Sht3xSampleRing<16> samples;
+
+// Setup the serial communications and start the 10Hz acquisition
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+    sht3x.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+    encoder.start(sht3x);
+}
+
+
+void loop() {
+    delay(100);
+    samples.fetch(sht3x);
+
+    Sht3xSample sample;
+    while (samples.pop(&sample, 1) == 1) {
+        encoder.write(sample);
+    }
+
+    if (memory_log.size + ENCODER_BLOCK_HEADER_SIZE < LOG_SIZE) {
+        return;
+    }
+
+    // the log is full, report the compression and decode it again
+    Serial.print("Samples: ");
+    Serial.print(encoder.get_samples_written());
+    Serial.print(" bytes: ");
+    Serial.println(encoder.get_bytes_written());
+
+    Sht3xLogDecoder decoder(memory_log.data, memory_log.size);
+    while (decoder.next(sample)) {
+        Serial.print(sample.timestamp_ms);
+        Serial.print("ms ");
+        Serial.print(sht3x_temperature_centi(sample.temperature_raw));
+        Serial.print(" ");
+        Serial.println(sht3x_rh_centi(sample.rh_raw));
+    }
+
+    memory_log.size = 0;
+    encoder.start(sht3x);
+}
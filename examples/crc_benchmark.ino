@@ -0,0 +1,80 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+/*
+ * Measures the cost of one CRC check of a sensor data word
+ * with the lookup table and with the bitwise implementation.
+ * The library uses the table unless SHT3X_CRC_BITWISE is defined.
+ */
+
+#define CRC_ITERATIONS 10000
+
+void print_result(const char *name, unsigned long duration);
+
+volatile uint8_t crc_sink; /*keeps the compiler from removing the checks*/
+
+// Setup the serial communications
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+}
+
+
+void loop() {
+    uint8_t word[2] = {0xBE, 0xEF};
+
+    unsigned long start = micros();
+    for (unsigned long i = 0; i < CRC_ITERATIONS; i++) {
+        word[1] = (uint8_t)i;
+        crc_sink = sht3x_crc8_table(word, 2);
+    }
+    print_result("table", micros() - start);
+
+    start = micros();
+    for (unsigned long i = 0; i < CRC_ITERATIONS; i++) {
+        word[1] = (uint8_t)i;
+        crc_sink = sht3x_crc8_bitwise(word, 2);
+    }
+    print_result("bitwise", micros() - start);
+
+    delay(5000);
+}
+
+
+void print_result(const char *name, unsigned long duration) {
+    Serial.println("===================================================");
+    Serial.print("CRC-8 ");
+    Serial.println(name);
+    Serial.print("ns per check: ");
+    Serial.println(duration * 1000UL / CRC_ITERATIONS);
+#if defined(F_CPU)
+    Serial.print("cycles per check: ");
+    Serial.println((unsigned long)((F_CPU / 1000000UL) * duration / CRC_ITERATIONS));
+#endif
+    Serial.println("===================================================");
+}
@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-scheduler.h"
+
+// This example runs on ESP32, where RTC memory survives deep sleep
+#if !defined(ESP32)
+#error "This example needs an ESP32"
+#endif
+#include <esp_sleep.h>
+
+/*
+ * Wakes up every 5 seconds, reads one sample and goes back to
+ * deep sleep. The sensor keeps measuring at 1Hz in between.
+ * Only the first boot configures it and clears its reset flag,
+ * later wakes resume it with a single status read and fetch
+ * the sample that is waiting.
+ */
+
+#define SLEEP_MS 5000
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xFetchScheduler scheduler(sht3x);
+
+// kept in RTC memory, zero after a cold boot
+RTC_DATA_ATTR Sht3x::State state;
+
+// Resume or configure the sensor, read one sample and sleep
+void setup() {
+    unsigned long start = micros();
+    Serial.begin(SERIAL_BAUD_RATE);
+    sht3x.begin();
+
+    Sht3x::I2C_STATUS status = sht3x.resume(state, SLEEP_MS);
+    if (status == Sht3x::I2C_STATUS::INVALID_ARGUMENT) {
+        Serial.println("Cold boot, configuring the sensor");
+        // clear the reset flag of the power-up, later wakes rely on it
+        status = sht3x.clear_status_register();
+        if (status == Sht3x::I2C_STATUS::SUCCESS) {
+            status = sht3x.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::HIGH_REPEATABILITY);
+        }
+    }
+
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        scheduler.start();
+        Sht3x::MeasurementState measurement = scheduler.fetch_if_ready();
+        while (measurement == Sht3x::MeasurementState::NOT_READY) {
+            delay(1);
+            measurement = scheduler.fetch_if_ready();
+        }
+
+        if (measurement == Sht3x::MeasurementState::READY) {
+            Serial.print("Temperature: ");
+            Serial.print(sht3x.get_temperature());
+            Serial.print("C rh:");
+            Serial.print(sht3x.get_rh());
+            Serial.print("% ");
+            Serial.print(micros() - start);
+            Serial.println("us after wake up");
+        }
+        sht3x.save_state(state);
+    } else {
+        Serial.println("Sensor not responding");
+    }
+
+    Serial.flush();
+    esp_sleep_enable_timer_wakeup(SLEEP_MS * 1000ULL);
+    esp_deep_sleep_start();
+}
+
+
+void loop() {
+}
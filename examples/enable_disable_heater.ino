@@ -25,6 +25,8 @@ SOFTWARE.
 
 #include "sht3x-dis-arduino-lib.h"
 
+void print_status(Sht3x &sht3x); /*Helper function to print the status register*/
+
 void print_data(float temperature, float rh); /*Helper function to print the readings*/
 
 
@@ -39,13 +41,14 @@ void loop() {
     // create an instance of the sht3x sensor with the address B
     // ADDR pin connted to VDD
     Sht3x sht3x(DEVICE_ADDRESS_B);
+    sht3x.begin();
 
     // Enable and disable the heater
     // Print the status register to see the heater status
     sht3x.enable_heater();
-    sht3x.read_device_status();
+    print_status(sht3x);
     sht3x.disable_heater();
-    sht3x.read_device_status();
+    print_status(sht3x);
 
     delay(5000);
 
@@ -62,3 +65,20 @@ void print_data(float temperature, float rh) {
     Serial.println("%");
     Serial.println("===================================================");
 }
+
+
+void print_status(Sht3x &sht3x) {
+    Sht3x::DeviceStatus status;
+    if (sht3x.read_device_status(status) != Sht3x::I2C_STATUS::SUCCESS) {
+        Serial.println("Error reading the device status");
+        return;
+    }
+    Serial.println(status.alert_pending ? "Pending alerts PRESENT" : "Pending alerts NONE");
+    Serial.println(status.heater_on ? "Heater ON" : "Heater OFF");
+    Serial.println(status.rh_alert ? "RH tracking alert" : "RH tracking alert NONE");
+    Serial.println(status.temperature_alert ? "Temperature tracking alert" : "Temperature tracking alert NONE");
+    Serial.println(status.system_reset ? "System reset detected" : "System reset NONE");
+    Serial.println(status.command_failed ? "Last command did not execute" : "Last command executed");
+    Serial.println(status.write_crc_failed ? "Checksum failed" : "Checksum passed");
+    Serial.println("=========================================================");
+}
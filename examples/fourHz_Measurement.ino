@@ -38,6 +38,7 @@ void loop() {
     // create an instance of the sht3x sensor with the address B
     // ADDR pin connted to VDD
     Sht3x sht3x(DEVICE_ADDRESS_B);
+    sht3x.begin();
 
     float temperature = 0.0;
     float rh = 0.0;
@@ -46,6 +47,7 @@ void loop() {
     while(true) {
         Serial.println("Device in 4Hz Data acquisition mode");
         sht3x.art_4_hz_measurements();
+        delay(20); // wait for the first measurement
         for (size_t i = 0; i < 5; i++) {
             sht3x.fetch_data();
             temperature = sht3x.get_temperature();
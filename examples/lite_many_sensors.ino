@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-lite.h"
+
+/*
+ * Measures 16 sensors behind a TCA9548A mux with the lean
+ * driver. Each sensor takes a few bytes of RAM and the readings
+ * go straight into an array, which fits a 2KB AVR.
+ */
+
+#define SENSOR_COUNT 16
+
+Sht3xMux mux(MUX_DEFAULT_ADDRESS);
+
+// listed channel by channel, both addresses on each channel
+Sht3xLite sensors[SENSOR_COUNT] = {
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 0), Sht3xLite(DEVICE_ADDRESS_B, mux, 0),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 1), Sht3xLite(DEVICE_ADDRESS_B, mux, 1),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 2), Sht3xLite(DEVICE_ADDRESS_B, mux, 2),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 3), Sht3xLite(DEVICE_ADDRESS_B, mux, 3),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 4), Sht3xLite(DEVICE_ADDRESS_B, mux, 4),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 5), Sht3xLite(DEVICE_ADDRESS_B, mux, 5),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 6), Sht3xLite(DEVICE_ADDRESS_B, mux, 6),
+    Sht3xLite(DEVICE_ADDRESS_A, mux, 7), Sht3xLite(DEVICE_ADDRESS_B, mux, 7)
+};
+Sht3xReading readings[SENSOR_COUNT];
+
+// Setup the serial communications and the bus
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    Wire.begin();
+}
+
+
+void loop() {
+    uint8_t measured = sht3x_lite_sweep(sensors, readings, SENSOR_COUNT,
+        Repeatability::MEDIUM_REPEATABILITY);
+
+    Serial.println("===================================================");
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        Serial.print("Sensor ");
+        Serial.print(i);
+        if (readings[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+            Serial.print(" Temperature: ");
+            Serial.print(sht3x_temperature_centi(readings[i].temperature_raw) / 100.0f);
+            Serial.print("C rh:");
+            Serial.print(sht3x_rh_centi(readings[i].rh_raw) / 100.0f);
+            Serial.println("%");
+        } else {
+            Serial.println(" failed");
+        }
+    }
+    Serial.print(measured);
+    Serial.print(" sensors measured, ");
+    Serial.print((uint16_t)sizeof(sensors));
+    Serial.println(" bytes of RAM for the drivers");
+    Serial.println("===================================================");
+
+    // one sensor read with a single call
+    Sht3xReading reading = sensors[0].measure();
+    if (reading.status == Sht3x::I2C_STATUS::SUCCESS) {
+        Serial.print("Sensor 0 again: ");
+        Serial.print(sht3x_temperature_centi(reading.temperature_raw) / 100.0f);
+        Serial.println("C");
+    }
+    delay(5000);
+}
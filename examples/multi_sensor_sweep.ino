@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+#include "sht3x-dis-manager.h"
+
+/*
+ * Measures several sensors with a single sweep.
+ * Both addresses are used on the default bus. On an ESP32
+ * two more sensors are read from the second bus Wire1.
+ */
+
+Sht3x sht3x_a(DEVICE_ADDRESS_A);
+Sht3x sht3x_b(DEVICE_ADDRESS_B);
+#if defined(ESP32)
+Sht3x sht3x_c(DEVICE_ADDRESS_A, Wire1);
+Sht3x sht3x_d(DEVICE_ADDRESS_B, Wire1);
+Sht3x *sensors[] = {&sht3x_a, &sht3x_b, &sht3x_c, &sht3x_d};
+#else
+Sht3x *sensors[] = {&sht3x_a, &sht3x_b};
+#endif
+
+#define SENSOR_COUNT (sizeof(sensors) / sizeof(sensors[0]))
+
+Sht3xManager manager(sensors, SENSOR_COUNT);
+Sht3xResult results[SENSOR_COUNT];
+
+// Setup the serial communications and the buses
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        sensors[i]->begin();
+    }
+}
+
+
+void loop() {
+    unsigned long start = micros();
+    uint8_t measured = manager.sweep(results);
+    unsigned long duration = micros() - start;
+
+    Serial.println("===================================================");
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        Serial.print("Sensor ");
+        Serial.print(i);
+        if (results[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+            Serial.print(" Temperature: ");
+            Serial.print(results[i].temperature);
+            Serial.print("C rh:");
+            Serial.print(results[i].rh);
+            Serial.println("%");
+        } else {
+            Serial.println(" failed");
+        }
+    }
+    Serial.print(measured);
+    Serial.print(" sensors measured in ");
+    Serial.print(duration);
+    Serial.println("us");
+    Serial.println("===================================================");
+    delay(5000);
+}
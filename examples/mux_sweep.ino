@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+#include "sht3x-dis-manager.h"
+
+/*
+ * Measures 32 sensors behind two TCA9548A muxes, one sensor
+ * of each address on every channel. The sensors are listed
+ * by address on purpose, the manager still switches every
+ * channel only once per pass.
+ */
+
+#define MUX_CHANNELS_USED 8
+
+Sht3xMux mux_a(0x70);
+Sht3xMux mux_b(0x71);
+
+Sht3x sensors_a[] = {
+    Sht3x(DEVICE_ADDRESS_A, mux_a, 0), Sht3x(DEVICE_ADDRESS_A, mux_a, 1),
+    Sht3x(DEVICE_ADDRESS_A, mux_a, 2), Sht3x(DEVICE_ADDRESS_A, mux_a, 3),
+    Sht3x(DEVICE_ADDRESS_A, mux_a, 4), Sht3x(DEVICE_ADDRESS_A, mux_a, 5),
+    Sht3x(DEVICE_ADDRESS_A, mux_a, 6), Sht3x(DEVICE_ADDRESS_A, mux_a, 7),
+    Sht3x(DEVICE_ADDRESS_A, mux_b, 0), Sht3x(DEVICE_ADDRESS_A, mux_b, 1),
+    Sht3x(DEVICE_ADDRESS_A, mux_b, 2), Sht3x(DEVICE_ADDRESS_A, mux_b, 3),
+    Sht3x(DEVICE_ADDRESS_A, mux_b, 4), Sht3x(DEVICE_ADDRESS_A, mux_b, 5),
+    Sht3x(DEVICE_ADDRESS_A, mux_b, 6), Sht3x(DEVICE_ADDRESS_A, mux_b, 7)
+};
+Sht3x sensors_b[] = {
+    Sht3x(DEVICE_ADDRESS_B, mux_a, 0), Sht3x(DEVICE_ADDRESS_B, mux_a, 1),
+    Sht3x(DEVICE_ADDRESS_B, mux_a, 2), Sht3x(DEVICE_ADDRESS_B, mux_a, 3),
+    Sht3x(DEVICE_ADDRESS_B, mux_a, 4), Sht3x(DEVICE_ADDRESS_B, mux_a, 5),
+    Sht3x(DEVICE_ADDRESS_B, mux_a, 6), Sht3x(DEVICE_ADDRESS_B, mux_a, 7),
+    Sht3x(DEVICE_ADDRESS_B, mux_b, 0), Sht3x(DEVICE_ADDRESS_B, mux_b, 1),
+    Sht3x(DEVICE_ADDRESS_B, mux_b, 2), Sht3x(DEVICE_ADDRESS_B, mux_b, 3),
+    Sht3x(DEVICE_ADDRESS_B, mux_b, 4), Sht3x(DEVICE_ADDRESS_B, mux_b, 5),
+    Sht3x(DEVICE_ADDRESS_B, mux_b, 6), Sht3x(DEVICE_ADDRESS_B, mux_b, 7)
+};
+
+#define SENSOR_COUNT (2 * 2 * MUX_CHANNELS_USED)
+
+Sht3x *sensors[SENSOR_COUNT];
+Sht3xManager manager(sensors, SENSOR_COUNT);
+Sht3xResult results[SENSOR_COUNT];
+
+// Setup the serial communications, the bus and the sensor list
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    mux_a.link(mux_b);
+    for (size_t i = 0; i < SENSOR_COUNT / 2; i++) {
+        sensors[i] = &sensors_a[i];
+        sensors[SENSOR_COUNT / 2 + i] = &sensors_b[i];
+    }
+    sensors[0]->begin();
+}
+
+
+void loop() {
+    uint32_t switches = mux_a.get_switch_count() + mux_b.get_switch_count();
+    unsigned long start = micros();
+    uint8_t measured = manager.sweep(results);
+    unsigned long duration = micros() - start;
+    switches = mux_a.get_switch_count() + mux_b.get_switch_count() - switches;
+
+    Serial.println("===================================================");
+    for (size_t i = 0; i < SENSOR_COUNT; i++) {
+        Serial.print(sensors[i]->get_mux() == &mux_a ? "Mux A" : "Mux B");
+        Serial.print(" channel ");
+        Serial.print(sensors[i]->get_mux_channel());
+        Serial.print(i < SENSOR_COUNT / 2 ? " sensor A" : " sensor B");
+        if (results[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+            Serial.print(" Temperature: ");
+            Serial.print(results[i].temperature);
+            Serial.print("C rh:");
+            Serial.print(results[i].rh);
+            Serial.println("%");
+        } else {
+            Serial.println(" failed");
+        }
+    }
+    Serial.print(measured);
+    Serial.print(" sensors measured in ");
+    Serial.print(duration);
+    Serial.print("us with ");
+    Serial.print(switches);
+    Serial.println(" mux writes");
+    Serial.println("===================================================");
+    delay(5000);
+}
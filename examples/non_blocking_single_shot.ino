@@ -0,0 +1,79 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+void print_data(float temperature, float rh); /*Helper function to print the readings*/
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+unsigned long loop_count = 0;
+
+// Setup the serial communications and the sensor
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    // single shot measurement mode 4, high repeatability
+    sht3x.start_single_shot(4);
+}
+
+
+void loop() {
+    // the loop keeps running while the sensor converts
+    loop_count++;
+
+    Sht3x::MeasurementState state = sht3x.poll();
+    if (state == Sht3x::MeasurementState::READY) {
+        sht3x.collect();
+        print_data(sht3x.get_temperature(), sht3x.get_rh());
+        Serial.print("Latency: ");
+        Serial.print(sht3x.get_single_shot_latency_us(4));
+        Serial.println("us");
+        Serial.print("Loop iterations during conversion: ");
+        Serial.println(loop_count);
+        loop_count = 0;
+        delay(5000);
+        sht3x.start_single_shot(4);
+    } else if (state == Sht3x::MeasurementState::FAILED) {
+        Serial.println("Measurement failed, restarting");
+        sht3x.start_single_shot(4);
+    }
+}
+
+
+void print_data(float temperature, float rh) {
+    Serial.println("===================================================");
+    Serial.print("Temperature: ");
+    Serial.print(temperature);
+    Serial.println("C");
+    Serial.print("rh:");
+    Serial.print(rh);
+    Serial.println("%");
+    Serial.println("===================================================");
+}
@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+// The counters are only compiled in with -DSHT3X_PERF_COUNTERS=1 in the
+// build flags of the whole project, for example build_flags in
+// platformio.ini. A #define in the sketch does not reach the library.
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+
+// Setup the serial communications and start the 10Hz acquisition
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+    sht3x.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+}
+
+
+void loop() {
+    // fetch for 10 seconds, some fetches arrive before a new sample
+    for (uint8_t i = 0; i < 150; i++) {
+        delay(66);
+        sht3x.fetch_data();
+    }
+
+#if SHT3X_PERF_COUNTERS
+    const Sht3xPerfCounters &counters = sht3x.get_perf_counters();
+    Serial.println("===================================================");
+    Serial.print("Transactions: ");
+    Serial.print(counters.transactions);
+    Serial.print(" bytes written: ");
+    Serial.print(counters.bytes_written);
+    Serial.print(" read: ");
+    Serial.println(counters.bytes_read);
+    Serial.print("Not ready: ");
+    Serial.print(counters.status_count[(uint8_t)Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE]);
+    Serial.print(" CRC errors: ");
+    Serial.print(counters.status_count[(uint8_t)Sht3x::I2C_STATUS::CRC_ERROR]);
+    Serial.print(" address NACKs: ");
+    Serial.println(counters.status_count[(uint8_t)Sht3x::I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS]);
+    Serial.println("Latency histogram (us):");
+    for (uint8_t i = 0; i < SHT3X_PERF_HISTOGRAM_BUCKETS; i++) {
+        if (counters.latency_histogram[i] == 0) {
+            continue;
+        }
+        Serial.print(i == 0 ? 0UL : 1UL << (i - 1));
+        Serial.print("+: ");
+        Serial.println(counters.latency_histogram[i]);
+    }
+    sht3x.reset_perf_counters();
+#else
+    Serial.println("Build with -DSHT3X_PERF_COUNTERS=1 to enable the counters");
+#endif
+}
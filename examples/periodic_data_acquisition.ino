@@ -38,6 +38,7 @@ void loop() {
     // create an instance of the sht3x sensor with the address B
     // ADDR pin connted to VDD
     Sht3x sht3x(DEVICE_ADDRESS_B);
+    sht3x.begin();
 
     float temperature = 0.0;
     float rh = 0.0;
@@ -50,6 +51,7 @@ void loop() {
             Serial.print("Periodic Acquisition:");
             Serial.println(i);
             sht3x.set_periodic_data_acquisition(i);
+            delay(20); // wait for the first measurement
             sht3x.fetch_data();
             temperature = sht3x.get_temperature();
             rh = sht3x.get_rh();
@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+#include "sht3x-dis-ring-buffer.h"
+
+/*
+ * Periodic data acquisition into a ring buffer.
+ * On an ESP32 a FreeRTOS task fetches the samples, on other
+ * boards they are fetched from loop() between the drains.
+ * loop() drains the buffer in batches at its own pace, so a
+ * slow iteration does not lose samples.
+ */
+
+#define FETCH_PERIOD_MS 100 /*10 mps*/
+#define DRAIN_PERIOD_MS 1000
+#define BATCH_SIZE 16
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xSampleRing<64> samples;
+
+#if defined(ESP32)
+void fetch_task(void *parameter) {
+    while(true) {
+        samples.fetch(sht3x);
+        vTaskDelay(pdMS_TO_TICKS(FETCH_PERIOD_MS));
+    }
+}
+#endif
+
+
+// Setup the serial communications and the sensor
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    // 10 mps high repeatability
+    sht3x.set_periodic_data_acquisition(13);
+
+#if defined(ESP32)
+    xTaskCreate(fetch_task, "sht3x", 2048, NULL, 2, NULL);
+#endif
+}
+
+
+void loop() {
+#if !defined(ESP32)
+    static unsigned long last_fetch = 0;
+    if (millis() - last_fetch >= FETCH_PERIOD_MS) {
+        last_fetch = millis();
+        samples.fetch(sht3x);
+    }
+#endif
+
+    static unsigned long last_drain = 0;
+    if (millis() - last_drain < DRAIN_PERIOD_MS) {
+        return;
+    }
+    last_drain = millis();
+
+    Sht3xSample batch[BATCH_SIZE];
+    uint8_t count = samples.pop(batch, BATCH_SIZE);
+    for (uint8_t i = 0; i < count; i++) {
+        Serial.print(batch[i].timestamp_ms);
+        Serial.print("ms Temperature: ");
+        Serial.print(sht3x_temperature_centi(batch[i].temperature_raw) / 100.0f);
+        Serial.print("C rh:");
+        Serial.print(sht3x_rh_centi(batch[i].rh_raw) / 100.0f);
+        Serial.println("%");
+    }
+
+    if (samples.get_overruns() > 0) {
+        Serial.print("Samples lost: ");
+        Serial.println(samples.get_overruns());
+    }
+}
@@ -0,0 +1,109 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+#define BENCHMARK_CALLS 1000
+#define SWEEP_STEP 1024 /*Raw word step of the accuracy sweep*/
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+volatile float sink; // keeps the benchmark from being optimised away
+
+// Time one implementation, result in us per call
+float benchmark(float (*function)(float, float)) {
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < BENCHMARK_CALLS; i++) {
+        sink = function(-40.0f + (i % 100), 5.0f + (i % 90));
+    }
+    return (float)(micros() - start) / BENCHMARK_CALLS;
+}
+
+
+// Largest difference of the fast and exact formulas over the raw range
+void accuracy_sweep() {
+    float dew_point_error = 0.0f;
+    float absolute_humidity_error = 0.0f;
+    for (uint32_t temperature_raw = 0; temperature_raw < TWO_TO_THE_POWER_16; temperature_raw += SWEEP_STEP) {
+        for (uint32_t rh_raw = SWEEP_STEP; rh_raw < TWO_TO_THE_POWER_16; rh_raw += SWEEP_STEP) {
+            float temperature = sht3x_temperature_centi(temperature_raw) / 100.0f;
+            float rh = sht3x_rh_centi(rh_raw) / 100.0f;
+            float error = fabs(sht3x_dew_point_fast(temperature, rh)
+                - sht3x_dew_point_exact(temperature, rh));
+            if (error > dew_point_error) {
+                dew_point_error = error;
+            }
+            float exact = sht3x_absolute_humidity_exact(temperature, rh);
+            error = fabs(sht3x_absolute_humidity_fast(temperature, rh) - exact) / exact;
+            if (error > absolute_humidity_error) {
+                absolute_humidity_error = error;
+            }
+        }
+    }
+    Serial.print("Max dew point error: ");
+    Serial.print(dew_point_error, 4);
+    Serial.println("C");
+    Serial.print("Max absolute humidity error: ");
+    Serial.print(absolute_humidity_error * 100.0f, 4);
+    Serial.println("%");
+}
+
+
+// Setup the serial communications and compare the implementations
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    Serial.print("Dew point exact: ");
+    Serial.print(benchmark(sht3x_dew_point_exact));
+    Serial.print("us fast: ");
+    Serial.print(benchmark(sht3x_dew_point_fast));
+    Serial.println("us");
+    Serial.print("Absolute humidity exact: ");
+    Serial.print(benchmark(sht3x_absolute_humidity_exact));
+    Serial.print("us fast: ");
+    Serial.print(benchmark(sht3x_absolute_humidity_fast));
+    Serial.println("us");
+    accuracy_sweep();
+}
+
+
+void loop() {
+    sht3x.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED);
+
+    // computed once after each measurement, later calls return the cached value
+    Serial.print("Dew point: ");
+    Serial.print(sht3x.get_dew_point());
+    Serial.print("C absolute humidity: ");
+    Serial.print(sht3x.get_absolute_humidity());
+    Serial.print("g/m^3 heat index: ");
+    Serial.print(sht3x.get_heat_index());
+    Serial.println("C");
+    delay(2000);
+}
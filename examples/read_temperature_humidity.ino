@@ -38,6 +38,7 @@ void loop() {
     // create an instance of the sht3x sensor with the address B
     // ADDR pin connted to VDD
     Sht3x sht3x(DEVICE_ADDRESS_B);
+    sht3x.begin();
 
     // set single shot measurement mode 1
     sht3x.perform_single_shot_measurement(1);
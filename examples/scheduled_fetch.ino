@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-scheduler.h"
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xFetchScheduler scheduler(sht3x);
+
+// Setup the serial communications and start the periodic acquisition
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+    sht3x.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+    scheduler.start();
+}
+
+
+void loop() {
+    // the bus is only used once a new sample is expected
+    Sht3x::MeasurementState state = scheduler.fetch_if_ready();
+    if (state == Sht3x::MeasurementState::READY) {
+        Serial.print("Temperature: ");
+        Serial.print(sht3x.get_temperature());
+        Serial.print("C rh: ");
+        Serial.print(sht3x.get_rh());
+        Serial.print("% period: ");
+        Serial.print(scheduler.get_period_us());
+        Serial.println("us");
+    } else if (state == Sht3x::MeasurementState::FAILED) {
+        Serial.println("Fetch failed");
+    }
+
+    // other work can be done until the next sample is due
+}
@@ -0,0 +1,70 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-compensation.h"
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xSelfHeatingCompensator compensator(sht3x);
+
+// Setup the serial communications, calibrate and start the 10Hz acquisition
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+
+    // takes 4 minutes, keep the sensor at a stable temperature meanwhile.
+    // The offsets and time constant can be stored and set with
+    // set_offset() and set_time_constant() on the next start instead.
+    Serial.println("Calibrating self heating");
+    compensator.calibrate();
+    Serial.print("Offset at 10mps: ");
+    Serial.print(compensator.get_offset(Mps::MPS_10));
+    Serial.print(" (0.01C) time constant: ");
+    Serial.print(compensator.get_time_constant());
+    Serial.println("ms");
+
+    sht3x.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+}
+
+
+void loop() {
+    delay(100);
+    if (compensator.fetch() != Sht3x::I2C_STATUS::SUCCESS) {
+        return;
+    }
+
+    Serial.print("Measured: ");
+    Serial.print(sht3x.get_temperature());
+    Serial.print("C ");
+    Serial.print(sht3x.get_rh());
+    Serial.print("% compensated: ");
+    Serial.print(compensator.get_temperature());
+    Serial.print("C ");
+    Serial.print(compensator.get_rh());
+    Serial.println("%");
+}
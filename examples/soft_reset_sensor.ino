@@ -25,6 +25,8 @@ SOFTWARE.
 
 #include "sht3x-dis-arduino-lib.h"
 
+void print_status(Sht3x &sht3x); /*Helper function to print the status register*/
+
 // Setup Serial communications
 void setup() {
     Serial.begin(SERIAL_BAUD_RATE);
@@ -35,16 +37,34 @@ void setup() {
 void loop() {
     // Create an instance of the sht3x sensor with Address B
     Sht3x sht3x(DEVICE_ADDRESS_B);
+    sht3x.begin();
 
     while(true) {
         /* read the status register of the device*/
-        sht3x.read_device_status();
+        print_status(sht3x);
 
         /*Perform a soft reset on the device*/
         sht3x.soft_reset();
 
         /*Read the device status again*/
-        sht3x.read_device_status();
+        print_status(sht3x);
         delay(5000);
     }
 }
+
+
+void print_status(Sht3x &sht3x) {
+    Sht3x::DeviceStatus status;
+    if (sht3x.read_device_status(status) != Sht3x::I2C_STATUS::SUCCESS) {
+        Serial.println("Error reading the device status");
+        return;
+    }
+    Serial.println(status.alert_pending ? "Pending alerts PRESENT" : "Pending alerts NONE");
+    Serial.println(status.heater_on ? "Heater ON" : "Heater OFF");
+    Serial.println(status.rh_alert ? "RH tracking alert" : "RH tracking alert NONE");
+    Serial.println(status.temperature_alert ? "Temperature tracking alert" : "Temperature tracking alert NONE");
+    Serial.println(status.system_reset ? "System reset detected" : "System reset NONE");
+    Serial.println(status.command_failed ? "Last command did not execute" : "Last command executed");
+    Serial.println(status.write_crc_failed ? "Checksum failed" : "Checksum passed");
+    Serial.println("=========================================================");
+}
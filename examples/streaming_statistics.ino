@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-stats.h"
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3xStats<5> stats; // median of 5 removes single sample spikes
+
+// Setup the serial communications and start the 10Hz acquisition
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+    sht3x.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+}
+
+
+void loop() {
+    // collect 100 samples, 10 seconds at 10Hz
+    for (uint8_t i = 0; i < 100; i++) {
+        delay(100);
+        stats.fetch(sht3x);
+    }
+
+    Sht3xRunningStats &temperature = stats.get_temperature_stats();
+    Serial.println("===================================================");
+    Serial.print("Samples: ");
+    Serial.println(temperature.get_count());
+    Serial.print("Temperature mean: ");
+    Serial.print(stats.get_mean_temperature());
+    Serial.print("C stddev: ");
+    Serial.print(stats.get_stddev_temperature());
+    Serial.print("C min: ");
+    Serial.print(sht3x_temperature_centi(temperature.get_min_raw()));
+    Serial.print(" max: ");
+    Serial.print(sht3x_temperature_centi(temperature.get_max_raw()));
+    Serial.println(" (0.01C)");
+    Serial.print("rh mean: ");
+    Serial.print(stats.get_mean_rh());
+    Serial.print("% stddev: ");
+    Serial.print(stats.get_stddev_rh());
+    Serial.print("% average: ");
+    Serial.print(sht3x_rh_centi(stats.get_rh_stats().get_ema_raw()));
+    Serial.println(" (0.01%)");
+    Serial.println("===================================================");
+
+    stats.reset();
+}
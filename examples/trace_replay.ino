@@ -0,0 +1,116 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-arduino-lib.h"
+
+// Recording is only compiled in with -DSHT3X_TRACE=1 in the
+// build flags, for example build_flags in platformio.ini
+
+/*
+ * Records 20 fetches of a sensor into RAM, then replays the
+ * trace into a second Sht3x object that is not connected to
+ * anything. Both print the same readings. The trace can as
+ * well be written to an SD card file and replayed on a PC.
+ */
+
+#define TRACE_BUFFER_SIZE 512
+
+/*Print that appends to a RAM buffer*/
+class TraceBuffer : public Print {
+    public:
+        uint8_t data[TRACE_BUFFER_SIZE];
+        size_t size = 0;
+
+        size_t write(uint8_t byte) override {
+            if (this->size >= TRACE_BUFFER_SIZE) {
+                return 0;
+            }
+            this->data[this->size++] = byte;
+            return 1;
+        }
+};
+
+// create an instance of the sht3x sensor with the address B
+// ADDR pin connted to VDD
+Sht3x sht3x(DEVICE_ADDRESS_B);
+Sht3x replayed(DEVICE_ADDRESS_B);
+TraceBuffer trace;
+
+// Setup the serial communications and the bus
+void setup() {
+    Serial.begin(SERIAL_BAUD_RATE);
+    while(!Serial){};
+    sht3x.begin();
+}
+
+
+void loop() {
+#if SHT3X_TRACE
+    Sht3xTraceRecorder recorder(trace);
+    trace.size = 0;
+    recorder.start();
+    sht3x.set_trace_recorder(&recorder);
+    sht3x.set_periodic_data_acquisition(Mps::MPS_2, Repeatability::HIGH_REPEATABILITY);
+    Serial.println("Recorded:");
+    for (uint8_t i = 0; i < 20; i++) {
+        delay(500);
+        if (sht3x.fetch_data() == Sht3x::I2C_STATUS::SUCCESS) {
+            Serial.print(sht3x.get_temperature());
+            Serial.print("C ");
+        } else {
+            Serial.print("failed ");
+        }
+    }
+    sht3x.send_break_command();
+    sht3x.set_trace_recorder(nullptr);
+    Serial.println();
+    Serial.print(recorder.get_records());
+    Serial.print(" transactions in ");
+    Serial.print(recorder.get_bytes_written());
+    Serial.println(" bytes");
+
+    Sht3xTraceReplay replay(trace.data, trace.size);
+    replayed.set_trace_replay(&replay);
+    replayed.set_periodic_data_acquisition(Mps::MPS_2, Repeatability::HIGH_REPEATABILITY);
+    Serial.println("Replayed:");
+    for (uint8_t i = 0; i < 20; i++) {
+        if (replayed.fetch_data() == Sht3x::I2C_STATUS::SUCCESS) {
+            Serial.print(replayed.get_temperature());
+            Serial.print("C ");
+        } else {
+            Serial.print("failed ");
+        }
+    }
+    replayed.send_break_command();
+    Serial.println();
+    Serial.print("Mismatches: ");
+    Serial.println(replay.get_mismatches());
+#else
+    Serial.println("Build with -DSHT3X_TRACE=1 to record traces");
+#endif
+    delay(10000);
+}
@@ -28,45 +28,29 @@ SOFTWARE.
 #include <Wire.h>
 #include <Arduino.h>
 #include "sht3x-dis-registers.h"
+#include "sht3x-dis-conversion.h"
+#include "sht3x-dis-crc.h"
+#include "sht3x-dis-log.h"
+#include "sht3x-dis-psychrometrics.h"
+#include "sht3x-dis-perf.h"
+#include "sht3x-dis-mux.h"
+#include "sht3x-dis-trace.h"
 
 #define SERIAL_BAUD_RATE 115200
 #define TWO_TO_THE_POWER_16 65536
 
+/*Bits of the derived values that are cached*/
+#define DERIVED_DEW_POINT               0x01
+#define DERIVED_ABSOLUTE_HUMIDITY       0x02
+#define DERIVED_HEAT_INDEX              0x04
 
+/*Marks a saved Sht3x::State, RTC memory is zero after a cold boot*/
+#define STATE_MAGIC                     0xA5
 
-class Sht3x {
-    public:
-        Sht3x(const uint8_t device_address);
-        ~Sht3x() = default;
-        void perform_single_shot_measurement(uint8_t mode);
-        void send_break_command();
-        float get_temperature();
-        float get_rh();
-        void soft_reset();
-        void fetch_data();
-        void set_periodic_data_acquisition(uint8_t mode);
-        void read_device_status();
-        void clear_status_register();
-        void enable_heater();
-        void disable_heater();
-        void art_4_hz_measurements();
-        MeasurementModesSingleShot single_shot_mode;
-        MeasurementsPerSecondModes mps_modes;
-
-    private:
-        const uint8_t device_address;
-        uint16_t device_status;
-        uint16_t temperature_raw;
-        uint16_t rh_raw;
-        float temperature;
-        float rh;
-        bool heater_on;
-        uint8_t i2c_data[6] = {0}; /*All the measurement results are 6 bytes*/
-        uint8_t i2c_data_device_status[3] = {0}; /*Device status result is 3 bytes*/
-        uint8_t cmd_size;
-        uint8_t data_size;
 
 
+class Sht3x {
+    public:
         enum class I2C_STATUS {
             SUCCESS,
             DATA_TOO_LONG_FOR_TX_BUFFER,
@@ -74,16 +58,215 @@ class Sht3x {
             RECEIVED_NACK_ON_TX_DATA,
             OTHER_ERROR,
             TIMEOUT,
-            WIRE_AVAILABLE_FALSE
+            WIRE_AVAILABLE_FALSE,
+            CRC_ERROR,
+            INVALID_ARGUMENT
+        };
+
+        /*State of a non-blocking single shot measurement*/
+        enum class MeasurementState {
+            IDLE,
+            NOT_READY,
+            READY,
+            FAILED
+        };
+
+        /*Measurement mode the sensor was last configured for*/
+        enum class AcquisitionMode {
+            SINGLE_SHOT,
+            PERIODIC,
+            ART
+        };
+
+        /*Alert limits, the alert is set above HIGH_SET or below
+          LOW_SET and cleared below HIGH_CLEAR or above LOW_CLEAR*/
+        enum class AlertLimit {
+            HIGH_SET,
+            HIGH_CLEAR,
+            LOW_CLEAR,
+            LOW_SET
+        };
+
+        /*Status register decoded, datasheet table 17 page 13*/
+        struct DeviceStatus {
+            bool alert_pending;
+            bool heater_on;
+            bool rh_alert;
+            bool temperature_alert;
+            bool system_reset;
+            bool command_failed;
+            bool write_crc_failed;
+        };
+
+        /*Acquisition state kept over a reboot or deep sleep of
+          the MCU, for example in RTC memory*/
+        struct State {
+            uint8_t magic;
+            uint8_t acquisition_mode;
+            uint8_t mps;
+            uint8_t repeatability;
+            uint8_t heater_on;
+            uint32_t fetch_age_ms;  /*time since the last fetch when saved*/
+            uint8_t crc;
+        };
+
+        /*Tracking alerts decoded from the status register*/
+        struct AlertStatus {
+            bool pending;
+            bool rh_alert;
+            bool temperature_alert;
         };
 
+        Sht3x(const uint8_t device_address, TwoWire &wire = Wire);
+        Sht3x(const uint8_t device_address, Sht3xMux &mux, uint8_t mux_channel);
+        ~Sht3x() = default;
+        void begin();
+        void restart_bus();
+        I2C_STATUS perform_single_shot_measurement(uint8_t mode);
+        I2C_STATUS perform_single_shot_measurement(Repeatability repeatability,
+            ClockStretching clock_stretching);
+        I2C_STATUS send_break_command();
+        float get_temperature();
+        float get_rh();
+        int16_t get_temperature_centi();
+        uint16_t get_rh_centi();
+        uint16_t get_temperature_raw();
+        uint16_t get_rh_raw();
+        float get_dew_point();
+        float get_absolute_humidity();
+        float get_heat_index();
+        I2C_STATUS soft_reset();
+        I2C_STATUS general_call_reset();
+        void mark_reset();
+        I2C_STATUS fetch_data();
+        I2C_STATUS set_periodic_data_acquisition(uint8_t mode);
+        I2C_STATUS set_periodic_data_acquisition(Mps mps, Repeatability repeatability);
+        I2C_STATUS read_device_status(DeviceStatus &device_status);
+        I2C_STATUS clear_status_register();
+        I2C_STATUS enable_heater();
+        I2C_STATUS disable_heater();
+        I2C_STATUS art_4_hz_measurements();
+        I2C_STATUS start_single_shot(uint8_t mode);
+        I2C_STATUS start_single_shot(Repeatability repeatability);
+        MeasurementState poll();
+        I2C_STATUS collect();
+        uint32_t get_single_shot_latency_us(uint8_t mode);
+        uint32_t get_single_shot_latency_us(Repeatability repeatability);
+        AcquisitionMode get_acquisition_mode();
+        Mps get_mps();
+        Repeatability get_repeatability();
+        uint32_t get_period_ms();
+        uint32_t get_acquisition_start_us();
+        bool is_heater_on();
+        void save_state(State &state);
+        I2C_STATUS resume(const State &state, uint32_t slept_ms = 0);
+        Sht3xMux *get_mux();
+        uint8_t get_mux_channel();
+
+        /**
+         * @brief Single shot measurement with the mode known at
+         *        compile time, the command is a literal
+         */
+        template <Repeatability REPEATABILITY, ClockStretching CLOCK_STRETCHING>
+        I2C_STATUS perform_single_shot_measurement() {
+            return measure_single_shot(sht3x_single_shot_command(REPEATABILITY, CLOCK_STRETCHING),
+                REPEATABILITY, CLOCK_STRETCHING);
+        }
+
+        /**
+         * @brief Non-blocking single shot measurement with the
+         *        repeatability known at compile time
+         */
+        template <Repeatability REPEATABILITY>
+        I2C_STATUS start_single_shot() {
+            return begin_single_shot(sht3x_single_shot_command(REPEATABILITY,
+                ClockStretching::STRETCHING_DISABLED), REPEATABILITY);
+        }
+
+        /**
+         * @brief Periodic data acquisition with the mode known at
+         *        compile time, the command is a literal
+         */
+        template <Mps MPS, Repeatability REPEATABILITY>
+        I2C_STATUS set_periodic_data_acquisition() {
+            return start_periodic(sht3x_periodic_command(MPS, REPEATABILITY), MPS, REPEATABILITY);
+        }
+
+        I2C_STATUS write_alert_limit(AlertLimit limit, int16_t temperature_centi, uint16_t rh_centi);
+        I2C_STATUS read_alert_limit(AlertLimit limit, int16_t &temperature_centi, uint16_t &rh_centi);
+        void notify_alert();
+        bool alert_pending();
+        I2C_STATUS service_alert(AlertStatus &alert);
+        static I2C_STATUS to_i2c_status(uint8_t status);
+        static I2C_STATUS select_mux_channel(Sht3xMux *mux, uint8_t mux_channel);
+        static I2C_STATUS transmit(TwoWire &wire, uint8_t device_address,
+            const uint8_t *tx_buffer, uint8_t tx_buffer_size);
+        static I2C_STATUS receive(TwoWire &wire, uint8_t device_address,
+            uint8_t *rx_buffer, uint8_t rx_buffer_size);
+        static I2C_STATUS check_crc(const uint8_t *data, uint8_t size);
+#if SHT3X_PERF_COUNTERS
+        const Sht3xPerfCounters &get_perf_counters();
+        void reset_perf_counters();
+#endif
+#if SHT3X_TRACE
+        void set_trace_recorder(Sht3xTraceRecorder *recorder);
+        void set_trace_replay(Sht3xTraceReplay *replay);
+#endif
+
+    private:
+        TwoWire &wire;
+        const uint8_t device_address;
+        Sht3xMux *const mux = nullptr;
+        const uint8_t mux_channel = 0;
+        uint16_t temperature_raw = 0;
+        uint16_t rh_raw = 0;
+        bool heater_on = false;
+        uint8_t i2c_data[6] = {0}; /*All the measurement results are 6 bytes*/
+        MeasurementState measurement_state = MeasurementState::IDLE;
+        Repeatability pending_repeatability = Repeatability::HIGH_REPEATABILITY;
+        uint32_t conversion_start_us = 0;
+        uint32_t single_shot_latency_us[3] = {0}; /*last latency per repeatability*/
+        volatile bool alert_flag = false; /*set from the ALERT pin interrupt*/
+        AcquisitionMode acquisition_mode = AcquisitionMode::SINGLE_SHOT;
+        Mps periodic_mps = Mps::MPS_1;
+        Repeatability periodic_repeatability = Repeatability::HIGH_REPEATABILITY;
+        uint32_t acquisition_start_us = 0;
+        uint32_t last_fetch_us = 0; /*last fetch, or start of the acquisition*/
+        float dew_point = 0.0f;
+        float absolute_humidity = 0.0f;
+        float heat_index = 0.0f;
+        uint8_t derived_valid = 0; /*DERIVED_* bits of the values computed since the last reading*/
+#if SHT3X_PERF_COUNTERS
+        Sht3xPerfCounters perf_counters = {};
+#endif
+#if SHT3X_TRACE
+        Sht3xTraceRecorder *trace_recorder = nullptr;
+        Sht3xTraceReplay *trace_replay = nullptr;
+#endif
 
 
+        I2C_STATUS select_channel();
         I2C_STATUS read_i2c_device(uint8_t *tx_buffer, uint8_t tx_buffer_size, uint8_t *rx_buffer, uint8_t rx_buffer_size);
         I2C_STATUS write_i2c_device(uint8_t *tx_buffer, uint8_t tx_buffer_size);
+        I2C_STATUS receive_i2c_device(uint8_t *rx_buffer, uint8_t rx_buffer_size);
+        I2C_STATUS send_command(uint16_t command);
+        I2C_STATUS measure_single_shot(uint16_t command, Repeatability repeatability,
+            ClockStretching clock_stretching);
+        I2C_STATUS begin_single_shot(uint16_t command, Repeatability repeatability);
+        I2C_STATUS start_periodic(uint16_t command, Mps mps, Repeatability repeatability);
+        I2C_STATUS read_status_word(uint16_t &status_word);
+        I2C_STATUS check_measurement_crc();
         void read_temperature();
         void read_relative_humidity();
+        static uint8_t state_crc(const State &state);
+#if SHT3X_TRACE
+        I2C_STATUS replay_transaction(uint8_t kind, uint8_t *buffer, uint8_t buffer_size);
+#endif
 
 };
 
+/*Sht3xPerfCounters::status_count is indexed by I2C_STATUS*/
+static_assert(SHT3X_PERF_STATUS_COUNT == static_cast<uint8_t>(Sht3x::I2C_STATUS::INVALID_ARGUMENT) + 1,
+    "SHT3X_PERF_STATUS_COUNT must match the number of I2C_STATUS values");
+
 #endif
@@ -0,0 +1,366 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-compensation.h"
+
+/**
+ * @brief Construct a new Sht3xSelfHeatingCompensator object
+ *
+ * @param sensor sensor to compensate
+ */
+Sht3xSelfHeatingCompensator::Sht3xSelfHeatingCompensator(Sht3x &sensor): sensor{sensor} {
+}
+
+
+/**
+ * @brief Measure the self heating by comparing 0.5 mps and
+ *        10 mps runs and derive the offsets and time constant.
+ *        Blocks for twice settle_s. The ambient temperature
+ *        must be stable and the heater off meanwhile.
+ *
+ *        The 0.5 mps run gives the baseline, its self heating
+ *        is taken as zero. The offset at 10 mps is the rise of
+ *        the average over the last quarter of the 10 mps run,
+ *        and the other rates scale with the number of
+ *        measurements per second. The time constant follows
+ *        from the area between the rise and its final value.
+ *        The previous mode is restored afterwards.
+ *
+ * @param settle_s length of each run, several time constants
+ * @return Sht3x::I2C_STATUS status of the last bus operation
+ */
+Sht3x::I2C_STATUS Sht3xSelfHeatingCompensator::calibrate(uint16_t settle_s) {
+    Sht3x::AcquisitionMode mode = this->sensor.get_acquisition_mode();
+    Mps mps = this->sensor.get_mps();
+    Repeatability repeatability = this->sensor.get_repeatability();
+    uint32_t settle_ms = settle_s * 1000UL;
+    int16_t baseline_centi;
+    int16_t heated_centi;
+    int32_t rise_integral = 0;
+
+    Sht3x::I2C_STATUS status = stop_acquisition();
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        status = this->sensor.set_periodic_data_acquisition(Mps::MPS_0_5,
+            Repeatability::HIGH_REPEATABILITY);
+    }
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        status = run_phase(settle_ms, sht3x_period_ms(Mps::MPS_0_5), 0, baseline_centi, nullptr);
+    }
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        status = stop_acquisition();
+    }
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        status = this->sensor.set_periodic_data_acquisition(Mps::MPS_10,
+            Repeatability::HIGH_REPEATABILITY);
+    }
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        status = run_phase(settle_ms, sht3x_period_ms(Mps::MPS_10), baseline_centi,
+            heated_centi, &rise_integral);
+    }
+    if (status != Sht3x::I2C_STATUS::SUCCESS) {
+        restore_mode(mode, mps, repeatability);
+        return status;
+    }
+
+    int16_t rise_centi = heated_centi - baseline_centi;
+    if (rise_centi < 0) {
+        rise_centi = 0;
+    }
+    /*Offset per rate, proportional to the measurements per second*/
+    const Mps rates[COMPENSATION_MPS_COUNT] = {Mps::MPS_0_5, Mps::MPS_1, Mps::MPS_2,
+        Mps::MPS_4, Mps::MPS_10};
+    for (uint8_t i = 0; i < COMPENSATION_MPS_COUNT; i++) {
+        set_offset(rates[i], (int16_t)((int32_t)rise_centi
+            * (int32_t)sht3x_period_ms(Mps::MPS_10) / (int32_t)sht3x_period_ms(rates[i])));
+    }
+
+    if (rise_centi > 0) {
+        /*For a first order step response the area above the
+          curve is the final rise times the time constant*/
+        int32_t tau_ms = (int32_t)settle_ms - rise_integral / rise_centi;
+        this->tau_ms = tau_ms < (int32_t)COMPENSATION_MIN_TAU_MS ? COMPENSATION_MIN_TAU_MS : tau_ms;
+    }
+    SHT3X_LOG_INFO("Self heating calibrated");
+
+    this->started = false;
+    return restore_mode(mode, mps, repeatability);
+}
+
+
+/**
+ * @brief Fetch the latest periodic measurement and update
+ *        the offset estimate
+ *
+ * @return Sht3x::I2C_STATUS status of the fetch
+ */
+Sht3x::I2C_STATUS Sht3xSelfHeatingCompensator::fetch() {
+    Sht3x::I2C_STATUS status = this->sensor.fetch_data();
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        update();
+    }
+    return status;
+}
+
+
+/**
+ * @brief Move the offset estimate towards the steady state of
+ *        the current mode. Call after every reading when the
+ *        sensor is not read through fetch().
+ */
+void Sht3xSelfHeatingCompensator::update() {
+    uint32_t now_ms = millis();
+    int16_t target_centi = steady_state_offset();
+    if (!this->started) {
+        /*Assume the sensor has settled in its current mode*/
+        this->estimate_centi = target_centi;
+        this->started = true;
+    } else {
+        float elapsed_ms = (float)(now_ms - this->last_update_ms);
+        this->estimate_centi += (target_centi - this->estimate_centi) * elapsed_ms
+            / (this->tau_ms + elapsed_ms);
+    }
+    this->last_update_ms = now_ms;
+}
+
+
+/**
+ * @brief Set the steady state offset of a rate at high repeatability
+ *
+ * @param mps measurements per second
+ * @param offset_centi offset in 0.01 C
+ */
+void Sht3xSelfHeatingCompensator::set_offset(Mps mps, int16_t offset_centi) {
+    this->offsets_centi[(uint8_t)mps] = offset_centi;
+}
+
+
+/**
+ * @brief Get the steady state offset of a rate at high repeatability
+ *
+ * @param mps measurements per second
+ * @return int16_t offset in 0.01 C
+ */
+int16_t Sht3xSelfHeatingCompensator::get_offset(Mps mps) {
+    return this->offsets_centi[(uint8_t)mps];
+}
+
+
+/**
+ * @brief Set the additional offset while the heater is on
+ *
+ * @param offset_centi offset in 0.01 C
+ */
+void Sht3xSelfHeatingCompensator::set_heater_offset(int16_t offset_centi) {
+    this->heater_offset_centi = offset_centi;
+}
+
+
+/**
+ * @brief Set the time constant of the self heating
+ *
+ * @param tau_ms time constant in ms
+ */
+void Sht3xSelfHeatingCompensator::set_time_constant(uint32_t tau_ms) {
+    this->tau_ms = tau_ms;
+}
+
+
+/**
+ * @brief Get the time constant of the self heating
+ *
+ * @return uint32_t time constant in ms
+ */
+uint32_t Sht3xSelfHeatingCompensator::get_time_constant() {
+    return this->tau_ms;
+}
+
+
+/**
+ * @brief Get the current estimate of the self heating
+ *
+ * @return int16_t offset in 0.01 C
+ */
+int16_t Sht3xSelfHeatingCompensator::get_offset_centi() {
+    return (int16_t)(this->estimate_centi + (this->estimate_centi < 0 ? -0.5f : 0.5f));
+}
+
+
+/**
+ * @brief Get the compensated temperature of the last reading
+ *
+ * @return int16_t temperature in 0.01 C
+ */
+int16_t Sht3xSelfHeatingCompensator::get_temperature_centi() {
+    return this->sensor.get_temperature_centi() - get_offset_centi();
+}
+
+
+/**
+ * @brief Get the compensated rh of the last reading. The
+ *        saturation vapour pressure at the heated sensor is
+ *        higher by the slope of the Magnus formula times the
+ *        offset, so the measured rh is too low by that ratio.
+ *
+ * @return uint16_t rh in 0.01 %
+ */
+uint16_t Sht3xSelfHeatingCompensator::get_rh_centi() {
+    float temperature = get_temperature_centi() / 100.0f;
+    float slope = MAGNUS_B * MAGNUS_C / ((MAGNUS_C + temperature) * (MAGNUS_C + temperature));
+    float rh_centi = this->sensor.get_rh_centi() * (1.0f + slope * this->estimate_centi / 100.0f);
+    return rh_centi > 10000.0f ? 10000 : (uint16_t)(rh_centi + 0.5f);
+}
+
+
+/**
+ * @brief Get the compensated temperature of the last reading
+ *
+ * @return float temperature in C
+ */
+float Sht3xSelfHeatingCompensator::get_temperature() {
+    return get_temperature_centi() / 100.0f;
+}
+
+
+/**
+ * @brief Get the compensated rh of the last reading
+ *
+ * @return float rh in %
+ */
+float Sht3xSelfHeatingCompensator::get_rh() {
+    return get_rh_centi() / 100.0f;
+}
+
+
+/**
+ * @brief Offset the sensor settles at in its current mode
+ *
+ * @return int16_t offset in 0.01 C
+ */
+int16_t Sht3xSelfHeatingCompensator::steady_state_offset() {
+    int32_t offset_centi = 0;
+    switch (this->sensor.get_acquisition_mode()) {
+        case Sht3x::AcquisitionMode::PERIODIC:
+            offset_centi = (int32_t)this->offsets_centi[(uint8_t)this->sensor.get_mps()]
+                * (int32_t)sht3x_measurement_duration_us(this->sensor.get_repeatability())
+                / (int32_t)HIGH_REPEAT_MEASUREMENT_DURATION_US;
+            break;
+        case Sht3x::AcquisitionMode::ART:
+            offset_centi = this->offsets_centi[(uint8_t)Mps::MPS_4];
+            break;
+        default:
+            break;
+    }
+    if (this->sensor.is_heater_on()) {
+        offset_centi += this->heater_offset_centi;
+    }
+    return (int16_t)offset_centi;
+}
+
+
+/**
+ * @brief End a periodic or ART acquisition and wait until the
+ *        sensor accepts the next mode command
+ *
+ * @return Sht3x::I2C_STATUS status of the break command, SUCCESS
+ *         when the sensor is in single shot mode already
+ */
+Sht3x::I2C_STATUS Sht3xSelfHeatingCompensator::stop_acquisition() {
+    Sht3x::AcquisitionMode mode = this->sensor.get_acquisition_mode();
+    if (mode != Sht3x::AcquisitionMode::PERIODIC && mode != Sht3x::AcquisitionMode::ART) {
+        return Sht3x::I2C_STATUS::SUCCESS;
+    }
+    Sht3x::I2C_STATUS status = this->sensor.send_break_command();
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        delay(BREAK_CMD_DELAY_MS);
+    }
+    return status;
+}
+
+
+/**
+ * @brief Fetch every sample of one calibration run
+ *
+ * @param duration_ms length of the run
+ * @param period_ms time between samples
+ * @param baseline_centi temperature the rise is measured from
+ * @param average_centi average temperature over the last quarter
+ * @param rise_integral area under the rise in 0.01 C * ms, not
+ *                      computed when nullptr
+ * @return Sht3x::I2C_STATUS SUCCESS or the first fetch error
+ */
+Sht3x::I2C_STATUS Sht3xSelfHeatingCompensator::run_phase(uint32_t duration_ms, uint32_t period_ms,
+    int16_t baseline_centi, int16_t &average_centi, int32_t *rise_integral) {
+    uint32_t start_ms = millis();
+    uint32_t last_ms = start_ms;
+    int32_t sum_centi = 0;
+    uint16_t count = 0;
+    while (millis() - start_ms < duration_ms) {
+        delay(period_ms);
+        Sht3x::I2C_STATUS status = this->sensor.fetch_data();
+        if (status == Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) {
+            continue;
+        }
+        if (status != Sht3x::I2C_STATUS::SUCCESS) {
+            return status;
+        }
+
+        uint32_t now_ms = millis();
+        int16_t temperature_centi = this->sensor.get_temperature_centi();
+        if (rise_integral != nullptr) {
+            *rise_integral += (int32_t)(temperature_centi - baseline_centi) * (int32_t)(now_ms - last_ms);
+        }
+        last_ms = now_ms;
+        if (now_ms - start_ms >= duration_ms / 4 * 3) {
+            sum_centi += temperature_centi;
+            count++;
+        }
+    }
+
+    average_centi = count == 0 ? baseline_centi : (int16_t)(sum_centi / count);
+    return Sht3x::I2C_STATUS::SUCCESS;
+}
+
+
+/**
+ * @brief Return the sensor to the mode it was in before calibrate()
+ *
+ * @return Sht3x::I2C_STATUS status of the mode change
+ */
+Sht3x::I2C_STATUS Sht3xSelfHeatingCompensator::restore_mode(Sht3x::AcquisitionMode mode, Mps mps,
+    Repeatability repeatability) {
+    Sht3x::I2C_STATUS status = stop_acquisition();
+    if (status != Sht3x::I2C_STATUS::SUCCESS) {
+        return status;
+    }
+    switch (mode) {
+        case Sht3x::AcquisitionMode::PERIODIC:
+            return this->sensor.set_periodic_data_acquisition(mps, repeatability);
+        case Sht3x::AcquisitionMode::ART:
+            return this->sensor.art_4_hz_measurements();
+        default:
+            return status;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_COMPENSATION_H
+#define SHT3X_DIS_COMPENSATION_H
+#include "sht3x-dis-arduino-lib.h"
+
+#define COMPENSATION_MPS_COUNT          5
+#define COMPENSATION_DEFAULT_TAU_MS     60000UL
+#define COMPENSATION_DEFAULT_SETTLE_S   120
+#define COMPENSATION_MIN_TAU_MS         1000UL
+
+
+/**
+ * @brief Estimates and removes the self heating of the sensor
+ *        in periodic and ART mode.
+ *
+ *        Every measurement heats the sensor slightly, so the
+ *        temperature offset grows with the measurement rate.
+ *        The model keeps a steady state offset per rate at high
+ *        repeatability, scaled by the measurement duration for
+ *        the lower repeatabilities, plus an offset while the
+ *        heater is on. After a change of mode the estimate
+ *        approaches the new steady state with a first order
+ *        time constant. The rh is corrected for the same offset,
+ *        as the sensor measures it at its own temperature.
+ *
+ *        The offsets are zero until calibrate() has run or they
+ *        are set from a previous calibration.
+ */
+class Sht3xSelfHeatingCompensator {
+    public:
+        Sht3xSelfHeatingCompensator(Sht3x &sensor);
+        ~Sht3xSelfHeatingCompensator() = default;
+        Sht3x::I2C_STATUS calibrate(uint16_t settle_s = COMPENSATION_DEFAULT_SETTLE_S);
+        Sht3x::I2C_STATUS fetch();
+        void update();
+        void set_offset(Mps mps, int16_t offset_centi);
+        int16_t get_offset(Mps mps);
+        void set_heater_offset(int16_t offset_centi);
+        void set_time_constant(uint32_t tau_ms);
+        uint32_t get_time_constant();
+        int16_t get_offset_centi();
+        int16_t get_temperature_centi();
+        uint16_t get_rh_centi();
+        float get_temperature();
+        float get_rh();
+
+    private:
+        Sht3x &sensor;
+        int16_t offsets_centi[COMPENSATION_MPS_COUNT] = {0}; /*steady state per Mps*/
+        int16_t heater_offset_centi = 0;
+        uint32_t tau_ms = COMPENSATION_DEFAULT_TAU_MS;
+        float estimate_centi = 0.0f;
+        uint32_t last_update_ms = 0;
+        bool started = false;
+
+        int16_t steady_state_offset();
+        Sht3x::I2C_STATUS stop_acquisition();
+        Sht3x::I2C_STATUS run_phase(uint32_t duration_ms, uint32_t period_ms, int16_t baseline_centi,
+            int16_t &average_centi, int32_t *rise_integral);
+        Sht3x::I2C_STATUS restore_mode(Sht3x::AcquisitionMode mode, Mps mps, Repeatability repeatability);
+};
+
+#endif
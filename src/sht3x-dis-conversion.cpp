@@ -0,0 +1,56 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-conversion.h"
+
+/**
+ * @brief Convert an array of raw temperature words.
+ *        The loop has no branches so the compiler can
+ *        vectorise it on the host.
+ *
+ * @param raw raw temperature words
+ * @param temperature output in centi degrees C
+ * @param count number of words to convert
+ */
+void sht3x_temperature_centi_batch(const uint16_t *raw, int16_t *temperature, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        temperature[i] = sht3x_temperature_centi(raw[i]);
+    }
+}
+
+
+/**
+ * @brief Convert an array of raw rh words.
+ *
+ * @param raw raw rh words
+ * @param rh output in centi percent
+ * @param count number of words to convert
+ */
+void sht3x_rh_centi_batch(const uint16_t *raw, uint16_t *rh, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        rh[i] = sht3x_rh_centi(raw[i]);
+    }
+}
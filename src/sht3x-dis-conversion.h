@@ -0,0 +1,133 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_CONVERSION_H
+#define SHT3X_DIS_CONVERSION_H
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Integer conversion of the raw sensor words.
+ * Refer to datasheet section 4.13 page 14
+ *
+ *   T  = -45 + 175 * raw / (2^16 - 1)
+ *   RH = 100 * raw / (2^16 - 1)
+ *
+ * The division by 2^16 - 1 is done as a multiplication by
+ * (1 + 2^-16) followed by a shift, which matches the exact
+ * result to within the rounding of the last digit.
+ * Temperature is returned in centi degrees C and rh in
+ * centi percent.
+ */
+
+/*Range of the raw words in centi degrees C and centi percent*/
+#define SHT3X_TEMPERATURE_CENTI_MIN     -4500
+#define SHT3X_TEMPERATURE_CENTI_MAX     13000
+#define SHT3X_RH_CENTI_MAX              10000
+
+
+/**
+ * @brief Convert a raw temperature word to centi degrees C
+ *
+ * @param raw raw temperature word from the sensor
+ * @return int16_t temperature in 0.01 C, -4500 to 13000
+ */
+static inline int16_t sht3x_temperature_centi(uint16_t raw) {
+    uint32_t scaled = 17500UL * raw;
+    scaled += scaled >> 16;
+    return (int16_t)((scaled + 0x8000UL) >> 16) - 4500;
+}
+
+
+/**
+ * @brief Convert a raw rh word to centi percent
+ *
+ * @param raw raw rh word from the sensor
+ * @return uint16_t rh in 0.01 %, 0 to 10000
+ */
+static inline uint16_t sht3x_rh_centi(uint16_t raw) {
+    uint32_t scaled = 10000UL * raw;
+    scaled += scaled >> 16;
+    return (uint16_t)((scaled + 0x8000UL) >> 16);
+}
+
+
+/**
+ * @brief Convert centi degrees C to a raw temperature word
+ *
+ * @param temperature temperature in 0.01 C, values outside
+ *        -4500 to 13000 are clamped to the range
+ * @return uint16_t raw temperature word
+ */
+static inline uint16_t sht3x_temperature_raw(int16_t temperature) {
+    if (temperature < SHT3X_TEMPERATURE_CENTI_MIN) temperature = SHT3X_TEMPERATURE_CENTI_MIN;
+    if (temperature > SHT3X_TEMPERATURE_CENTI_MAX) temperature = SHT3X_TEMPERATURE_CENTI_MAX;
+    return (uint16_t)(((int32_t)temperature + 4500) * 65535L / 17500);
+}
+
+
+/**
+ * @brief Convert centi percent to a raw rh word
+ *
+ * @param rh rh in 0.01 %, values above 10000 are clamped
+ * @return uint16_t raw rh word
+ */
+static inline uint16_t sht3x_rh_raw(uint16_t rh) {
+    if (rh > SHT3X_RH_CENTI_MAX) rh = SHT3X_RH_CENTI_MAX;
+    return (uint16_t)((uint32_t)rh * 65535UL / 10000);
+}
+
+
+/**
+ * @brief Pack raw temperature and rh words into an alert
+ *        limit word: the 7 MSBs of rh and the 9 MSBs of
+ *        temperature
+ */
+static inline uint16_t sht3x_alert_limit_pack(uint16_t temperature_raw, uint16_t rh_raw) {
+    return (rh_raw & 0xFE00) | (temperature_raw >> 7);
+}
+
+
+/**
+ * @brief Unpack the raw temperature word of an alert limit
+ */
+static inline uint16_t sht3x_alert_limit_temperature_raw(uint16_t limit) {
+    return (uint16_t)((limit & 0x01FF) << 7);
+}
+
+
+/**
+ * @brief Unpack the raw rh word of an alert limit
+ */
+static inline uint16_t sht3x_alert_limit_rh_raw(uint16_t limit) {
+    return limit & 0xFE00;
+}
+
+
+void sht3x_temperature_centi_batch(const uint16_t *raw, int16_t *temperature, size_t count);
+void sht3x_rh_centi_batch(const uint16_t *raw, uint16_t *rh, size_t count);
+
+#endif
@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-crc.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define SHT3X_CRC_TABLE_READ(index) pgm_read_byte(&SHT3X_CRC_TABLE[index])
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define SHT3X_CRC_TABLE_READ(index) SHT3X_CRC_TABLE[index]
+#endif
+
+/*Expand the 256 table entries, each computed at compile time*/
+#define SHT3X_CRC_ENTRY_1(i)   sht3x_crc8_shift((uint8_t)(i), 8)
+#define SHT3X_CRC_ENTRY_4(i)   SHT3X_CRC_ENTRY_1(i), SHT3X_CRC_ENTRY_1(i + 1), \
+                               SHT3X_CRC_ENTRY_1(i + 2), SHT3X_CRC_ENTRY_1(i + 3)
+#define SHT3X_CRC_ENTRY_16(i)  SHT3X_CRC_ENTRY_4(i), SHT3X_CRC_ENTRY_4(i + 4), \
+                               SHT3X_CRC_ENTRY_4(i + 8), SHT3X_CRC_ENTRY_4(i + 12)
+#define SHT3X_CRC_ENTRY_64(i)  SHT3X_CRC_ENTRY_16(i), SHT3X_CRC_ENTRY_16(i + 16), \
+                               SHT3X_CRC_ENTRY_16(i + 32), SHT3X_CRC_ENTRY_16(i + 48)
+
+static constexpr uint8_t SHT3X_CRC_TABLE[256] PROGMEM = {
+    SHT3X_CRC_ENTRY_64(0), SHT3X_CRC_ENTRY_64(64),
+    SHT3X_CRC_ENTRY_64(128), SHT3X_CRC_ENTRY_64(192)
+};
+
+static_assert(SHT3X_CRC_TABLE[0xFF ^ 0xBE] == sht3x_crc8_shift(0xFF ^ 0xBE, 8),
+    "CRC-8 table not generated at compile time");
+
+
+/**
+ * @brief CRC of a block of data using the lookup table.
+ *        One table read per byte.
+ *
+ * @param data data bytes
+ * @param size number of bytes
+ * @return uint8_t CRC of the data
+ */
+uint8_t sht3x_crc8_table(const uint8_t *data, uint8_t size) {
+    uint8_t crc = SHT3X_CRC_INIT;
+    for (uint8_t i = 0; i < size; i++) {
+        crc = SHT3X_CRC_TABLE_READ(crc ^ data[i]);
+    }
+    return crc;
+}
+
+
+/**
+ * @brief CRC of a block of data computed bit by bit.
+ *        Eight shifts per byte but no table in flash.
+ *
+ * @param data data bytes
+ * @param size number of bytes
+ * @return uint8_t CRC of the data
+ */
+uint8_t sht3x_crc8_bitwise(const uint8_t *data, uint8_t size) {
+    uint8_t crc = SHT3X_CRC_INIT;
+    for (uint8_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ SHT3X_CRC_POLYNOMIAL) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
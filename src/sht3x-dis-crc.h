@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_CRC_H
+#define SHT3X_DIS_CRC_H
+#include <stdint.h>
+
+/**
+ * CRC-8 of the sensor data words.
+ * Refer to datasheet table 19 page 14
+ * Polynomial 0x31 (x^8 + x^5 + x^4 + 1), initialisation 0xFF,
+ * no reflection and no final XOR. CRC(0xBEEF) = 0x92
+ *
+ * By default the CRC is computed with a 256 entry lookup
+ * table generated at compile time and placed in flash
+ * (PROGMEM on AVR). Define SHT3X_CRC_BITWISE to compute it
+ * bit by bit instead and save the 256 bytes of flash.
+ */
+
+#define SHT3X_CRC_POLYNOMIAL            0x31
+#define SHT3X_CRC_INIT                  0xFF
+
+
+/**
+ * @brief Shift a CRC register through a number of bits
+ *
+ * @param crc CRC register
+ * @param bits number of bits to shift
+ * @return constexpr uint8_t CRC register after the shift
+ */
+constexpr uint8_t sht3x_crc8_shift(uint8_t crc, uint8_t bits) {
+    return bits == 0 ? crc
+        : sht3x_crc8_shift((crc & 0x80) ? (uint8_t)((crc << 1) ^ SHT3X_CRC_POLYNOMIAL)
+                                        : (uint8_t)(crc << 1), bits - 1);
+}
+
+
+/**
+ * @brief CRC of a 16 bit data word, usable at compile time
+ *
+ * @param word data word, MSB first on the bus
+ * @return constexpr uint8_t CRC of the word
+ */
+constexpr uint8_t sht3x_crc8_word(uint16_t word) {
+    return sht3x_crc8_shift(
+        sht3x_crc8_shift(SHT3X_CRC_INIT ^ (uint8_t)(word >> 8), 8) ^ (uint8_t)word, 8);
+}
+
+static_assert(sht3x_crc8_word(0xBEEF) == 0x92, "CRC-8 does not match the datasheet example");
+
+
+uint8_t sht3x_crc8_table(const uint8_t *data, uint8_t size);
+uint8_t sht3x_crc8_bitwise(const uint8_t *data, uint8_t size);
+
+
+/**
+ * @brief CRC of a block of data using the implementation
+ *        selected at compile time
+ *
+ * @param data data bytes
+ * @param size number of bytes
+ * @return uint8_t CRC of the data
+ */
+static inline uint8_t sht3x_crc8(const uint8_t *data, uint8_t size) {
+#if defined(SHT3X_CRC_BITWISE)
+    return sht3x_crc8_bitwise(data, size);
+#else
+    return sht3x_crc8_table(data, size);
+#endif
+}
+
+#endif
@@ -0,0 +1,399 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-encoder.h"
+
+/**
+ * @brief Map a signed difference to an unsigned value
+ *        so that small differences of either sign stay small
+ *
+ * @param delta difference of two raw words, modulo 2^16
+ * @return uint16_t zig-zag coded difference
+ */
+static inline uint16_t zig_zag(uint16_t delta) {
+    return (uint16_t)((delta << 1) ^ (uint16_t)-(delta >> 15));
+}
+
+
+/**
+ * @brief Inverse of zig_zag()
+ *
+ * @param value zig-zag coded difference
+ * @return uint16_t difference, modulo 2^16
+ */
+static inline uint16_t un_zig_zag(uint16_t value) {
+    return (uint16_t)((value >> 1) ^ (uint16_t)-(value & 1));
+}
+
+
+/**
+ * @brief Move a running mean towards a sample
+ *
+ * @param mean mean << ENCODER_PREDICTOR_SHIFT
+ * @param value raw word of the sample
+ */
+static inline void update_mean(uint32_t &mean, uint16_t value) {
+    mean += value - (mean >> ENCODER_PREDICTOR_SHIFT);
+}
+
+
+uint8_t sht3x_encoder_mode(Sht3x &sensor) {
+    return (uint8_t)((uint8_t)sensor.get_acquisition_mode()
+        | ((uint8_t)sensor.get_mps() << 2)
+        | ((uint8_t)sensor.get_repeatability() << 5));
+}
+
+
+/**
+ * @brief Construct a new Sht3xLogEncoder object
+ *
+ * @param out destination of the encoded stream
+ * @param keyframe_interval maximum number of samples per block
+ */
+Sht3xLogEncoder::Sht3xLogEncoder(Print &out, uint16_t keyframe_interval):
+    out{out}, keyframe_interval{keyframe_interval} {
+}
+
+
+/**
+ * @brief Take the mode and period from the sensor and start
+ *        a new block with the next sample
+ *
+ * @param sensor sensor the samples are taken from
+ */
+void Sht3xLogEncoder::start(Sht3x &sensor) {
+    start(sht3x_encoder_mode(sensor), (uint16_t)sensor.get_period_ms());
+}
+
+
+/**
+ * @brief Start a new block with the next sample
+ *
+ * @param mode mode byte stored in the block headers
+ * @param period_ms expected time between samples. With 0 the samples
+ *                  of a block all carry the timestamp of the block
+ */
+void Sht3xLogEncoder::start(uint8_t mode, uint16_t period_ms) {
+    this->mode = mode;
+    this->period_ms = period_ms;
+    this->samples_in_block = 0;
+}
+
+
+/**
+ * @brief Append a sample to the stream
+ *
+ * @param sample raw sample, for example from Sht3xSampleRing::pop()
+ * @return size_t number of bytes written
+ */
+size_t Sht3xLogEncoder::write(const Sht3xSample &sample) {
+    size_t size;
+    /*Half a period of jitter is absorbed, a larger gap starts a new block*/
+    uint32_t lateness_ms = sample.timestamp_ms - this->next_timestamp_ms
+        + this->period_ms / 2;
+    if (this->samples_in_block == 0
+        || this->samples_in_block >= this->keyframe_interval
+        || (this->period_ms != 0 && lateness_ms > this->period_ms)) {
+        size = write_header(sample);
+        this->samples_in_block = 1;
+    } else {
+        size = write_delta(sample);
+        this->samples_in_block++;
+    }
+
+    this->next_timestamp_ms += this->period_ms;
+    this->bytes_written += size;
+    this->samples_written++;
+    return size;
+}
+
+
+/**
+ * @brief Get the size of the stream so far
+ *
+ * @return uint32_t number of bytes
+ */
+uint32_t Sht3xLogEncoder::get_bytes_written() {
+    return this->bytes_written;
+}
+
+
+/**
+ * @brief Get the number of samples encoded so far
+ *
+ * @return uint32_t number of samples
+ */
+uint32_t Sht3xLogEncoder::get_samples_written() {
+    return this->samples_written;
+}
+
+
+/**
+ * @brief Write a block header with the sample as keyframe
+ *
+ * @param sample first sample of the block
+ * @return size_t number of bytes written
+ */
+size_t Sht3xLogEncoder::write_header(const Sht3xSample &sample) {
+    uint8_t header[ENCODER_BLOCK_HEADER_SIZE];
+    header[0] = ENCODER_BLOCK_MAGIC_0;
+    header[1] = ENCODER_BLOCK_MAGIC_1;
+    header[2] = this->mode;
+    header[3] = (uint8_t)(sample.timestamp_ms >> 24);
+    header[4] = (uint8_t)(sample.timestamp_ms >> 16);
+    header[5] = (uint8_t)(sample.timestamp_ms >> 8);
+    header[6] = (uint8_t)sample.timestamp_ms;
+    header[7] = (uint8_t)(this->period_ms >> 8);
+    header[8] = (uint8_t)this->period_ms;
+    header[9] = (uint8_t)(sample.temperature_raw >> 8);
+    header[10] = (uint8_t)sample.temperature_raw;
+    header[11] = (uint8_t)(sample.rh_raw >> 8);
+    header[12] = (uint8_t)sample.rh_raw;
+    header[13] = sht3x_crc8(header, ENCODER_BLOCK_HEADER_SIZE - 1);
+
+    this->next_timestamp_ms = sample.timestamp_ms;
+    this->temperature_mean = (uint32_t)sample.temperature_raw << ENCODER_PREDICTOR_SHIFT;
+    this->rh_mean = (uint32_t)sample.rh_raw << ENCODER_PREDICTOR_SHIFT;
+    return this->out.write(header, ENCODER_BLOCK_HEADER_SIZE);
+}
+
+
+/**
+ * @brief Write the difference of the sample to the running mean
+ *        in the smallest form that holds it
+ *
+ * @param sample next sample of the block
+ * @return size_t number of bytes written
+ */
+size_t Sht3xLogEncoder::write_delta(const Sht3xSample &sample) {
+    uint8_t buffer[ENCODER_ABSOLUTE_SIZE];
+    uint8_t size;
+    uint16_t t = zig_zag(sample.temperature_raw
+        - (uint16_t)(this->temperature_mean >> ENCODER_PREDICTOR_SHIFT));
+    uint16_t rh = zig_zag(sample.rh_raw - (uint16_t)(this->rh_mean >> ENCODER_PREDICTOR_SHIFT));
+
+    if (t < 8 && rh < 16) {
+        buffer[0] = (uint8_t)((t << 4) | rh);
+        size = 1;
+    } else if (t < 64 && rh < 256) {
+        buffer[0] = (uint8_t)(0x80 | t);
+        buffer[1] = (uint8_t)rh;
+        size = 2;
+    } else if (t < 1024 && rh < 2048) {
+        uint32_t packed = 0xC00000UL | ((uint32_t)t << 11) | rh;
+        buffer[0] = (uint8_t)(packed >> 16);
+        buffer[1] = (uint8_t)(packed >> 8);
+        buffer[2] = (uint8_t)packed;
+        size = 3;
+    } else {
+        buffer[0] = ENCODER_TAG_ABSOLUTE;
+        buffer[1] = (uint8_t)(sample.temperature_raw >> 8);
+        buffer[2] = (uint8_t)sample.temperature_raw;
+        buffer[3] = (uint8_t)(sample.rh_raw >> 8);
+        buffer[4] = (uint8_t)sample.rh_raw;
+        size = ENCODER_ABSOLUTE_SIZE;
+        this->temperature_mean = (uint32_t)sample.temperature_raw << ENCODER_PREDICTOR_SHIFT;
+        this->rh_mean = (uint32_t)sample.rh_raw << ENCODER_PREDICTOR_SHIFT;
+        return this->out.write(buffer, size);
+    }
+    update_mean(this->temperature_mean, sample.temperature_raw);
+    update_mean(this->rh_mean, sample.rh_raw);
+    return this->out.write(buffer, size);
+}
+
+
+/**
+ * @brief Construct a new Sht3xLogDecoder object
+ *
+ * @param data encoded stream
+ * @param size size of the stream in bytes
+ */
+Sht3xLogDecoder::Sht3xLogDecoder(const uint8_t *data, size_t size): data{data}, size{size} {
+}
+
+
+/**
+ * @brief Decode the next sample
+ *
+ * @param sample decoded sample
+ * @return true a sample was decoded
+ * @return false end of the stream, or the data is corrupt
+ */
+bool Sht3xLogDecoder::next(Sht3xSample &sample) {
+    if (this->position >= this->size) {
+        return false;
+    }
+
+    const uint8_t *p = this->data + this->position;
+    size_t available = this->size - this->position;
+    uint8_t tag = p[0];
+    uint16_t t;
+    uint16_t rh;
+
+    if (tag < 0x80) {
+        if (!this->in_block) {
+            return false;
+        }
+        t = tag >> 4;
+        rh = tag & 0x0F;
+        this->position += 1;
+    } else if (tag < 0xC0) {
+        if (!this->in_block || available < 2) {
+            return false;
+        }
+        t = tag & 0x3F;
+        rh = p[1];
+        this->position += 2;
+    } else if (tag < ENCODER_TAG_ABSOLUTE) {
+        if (!this->in_block || available < 3) {
+            return false;
+        }
+        uint32_t packed = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+        t = (packed >> 11) & 0x3FF;
+        rh = packed & 0x7FF;
+        this->position += 3;
+    } else if (tag == ENCODER_TAG_ABSOLUTE) {
+        if (!this->in_block || available < ENCODER_ABSOLUTE_SIZE) {
+            return false;
+        }
+        this->temperature_raw = (uint16_t)((p[1] << 8) | p[2]);
+        this->rh_raw = (uint16_t)((p[3] << 8) | p[4]);
+        this->temperature_mean = (uint32_t)this->temperature_raw << ENCODER_PREDICTOR_SHIFT;
+        this->rh_mean = (uint32_t)this->rh_raw << ENCODER_PREDICTOR_SHIFT;
+        t = 0;
+        rh = 0;
+        this->position += ENCODER_ABSOLUTE_SIZE;
+    } else if (is_block_header(this->position)) {
+        read_header(sample);
+        return true;
+    } else {
+        return false;
+    }
+
+    if (tag != ENCODER_TAG_ABSOLUTE) {
+        uint16_t temperature_prediction = (uint16_t)(this->temperature_mean >> ENCODER_PREDICTOR_SHIFT);
+        uint16_t rh_prediction = (uint16_t)(this->rh_mean >> ENCODER_PREDICTOR_SHIFT);
+        this->temperature_raw = (uint16_t)(temperature_prediction + un_zig_zag(t));
+        this->rh_raw = (uint16_t)(rh_prediction + un_zig_zag(rh));
+        this->temperature_mean += this->temperature_raw - temperature_prediction;
+        this->rh_mean += this->rh_raw - rh_prediction;
+    }
+    this->sample_index++;
+    sample.timestamp_ms = this->block_timestamp_ms
+        + (uint32_t)this->sample_index * this->period_ms;
+    sample.temperature_raw = this->temperature_raw;
+    sample.rh_raw = this->rh_raw;
+    return true;
+}
+
+
+/**
+ * @brief Move to the first block starting at or after an offset,
+ *        for example to jump into the middle of a long log
+ *
+ * @param offset byte offset in the stream
+ * @return size_t offset of the block, the stream size if there is none
+ */
+size_t Sht3xLogDecoder::seek(size_t offset) {
+    this->in_block = false;
+    while (offset < this->size && !is_block_header(offset)) {
+        offset++;
+    }
+    this->position = offset;
+    return offset;
+}
+
+
+/**
+ * @brief Get the byte offset of the next sample
+ *
+ * @return size_t offset in the stream
+ */
+size_t Sht3xLogDecoder::get_position() {
+    return this->position;
+}
+
+
+/**
+ * @brief Get the mode byte of the current block,
+ *        see sht3x_encoder_mode()
+ *
+ * @return uint8_t mode byte
+ */
+uint8_t Sht3xLogDecoder::get_mode() {
+    return this->mode;
+}
+
+
+/**
+ * @brief Get the sample period of the current block
+ *
+ * @return uint16_t period in ms
+ */
+uint16_t Sht3xLogDecoder::get_period_ms() {
+    return this->period_ms;
+}
+
+
+/**
+ * @brief Check for a complete block header with a valid CRC
+ *
+ * @param offset byte offset in the stream
+ * @return true a block starts at the offset
+ */
+bool Sht3xLogDecoder::is_block_header(size_t offset) {
+    if (this->size - offset < ENCODER_BLOCK_HEADER_SIZE) {
+        return false;
+    }
+    const uint8_t *p = this->data + offset;
+    return p[0] == ENCODER_BLOCK_MAGIC_0 && p[1] == ENCODER_BLOCK_MAGIC_1
+        && sht3x_crc8(p, ENCODER_BLOCK_HEADER_SIZE - 1) == p[ENCODER_BLOCK_HEADER_SIZE - 1];
+}
+
+
+/**
+ * @brief Start decoding the block at the current position
+ *
+ * @param sample keyframe of the block
+ */
+void Sht3xLogDecoder::read_header(Sht3xSample &sample) {
+    const uint8_t *p = this->data + this->position;
+    this->mode = p[2];
+    this->block_timestamp_ms = ((uint32_t)p[3] << 24) | ((uint32_t)p[4] << 16)
+        | ((uint32_t)p[5] << 8) | p[6];
+    this->period_ms = (uint16_t)((p[7] << 8) | p[8]);
+    this->temperature_raw = (uint16_t)((p[9] << 8) | p[10]);
+    this->rh_raw = (uint16_t)((p[11] << 8) | p[12]);
+    this->temperature_mean = (uint32_t)this->temperature_raw << ENCODER_PREDICTOR_SHIFT;
+    this->rh_mean = (uint32_t)this->rh_raw << ENCODER_PREDICTOR_SHIFT;
+    this->sample_index = 0;
+    this->in_block = true;
+    this->position += ENCODER_BLOCK_HEADER_SIZE;
+
+    sample.timestamp_ms = this->block_timestamp_ms;
+    sample.temperature_raw = this->temperature_raw;
+    sample.rh_raw = this->rh_raw;
+}
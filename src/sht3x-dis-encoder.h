@@ -0,0 +1,144 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_ENCODER_H
+#define SHT3X_DIS_ENCODER_H
+#include "sht3x-dis-arduino-lib.h"
+#include "sht3x-dis-ring-buffer.h"
+
+/**
+ * Compact binary log of raw samples.
+ *
+ * The stream is a sequence of blocks. Each block starts with a
+ * header holding the acquisition mode, the timestamp of its
+ * first sample, the sample period and the first sample as a
+ * keyframe. Every following sample is stored as the zig-zag
+ * coded difference to a running mean of the samples before it,
+ * packed with its tag into as few bytes as possible:
+ *
+ *   0ttt rrrr                        temperature < 8,    rh < 16
+ *   10tt tttt rrrr rrrr              temperature < 64,   rh < 256
+ *   110t tttt tttt trrr rrrr rrrr    temperature < 1024, rh < 2048
+ *   1110 0000 + 4 bytes              absolute raw words, MSB first
+ *
+ * The running mean is kept as mean << ENCODER_PREDICTOR_SHIFT
+ * and moves by 1/2^ENCODER_PREDICTOR_SHIFT of each difference.
+ * On sensor noise its difference is smaller than the one to the
+ * previous sample, which alone carries the noise of two samples.
+ * Keyframes and absolute samples restart the mean.
+ *
+ * Timestamps are implicit, the n-th sample of a block is at the
+ * block timestamp plus n periods. A new block is started every
+ * keyframe interval, and whenever a sample arrives off schedule,
+ * so a reader can start decoding at any block.
+ */
+
+#define ENCODER_BLOCK_MAGIC_0           0xF5
+#define ENCODER_BLOCK_MAGIC_1           0x33
+/*magic, mode, timestamp, period, keyframe and CRC-8*/
+#define ENCODER_BLOCK_HEADER_SIZE       14
+#define ENCODER_TAG_ABSOLUTE            0xE0
+#define ENCODER_ABSOLUTE_SIZE           5
+#define ENCODER_DEFAULT_KEYFRAME_INTERVAL 100
+#define ENCODER_PREDICTOR_SHIFT         2
+
+
+/**
+ * @brief Pack the acquisition settings of the sensor into the
+ *        mode byte of a block header
+ *        bits 0-1 AcquisitionMode, bits 2-4 Mps, bits 5-6 Repeatability
+ *
+ * @param sensor sensor the samples are taken from
+ * @return uint8_t mode byte
+ */
+uint8_t sht3x_encoder_mode(Sht3x &sensor);
+
+
+/**
+ * @brief Writes samples to any Print (SD card file, flash
+ *        writer, Serial) in the compact block format
+ */
+class Sht3xLogEncoder {
+    public:
+        Sht3xLogEncoder(Print &out, uint16_t keyframe_interval = ENCODER_DEFAULT_KEYFRAME_INTERVAL);
+        ~Sht3xLogEncoder() = default;
+        void start(Sht3x &sensor);
+        void start(uint8_t mode, uint16_t period_ms);
+        size_t write(const Sht3xSample &sample);
+        uint32_t get_bytes_written();
+        uint32_t get_samples_written();
+
+    private:
+        Print &out;
+        uint16_t keyframe_interval;
+        uint8_t mode = 0;
+        uint16_t period_ms = 0;
+        uint16_t samples_in_block = 0;
+        uint32_t next_timestamp_ms = 0;
+        uint32_t temperature_mean = 0;
+        uint32_t rh_mean = 0;
+        uint32_t bytes_written = 0;
+        uint32_t samples_written = 0;
+
+        size_t write_header(const Sht3xSample &sample);
+        size_t write_delta(const Sht3xSample &sample);
+};
+
+
+/**
+ * @brief Decodes samples from a log held in memory.
+ *        Decoding starts at the first block, use seek()
+ *        to start at a later one.
+ */
+class Sht3xLogDecoder {
+    public:
+        Sht3xLogDecoder(const uint8_t *data, size_t size);
+        ~Sht3xLogDecoder() = default;
+        bool next(Sht3xSample &sample);
+        size_t seek(size_t offset);
+        size_t get_position();
+        uint8_t get_mode();
+        uint16_t get_period_ms();
+
+    private:
+        const uint8_t *data;
+        size_t size;
+        size_t position = 0;
+        bool in_block = false;
+        uint8_t mode = 0;
+        uint16_t period_ms = 0;
+        uint32_t block_timestamp_ms = 0;
+        uint16_t sample_index = 0;
+        uint16_t temperature_raw = 0;
+        uint16_t rh_raw = 0;
+        uint32_t temperature_mean = 0;
+        uint32_t rh_mean = 0;
+
+        bool is_block_header(size_t offset);
+        void read_header(Sht3xSample &sample);
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-lite.h"
+
+/**
+ * @brief Construct a new Sht3xLite object
+ *
+ * @param device_address 7bit address of sht3x
+ * @param wire i2c bus the sensor is attached to
+ */
+Sht3xLite::Sht3xLite(const uint8_t device_address, TwoWire &wire):
+    wire{wire}, device_address{device_address} {
+}
+
+
+/**
+ * @brief Construct a new Sht3xLite object for a sensor
+ *        behind an i2c multiplexer
+ *
+ * @param device_address 7bit address of sht3x
+ * @param mux multiplexer the sensor is attached to
+ * @param mux_channel channel of the multiplexer 0-7
+ */
+Sht3xLite::Sht3xLite(const uint8_t device_address, Sht3xMux &mux, uint8_t mux_channel):
+    wire{mux.get_wire()}, mux{&mux}, device_address{device_address},
+    mux_channel{mux_channel} {
+}
+
+
+/**
+ * @brief Send a command without data
+ *
+ * @param command command word, sent MSB first
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3xLite::send_command(uint16_t command) {
+    Sht3x::I2C_STATUS status = Sht3x::select_mux_channel(this->mux, this->mux_channel);
+    if (status != Sht3x::I2C_STATUS::SUCCESS) {
+        return status;
+    }
+    uint8_t cmds[2] = {(uint8_t)(command >> 8), (uint8_t)command};
+    return Sht3x::transmit(this->wire, this->device_address, cmds, 2);
+}
+
+
+/**
+ * @brief Read data without sending a command first
+ *
+ * @param rx_buffer i2c buffer to receive data
+ * @param rx_buffer_size i2c receive buffer size
+ * @return Sht3x::I2C_STATUS WIRE_AVAILABLE_FALSE when the
+ *         sensor NACKs, for example while it is measuring
+ */
+Sht3x::I2C_STATUS Sht3xLite::receive(uint8_t *rx_buffer, uint8_t rx_buffer_size) {
+    if (Sht3x::select_mux_channel(this->mux, this->mux_channel) != Sht3x::I2C_STATUS::SUCCESS) {
+        return Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE;
+    }
+    return Sht3x::receive(this->wire, this->device_address, rx_buffer, rx_buffer_size);
+}
+
+
+/**
+ * @brief Single shot measurement with clock stretching, the
+ *        call returns when the result is read
+ *
+ * @param repeatability repeatability of the measurement
+ * @return Sht3xReading raw words and status, CRC_ERROR if
+ *         the result was corrupted
+ */
+Sht3xReading Sht3xLite::measure(Repeatability repeatability) {
+    Sht3xReading reading = {0, 0, send_command(sht3x_single_shot_command(repeatability,
+        ClockStretching::STRETCHING_ENABLED))};
+    if (reading.status != Sht3x::I2C_STATUS::SUCCESS) {
+        return reading;
+    }
+    return read();
+}
+
+
+/**
+ * @brief Start a single shot measurement without clock
+ *        stretching, read() returns the result once the
+ *        conversion is done
+ *
+ * @param repeatability repeatability of the measurement
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3xLite::start(Repeatability repeatability) {
+    return send_command(sht3x_single_shot_command(repeatability,
+        ClockStretching::STRETCHING_DISABLED));
+}
+
+
+/**
+ * @brief Read the result of a measurement started with
+ *        start() or measure()
+ *
+ * @return Sht3xReading raw words and status,
+ *         WIRE_AVAILABLE_FALSE while the sensor is still
+ *         measuring, CRC_ERROR if the result was corrupted
+ */
+Sht3xReading Sht3xLite::read() {
+    uint8_t data[6];
+    Sht3xReading reading = {0, 0, receive(data, 6)};
+    if (reading.status != Sht3x::I2C_STATUS::SUCCESS) {
+        return reading;
+    }
+    reading.status = Sht3x::check_crc(data, 6);
+    if (reading.status != Sht3x::I2C_STATUS::SUCCESS) {
+        return reading;
+    }
+    reading.temperature_raw = (data[0] << 8) | data[1];
+    reading.rh_raw = (data[3] << 8) | data[4];
+    return reading;
+}
+
+
+/**
+ * @brief Start periodic measurements, read them with fetch()
+ *
+ * @param mps measurements per second
+ * @param repeatability repeatability of the measurements
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3xLite::start_periodic(Mps mps, Repeatability repeatability) {
+    return send_command(sht3x_periodic_command(mps, repeatability));
+}
+
+
+/**
+ * @brief Fetch the latest periodic measurement
+ *
+ * @return Sht3xReading raw words and status,
+ *         WIRE_AVAILABLE_FALSE when there is no new result
+ */
+Sht3xReading Sht3xLite::fetch() {
+    Sht3xReading reading = {0, 0, send_command((FETCH_DATA_MSB << 8) | FETCH_DATA_LSB)};
+    if (reading.status != Sht3x::I2C_STATUS::SUCCESS) {
+        return reading;
+    }
+    return read();
+}
+
+
+/**
+ * @brief Stop periodic measurements with the break command
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3xLite::stop() {
+    return send_command((BREAK_CMD_MSB << 8) | BREAK_CMD_LSB);
+}
+
+
+/**
+ * @brief Reset the sensor
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3xLite::soft_reset() {
+    return send_command((SOFT_RESET_MSB << 8) | SOFT_RESET_LSB);
+}
+
+
+/**
+ * @brief Read the status register, decode it with the
+ *        STATUS_*_BIT positions
+ *
+ * @param status_word content of the status register
+ * @return Sht3x::I2C_STATUS status of the i2c comms,
+ *         CRC_ERROR if the word was corrupted
+ */
+Sht3x::I2C_STATUS Sht3xLite::read_status(uint16_t &status_word) {
+    Sht3x::I2C_STATUS status = send_command((READ_STATUS_REGISTER_MSB << 8)
+        | READ_STATUS_REGISTER_LSB);
+    uint8_t data[3];
+    if (status != Sht3x::I2C_STATUS::SUCCESS
+        || (status = receive(data, 3)) != Sht3x::I2C_STATUS::SUCCESS) {
+        return status;
+    }
+    status = Sht3x::check_crc(data, 3);
+    if (status != Sht3x::I2C_STATUS::SUCCESS) {
+        return status;
+    }
+    status_word = (data[0] << 8) | data[1];
+    return status;
+}
+
+
+uint8_t sht3x_lite_sweep(Sht3xLite *sensors, Sht3xReading *readings, uint8_t count,
+    Repeatability repeatability) {
+    /*WIRE_AVAILABLE_FALSE marks a started sensor not read yet*/
+    for (uint8_t i = 0; i < count; i++) {
+        Sht3x::I2C_STATUS status = sensors[i].start(repeatability);
+        readings[i].status = status == Sht3x::I2C_STATUS::SUCCESS
+            ? Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE : status;
+    }
+
+    uint32_t duration_us = sht3x_measurement_duration_us(repeatability);
+    uint32_t start_us = micros();
+    delay(duration_us / 1000);
+    delayMicroseconds(duration_us % 1000);
+
+    /*A sensor that NACKs is tried again for up to one more
+      conversion time, then it has timed out*/
+    uint8_t measured = 0;
+    uint8_t pending;
+    do {
+        pending = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            if (readings[i].status != Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) {
+                continue;
+            }
+            readings[i] = sensors[i].read();
+            if (readings[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+                measured++;
+            } else if (readings[i].status == Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) {
+                pending++;
+            }
+        }
+        if (pending > 0) {
+            delay(1);
+        }
+    } while (pending > 0 && micros() - start_us < 2 * duration_us);
+
+    for (uint8_t i = 0; i < count && pending > 0; i++) {
+        if (readings[i].status == Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) {
+            readings[i].status = Sht3x::I2C_STATUS::TIMEOUT;
+        }
+    }
+    return measured;
+}
@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#ifndef SHT3X_DIS_LITE_H
+#define SHT3X_DIS_LITE_H
+#include "sht3x-dis-arduino-lib.h"
+
+
+/*One measurement as sent by the sensor, returned by value*/
+struct Sht3xReading {
+    uint16_t temperature_raw;
+    uint16_t rh_raw;
+    Sht3x::I2C_STATUS status;
+};
+
+
+/**
+ * @brief Minimal driver for many sensors on small MCUs.
+ *
+ *        An instance only holds the bus, the address and the
+ *        mux channel, a few bytes. Every call returns its
+ *        result, the transfer buffers live on the stack and
+ *        nothing is kept between calls, so readings can be
+ *        written straight into the arrays of the caller.
+ *        Convert them with sht3x_temperature_centi() and
+ *        sht3x_rh_centi().
+ *
+ *        There is no alert, heater, perf counter or trace
+ *        support, use Sht3x for those.
+ */
+class Sht3xLite {
+    public:
+        Sht3xLite(const uint8_t device_address, TwoWire &wire = Wire);
+        Sht3xLite(const uint8_t device_address, Sht3xMux &mux, uint8_t mux_channel);
+        ~Sht3xLite() = default;
+        Sht3xReading measure(Repeatability repeatability = Repeatability::HIGH_REPEATABILITY);
+        Sht3x::I2C_STATUS start(Repeatability repeatability = Repeatability::HIGH_REPEATABILITY);
+        Sht3xReading read();
+        Sht3x::I2C_STATUS start_periodic(Mps mps,
+            Repeatability repeatability = Repeatability::HIGH_REPEATABILITY);
+        Sht3xReading fetch();
+        Sht3x::I2C_STATUS stop();
+        Sht3x::I2C_STATUS soft_reset();
+        Sht3x::I2C_STATUS read_status(uint16_t &status_word);
+
+    private:
+        TwoWire &wire;
+        Sht3xMux *const mux = nullptr;
+        const uint8_t device_address;
+        const uint8_t mux_channel = 0;
+
+        Sht3x::I2C_STATUS send_command(uint16_t command);
+        Sht3x::I2C_STATUS receive(uint8_t *rx_buffer, uint8_t rx_buffer_size);
+};
+
+
+/**
+ * @brief Measure many sensors at once. The conversions are
+ *        started back to back and read after one conversion
+ *        time. List sensors behind muxes channel by channel
+ *        to switch each channel only twice.
+ *
+ * @param sensors array of sensors
+ * @param readings array of count readings, filled in the
+ *        order of the sensors
+ * @param count number of sensors
+ * @param repeatability repeatability of all measurements
+ * @return uint8_t number of sensors measured successfully.
+ *         A sensor still measuring after twice the
+ *         conversion time gets TIMEOUT.
+ */
+uint8_t sht3x_lite_sweep(Sht3xLite *sensors, Sht3xReading *readings, uint8_t count,
+    Repeatability repeatability = Repeatability::HIGH_REPEATABILITY);
+
+#endif
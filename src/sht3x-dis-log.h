@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_LOG_H
+#define SHT3X_DIS_LOG_H
+#include <Arduino.h>
+
+/**
+ * Diagnostic messages printed to Serial.
+ * Logging is compiled out unless SHT3X_LOG_LEVEL is defined
+ * before the library is built, for example with
+ * -DSHT3X_LOG_LEVEL=2 in the build flags. With the default
+ * level no message strings end up in flash and no call
+ * waits on the serial port.
+ */
+
+#define SHT3X_LOG_LEVEL_NONE            0
+#define SHT3X_LOG_LEVEL_ERROR           1
+#define SHT3X_LOG_LEVEL_INFO            2
+
+#ifndef SHT3X_LOG_LEVEL
+#define SHT3X_LOG_LEVEL                 SHT3X_LOG_LEVEL_NONE
+#endif
+
+#if SHT3X_LOG_LEVEL >= SHT3X_LOG_LEVEL_ERROR
+#define SHT3X_LOG_ERROR(message)        Serial.println(F(message))
+#else
+#define SHT3X_LOG_ERROR(message)        do {} while (0)
+#endif
+
+#if SHT3X_LOG_LEVEL >= SHT3X_LOG_LEVEL_INFO
+#define SHT3X_LOG_INFO(message)         Serial.println(F(message))
+#else
+#define SHT3X_LOG_INFO(message)         do {} while (0)
+#endif
+
+#endif
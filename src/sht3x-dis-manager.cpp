@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-manager.h"
+
+/**
+ * @brief Construct a new Sht3xManager object
+ *
+ * @param sensors array of sensors, can be spread over
+ *        several addresses and buses
+ * @param sensor_count number of sensors in the array, at most
+ *        MANAGER_MAX_SENSORS are measured
+ */
+Sht3xManager::Sht3xManager(Sht3x **sensors, uint8_t sensor_count):
+    sensors{sensors},
+    sensor_count{sensor_count < MANAGER_MAX_SENSORS ? sensor_count : (uint8_t)MANAGER_MAX_SENSORS} {
+}
+
+
+/**
+ * @brief Group of a sensor, sensors of one group are on the
+ *        same channel of the same mux. Sensors directly on a
+ *        bus are group 0.
+ *        The mux is identified by the first sensor of the
+ *        array behind it, not by its address, as muxes on
+ *        different buses can share an address.
+ *
+ * @param sensor sensor of the array
+ * @return uint16_t group, ordered by the first sensor of the
+ *         mux and by channel
+ */
+uint16_t Sht3xManager::group_of(Sht3x *sensor) {
+    Sht3xMux *mux = sensor->get_mux();
+    if (mux == nullptr) {
+        return 0;
+    }
+    uint8_t first = 0;
+    while (this->sensors[first]->get_mux() != mux) {
+        first++;
+    }
+    return ((uint16_t)(first + 1) << 8) | (sensor->get_mux_channel() + 1);
+}
+
+
+/**
+ * @brief Order the sensors by group. The groups are computed
+ *        once, sensors of one group keep their array order.
+ *
+ * @param order array of sensor_count indices, filled with the
+ *        indices of the sensors in the order to visit them
+ */
+void Sht3xManager::sort_by_group(uint8_t *order) {
+    uint16_t groups[MANAGER_MAX_SENSORS];
+    for (uint8_t i = 0; i < this->sensor_count; i++) {
+        uint16_t group = group_of(this->sensors[i]);
+        uint8_t j = i;
+        while (j > 0 && groups[j - 1] > group) {
+            groups[j] = groups[j - 1];
+            order[j] = order[j - 1];
+            j--;
+        }
+        groups[j] = group;
+        order[j] = i;
+    }
+}
+
+
+/**
+ * @brief Measure all sensors once.
+ *        All conversions are started back to back and the
+ *        results are collected in the order the sensors
+ *        become ready, so a sweep takes about one conversion
+ *        time plus the bus transfers instead of one
+ *        conversion time per sensor.
+ *        Sensors behind muxes are visited channel by channel,
+ *        so each pass over the sensors switches every channel
+ *        only once, whatever the order of the array. The
+ *        passes are 1 ms apart until all results are in.
+ *
+ * @param results array of sensor_count results, filled in
+ *        the same order as the sensors
+ * @param mode single shot measurement mode 1-6
+ * @return uint8_t number of sensors measured successfully
+ */
+uint8_t Sht3xManager::sweep(Sht3xResult *results, uint8_t mode) {
+    uint8_t order[MANAGER_MAX_SENSORS];
+    sort_by_group(order);
+
+    uint8_t pending = 0;
+    for (uint8_t k = 0; k < this->sensor_count; k++) {
+        uint8_t i = order[k];
+        results[i].status = this->sensors[i]->start_single_shot(mode);
+        if (results[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+            pending++;
+        }
+    }
+
+    uint8_t measured = 0;
+    while (pending > 0) {
+        for (uint8_t k = 0; k < this->sensor_count; k++) {
+            uint8_t i = order[k];
+            Sht3x::MeasurementState state = this->sensors[i]->poll();
+
+            if (state == Sht3x::MeasurementState::READY) {
+                results[i].status = this->sensors[i]->collect();
+                if (results[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+                    results[i].temperature = this->sensors[i]->get_temperature();
+                    results[i].rh = this->sensors[i]->get_rh();
+                    measured++;
+                }
+                pending--;
+            } else if (state == Sht3x::MeasurementState::FAILED
+                && results[i].status == Sht3x::I2C_STATUS::SUCCESS) {
+                results[i].status = Sht3x::I2C_STATUS::TIMEOUT;
+                pending--;
+            }
+        }
+        if (pending > 0) {
+            delay(1);
+        }
+    }
+    return measured;
+}
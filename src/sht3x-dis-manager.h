@@ -0,0 +1,57 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_MANAGER_H
+#define SHT3X_DIS_MANAGER_H
+#include "sht3x-dis-arduino-lib.h"
+
+#ifndef MANAGER_MAX_SENSORS
+#define MANAGER_MAX_SENSORS             32      /*sensors per manager, sweep() uses 3 bytes of stack each*/
+#endif
+
+/*Result of one sensor in a sweep*/
+struct Sht3xResult {
+    float temperature;
+    float rh;
+    Sht3x::I2C_STATUS status;
+};
+
+
+class Sht3xManager {
+    public:
+        Sht3xManager(Sht3x **sensors, uint8_t sensor_count);
+        ~Sht3xManager() = default;
+        uint8_t sweep(Sht3xResult *results, uint8_t mode = 4);
+
+    private:
+        Sht3x **sensors;
+        const uint8_t sensor_count;
+
+        uint16_t group_of(Sht3x *sensor);
+        void sort_by_group(uint8_t *order);
+};
+
+#endif
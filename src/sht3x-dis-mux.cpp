@@ -0,0 +1,176 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-mux.h"
+
+/**
+ * @brief Construct a new Sht3xMux object
+ *
+ * @param mux_address 7bit address of the multiplexer
+ * @param wire i2c bus the multiplexer is attached to
+ */
+Sht3xMux::Sht3xMux(uint8_t mux_address, TwoWire &wire):
+    wire{wire}, mux_address{mux_address} {
+}
+
+
+/**
+ * @brief Put another mux of the same bus into the group of
+ *        this one. Only one channel of the whole group is
+ *        connected at a time.
+ *
+ * @param other mux to add, must not be in a group yet
+ */
+void Sht3xMux::link(Sht3xMux &other) {
+    other.next = this->next;
+    this->next = &other;
+}
+
+
+/**
+ * @brief Connect a channel and disconnect all the others.
+ *        Nothing is sent when the channel is already the
+ *        selected one.
+ *
+ * @param channel channel 0-7
+ * @return uint8_t return code of Wire.endTransmission(),
+ *         4 for a channel out of range
+ */
+uint8_t Sht3xMux::select(uint8_t channel) {
+    if (channel >= MUX_CHANNEL_COUNT) {
+        return 4;
+    }
+    if (channel == this->channel) {
+        return 0;
+    }
+
+    for (Sht3xMux *mux = this->next; mux != this; mux = mux->next) {
+        uint8_t status = mux->disable();
+        if (status != 0) {
+            return status;
+        }
+    }
+    return write_channel(channel);
+}
+
+
+/**
+ * @brief Disconnect all channels of the mux
+ *
+ * @return uint8_t return code of Wire.endTransmission()
+ */
+uint8_t Sht3xMux::disable() {
+    if (this->channel == MUX_NO_CHANNEL) {
+        return 0;
+    }
+    return write_channel(MUX_NO_CHANNEL);
+}
+
+
+/**
+ * @brief Forget the cached channel, the next select() writes
+ *        the mux again. Call after the mux was reset or the
+ *        bus was restarted.
+ */
+void Sht3xMux::invalidate() {
+    this->channel = MUX_UNKNOWN_CHANNEL;
+}
+
+
+/**
+ * @brief Write the control byte of the mux
+ *
+ * @param new_channel channel 0-7 or MUX_NO_CHANNEL
+ * @return uint8_t return code of Wire.endTransmission()
+ */
+uint8_t Sht3xMux::write_channel(uint8_t new_channel) {
+    this->wire.beginTransmission(this->mux_address);
+    this->wire.write(new_channel == MUX_NO_CHANNEL ? 0 : (uint8_t)(1 << new_channel));
+    uint8_t status = this->wire.endTransmission();
+
+    /*After a failed write it is not known what the mux received*/
+    this->channel = status == 0 ? new_channel : MUX_UNKNOWN_CHANNEL;
+    this->switch_count++;
+    return status;
+}
+
+
+/**
+ * @brief Get the selected channel
+ *
+ * @return uint8_t channel 0-7, MUX_NO_CHANNEL or
+ *         MUX_UNKNOWN_CHANNEL before the first select()
+ */
+uint8_t Sht3xMux::get_channel() {
+    return this->channel;
+}
+
+
+/**
+ * @brief Get the address of the mux
+ *
+ * @return uint8_t 7bit address
+ */
+uint8_t Sht3xMux::get_address() {
+    return this->mux_address;
+}
+
+
+/**
+ * @brief Get the bus the mux is attached to
+ *
+ * @return TwoWire& i2c bus
+ */
+TwoWire &Sht3xMux::get_wire() {
+    return this->wire;
+}
+
+
+/**
+ * @brief Get the number of control byte writes, including
+ *        the ones disconnecting linked muxes
+ *
+ * @return uint32_t writes since construction
+ */
+uint32_t Sht3xMux::get_switch_count() {
+    return this->switch_count;
+}
+
+
+/**
+ * @brief Get the number of control byte writes of this mux
+ *        and of the muxes linked to it
+ *
+ * @return uint32_t writes since construction
+ */
+uint32_t Sht3xMux::get_group_switch_count() {
+    uint32_t count = this->switch_count;
+    for (Sht3xMux *mux = this->next; mux != this; mux = mux->next) {
+        count += mux->switch_count;
+    }
+    return count;
+}
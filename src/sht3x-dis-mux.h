@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#ifndef SHT3X_DIS_MUX_H
+#define SHT3X_DIS_MUX_H
+#include <Wire.h>
+#include <Arduino.h>
+
+#define MUX_DEFAULT_ADDRESS             0x70  // TCA9548A with A0-A2 low
+#define MUX_CHANNEL_COUNT               8
+#define MUX_NO_CHANNEL                  0xFE  /*all channels disconnected*/
+#define MUX_UNKNOWN_CHANNEL             0xFF  /*state of the mux not known*/
+
+
+/**
+ * @brief TCA9548A style i2c multiplexer, one control byte
+ *        with a bit per downstream channel.
+ *
+ *        The selected channel is cached, so select() only
+ *        touches the bus when the channel really changes.
+ *        Several muxes on the same bus are linked with
+ *        link(), then selecting a channel on one mux first
+ *        disconnects the others, as sensors behind different
+ *        muxes can share an address.
+ */
+class Sht3xMux {
+    public:
+        Sht3xMux(uint8_t mux_address = MUX_DEFAULT_ADDRESS, TwoWire &wire = Wire);
+        ~Sht3xMux() = default;
+        void link(Sht3xMux &other);
+        uint8_t select(uint8_t channel);
+        uint8_t disable();
+        void invalidate();
+        uint8_t get_channel();
+        uint8_t get_address();
+        TwoWire &get_wire();
+        uint32_t get_switch_count();
+        uint32_t get_group_switch_count();
+
+    private:
+        TwoWire &wire;
+        const uint8_t mux_address;
+        uint8_t channel = MUX_UNKNOWN_CHANNEL;
+        uint32_t switch_count = 0;
+        Sht3xMux *next = this; /*ring of the muxes sharing the bus*/
+
+        uint8_t write_channel(uint8_t new_channel);
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_PERF_H
+#define SHT3X_DIS_PERF_H
+#include <Arduino.h>
+
+/**
+ * Performance counters of the i2c transport.
+ * Compiled out unless SHT3X_PERF_COUNTERS is defined to 1
+ * before the library is built, for example with
+ * -DSHT3X_PERF_COUNTERS=1 in the build flags. Disabled, the
+ * counters take no RAM and the macros expand to nothing.
+ * Enabled, each bus transaction costs two micros() calls and
+ * a few increments.
+ *
+ * The flag adds the counters to Sht3x, so it has to be the
+ * same for the library and every file that includes its
+ * headers. Set it in the build flags of the whole project,
+ * not with a #define in the sketch: a class with two layouts
+ * in one program breaks the one definition rule.
+ *
+ * Every START to STOP transaction on the bus is counted with
+ * its bytes, its status and its latency, including the control
+ * bytes written to a mux to select the channel of the sensor. The latency histogram
+ * has log2 buckets: bucket 0 holds 0 us, bucket i holds
+ * 2^(i-1) to 2^i - 1 us and the last bucket everything longer.
+ * CRC failures are counted under CRC_ERROR, and a read that
+ * is NACKed and tried again as a retry. The 16 bit counters
+ * wrap around.
+ */
+
+#ifndef SHT3X_PERF_COUNTERS
+#define SHT3X_PERF_COUNTERS             0
+#endif
+
+#define SHT3X_PERF_STATUS_COUNT         9   /*number of I2C_STATUS values*/
+#define SHT3X_PERF_HISTOGRAM_BUCKETS    16
+
+
+struct Sht3xPerfCounters {
+    uint32_t transactions;
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    uint16_t status_count[SHT3X_PERF_STATUS_COUNT]; /*indexed by I2C_STATUS*/
+    uint16_t retries;
+    uint16_t latency_histogram[SHT3X_PERF_HISTOGRAM_BUCKETS];
+};
+
+
+/**
+ * @brief Count one bus transaction
+ *
+ * @param counters counters of the sensor
+ * @param latency_us duration of the transaction
+ * @param bytes_written bytes sent to the sensor
+ * @param bytes_read bytes received from the sensor
+ * @param status I2C_STATUS of the transaction
+ */
+static inline void sht3x_perf_record(Sht3xPerfCounters &counters, uint32_t latency_us,
+    uint8_t bytes_written, uint8_t bytes_read, uint8_t status) {
+    counters.transactions++;
+    counters.bytes_written += bytes_written;
+    counters.bytes_read += bytes_read;
+    counters.status_count[status]++;
+
+    uint8_t bucket = 0;
+    while (latency_us != 0 && bucket < SHT3X_PERF_HISTOGRAM_BUCKETS - 1) {
+        latency_us >>= 1;
+        bucket++;
+    }
+    counters.latency_histogram[bucket]++;
+}
+
+#if SHT3X_PERF_COUNTERS
+#define SHT3X_PERF_START(start_us)      uint32_t start_us = micros()
+#define SHT3X_PERF_TRANSACTION(counters, start_us, bytes_written, bytes_read, status) \
+    sht3x_perf_record(counters, micros() - start_us, bytes_written, bytes_read, (uint8_t)(status))
+#define SHT3X_PERF_COUNT(counters, status) counters.status_count[(uint8_t)(status)]++
+#define SHT3X_PERF_RETRY(counters)      counters.retries++
+#else
+#define SHT3X_PERF_START(start_us)      do {} while (0)
+#define SHT3X_PERF_TRANSACTION(counters, start_us, bytes_written, bytes_read, status) do {} while (0)
+#define SHT3X_PERF_COUNT(counters, status) do {} while (0)
+#define SHT3X_PERF_RETRY(counters)      do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,198 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-psychrometrics.h"
+#include <math.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define SHT3X_PSYCHROMETRICS_TABLE_READ(table, index) pgm_read_float(&table[index])
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define SHT3X_PSYCHROMETRICS_TABLE_READ(table, index) table[index]
+#endif
+
+#define TABLE_SEGMENTS                  16
+#define LN_2                            0.69314718f
+#define LOG2_E                          1.44269504f
+
+/*log2(1 + i / 16)*/
+static const float LOG2_TABLE[TABLE_SEGMENTS + 1] PROGMEM = {
+    0.0000000f, 0.0874628f, 0.1699250f, 0.2479275f, 0.3219281f, 0.3923174f,
+    0.4594316f, 0.5235620f, 0.5849625f, 0.6438562f, 0.7004397f, 0.7548875f,
+    0.8073549f, 0.8579810f, 0.9068906f, 0.9541963f, 1.0000000f
+};
+
+/*2^(i / 16)*/
+static const float EXP2_TABLE[TABLE_SEGMENTS + 1] PROGMEM = {
+    1.0000000f, 1.0442738f, 1.0905077f, 1.1387886f, 1.1892071f, 1.2418578f,
+    1.2968396f, 1.3542555f, 1.4142136f, 1.4768261f, 1.5422108f, 1.6104903f,
+    1.6817928f, 1.7562522f, 1.8340081f, 1.9152066f, 2.0000000f
+};
+
+
+/**
+ * @brief Linear interpolation in a table over [0, 1]
+ *
+ * @param table table of TABLE_SEGMENTS + 1 entries
+ * @param x position, 0 <= x < 1
+ * @return float interpolated value
+ */
+static float interpolate(const float *table, float x) {
+    float position = x * TABLE_SEGMENTS;
+    uint8_t index = (uint8_t)position;
+    float low = SHT3X_PSYCHROMETRICS_TABLE_READ(table, index);
+    float high = SHT3X_PSYCHROMETRICS_TABLE_READ(table, index + 1);
+    return low + (high - low) * (position - index);
+}
+
+
+/**
+ * @brief Natural logarithm from the exponent and a table of
+ *        the mantissa
+ *
+ * @param x positive value
+ * @return float ln(x)
+ */
+static float fast_ln(float x) {
+    int exponent;
+    float mantissa = frexpf(x, &exponent); /*0.5 <= mantissa < 1*/
+    return (exponent - 1 + interpolate(LOG2_TABLE, 2.0f * mantissa - 1.0f)) * LN_2;
+}
+
+
+/**
+ * @brief Exponential from the integer part as exponent and a
+ *        table of the fraction
+ *
+ * @param x value
+ * @return float e^x
+ */
+static float fast_exp(float x) {
+    float y = x * LOG2_E;
+    float integer = floorf(y);
+    return ldexpf(interpolate(EXP2_TABLE, y - integer), (int)integer);
+}
+
+
+/**
+ * @brief Magnus term of the saturation vapour pressure
+ *
+ * @param temperature temperature in C
+ * @return float b * T / (c + T)
+ */
+static inline float magnus_term(float temperature) {
+    return MAGNUS_B * temperature / (MAGNUS_C + temperature);
+}
+
+
+/**
+ * @brief Dew point with the exact Magnus formula
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float dew point in C
+ */
+float sht3x_dew_point_exact(float temperature, float rh) {
+    if (rh < PSYCHROMETRICS_MIN_RH) {
+        rh = PSYCHROMETRICS_MIN_RH;
+    }
+    float gamma = logf(rh / 100.0f) + magnus_term(temperature);
+    return MAGNUS_C * gamma / (MAGNUS_B - gamma);
+}
+
+
+/**
+ * @brief Dew point with the table approximation of ln()
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float dew point in C
+ */
+float sht3x_dew_point_fast(float temperature, float rh) {
+    if (rh < PSYCHROMETRICS_MIN_RH) {
+        rh = PSYCHROMETRICS_MIN_RH;
+    }
+    float gamma = fast_ln(rh / 100.0f) + magnus_term(temperature);
+    return MAGNUS_C * gamma / (MAGNUS_B - gamma);
+}
+
+
+/**
+ * @brief Absolute humidity with the exact Magnus formula
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float absolute humidity in g/m^3
+ */
+float sht3x_absolute_humidity_exact(float temperature, float rh) {
+    return ABSOLUTE_HUMIDITY_FACTOR * rh * expf(magnus_term(temperature))
+        / (KELVIN_OFFSET + temperature);
+}
+
+
+/**
+ * @brief Absolute humidity with the table approximation of exp()
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float absolute humidity in g/m^3
+ */
+float sht3x_absolute_humidity_fast(float temperature, float rh) {
+    return ABSOLUTE_HUMIDITY_FACTOR * rh * fast_exp(magnus_term(temperature))
+        / (KELVIN_OFFSET + temperature);
+}
+
+
+/**
+ * @brief Heat index, the apparent temperature felt at the given
+ *        humidity. Uses polynomials only, so there is no
+ *        approximated variant.
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float heat index in C
+ */
+float sht3x_heat_index(float temperature, float rh) {
+    float t = temperature * 1.8f + 32.0f; /*regression is in F*/
+    float heat_index = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+
+    if ((heat_index + t) / 2.0f >= 80.0f) {
+        heat_index = -42.379f + 2.04901523f * t + 10.14333127f * rh
+            - 0.22475541f * t * rh - 0.00683783f * t * t
+            - 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+            + 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+
+        if (rh < 13.0f && t > 80.0f && t < 112.0f) {
+            heat_index -= (13.0f - rh) / 4.0f * sqrtf((17.0f - fabsf(t - 95.0f)) / 17.0f);
+        } else if (rh > 85.0f && t > 80.0f && t < 87.0f) {
+            heat_index += (rh - 85.0f) / 10.0f * (87.0f - t) / 5.0f;
+        }
+    }
+    return (heat_index - 32.0f) / 1.8f;
+}
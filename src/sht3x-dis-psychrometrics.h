@@ -0,0 +1,101 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_PSYCHROMETRICS_H
+#define SHT3X_DIS_PSYCHROMETRICS_H
+#include <stdint.h>
+
+/**
+ * Quantities derived from temperature and rh.
+ * Refer to the Sensirion application note "Introduction to
+ * Humidity" for the Magnus formula and its coefficients
+ *
+ *   gamma = ln(RH / 100) + b * T / (c + T)
+ *   dew point = c * gamma / (b - gamma)
+ *   absolute humidity = 216.7 * RH / 100 * 6.112 * exp(b * T / (c + T)) / (273.15 + T)
+ *
+ * with b = 17.62 and c = 243.12 C, valid from -45 C to 60 C.
+ * The heat index is the NWS Rothfusz regression.
+ *
+ * By default ln() and exp() are replaced by a lookup of 17
+ * entries per function with linear interpolation in between,
+ * which avoids the libm calls that take thousands of cycles
+ * on AVR. Over the full raw range of the sensor the maximum
+ * error against the exact formula is 0.014 C for the dew point
+ * and 0.024 % of the value for the absolute humidity.
+ * Define SHT3X_PSYCHROMETRICS_EXACT to use the exact formula.
+ * Temperatures are in degrees C and rh in percent.
+ */
+
+#define MAGNUS_B                        17.62f
+#define MAGNUS_C                        243.12f     /*C*/
+#define ABSOLUTE_HUMIDITY_FACTOR        (216.7f * 6.112f / 100.0f)
+#define KELVIN_OFFSET                   273.15f
+/*Lower limit of the rh, ln(0) is not defined*/
+#define PSYCHROMETRICS_MIN_RH           0.01f       /*%*/
+
+
+float sht3x_dew_point_exact(float temperature, float rh);
+float sht3x_dew_point_fast(float temperature, float rh);
+float sht3x_absolute_humidity_exact(float temperature, float rh);
+float sht3x_absolute_humidity_fast(float temperature, float rh);
+float sht3x_heat_index(float temperature, float rh);
+
+
+/**
+ * @brief Dew point using the implementation selected at
+ *        compile time
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float dew point in C
+ */
+static inline float sht3x_dew_point(float temperature, float rh) {
+#if defined(SHT3X_PSYCHROMETRICS_EXACT)
+    return sht3x_dew_point_exact(temperature, rh);
+#else
+    return sht3x_dew_point_fast(temperature, rh);
+#endif
+}
+
+
+/**
+ * @brief Absolute humidity using the implementation selected
+ *        at compile time
+ *
+ * @param temperature temperature in C
+ * @param rh relative humidity in %
+ * @return float absolute humidity in g/m^3
+ */
+static inline float sht3x_absolute_humidity(float temperature, float rh) {
+#if defined(SHT3X_PSYCHROMETRICS_EXACT)
+    return sht3x_absolute_humidity_exact(temperature, rh);
+#else
+    return sht3x_absolute_humidity_fast(temperature, rh);
+#endif
+}
+
+#endif
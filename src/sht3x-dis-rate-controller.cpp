@@ -0,0 +1,249 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-rate-controller.h"
+
+/**
+ * @brief Construct a new Sht3xRateController object
+ *        with the default policy
+ *
+ * @param sensor sensor to control
+ */
+Sht3xRateController::Sht3xRateController(Sht3x &sensor): sensor{sensor} {
+    this->policy.temperature_up = RATE_DEFAULT_T_UP;
+    this->policy.temperature_down = RATE_DEFAULT_T_DOWN;
+    this->policy.rh_up = RATE_DEFAULT_RH_UP;
+    this->policy.rh_down = RATE_DEFAULT_RH_DOWN;
+    this->policy.calm_windows = RATE_DEFAULT_CALM_WINDOWS;
+    this->policy.min_mps = Mps::MPS_0_5;
+    this->policy.max_mps = Mps::MPS_10;
+}
+
+
+/**
+ * @brief Start the periodic data acquisition at the slowest
+ *        allowed mode. A periodic or ART acquisition that
+ *        runs already is stopped first. If the sensor does not
+ *        take the mode, fetch() tries it again.
+ *
+ * @param repeatability repeatability used in every mode
+ * @return Sht3x::I2C_STATUS status of the mode change
+ */
+Sht3x::I2C_STATUS Sht3xRateController::start(Repeatability repeatability) {
+    this->repeatability = repeatability;
+    this->window_started = false;
+    this->calm_count = 0;
+    this->mps = this->policy.min_mps;
+    this->stopped = false;
+    Sht3x::AcquisitionMode mode = this->sensor.get_acquisition_mode();
+    if (mode == Sht3x::AcquisitionMode::PERIODIC || mode == Sht3x::AcquisitionMode::ART) {
+        this->last_status = this->sensor.send_break_command();
+        if (this->last_status != Sht3x::I2C_STATUS::SUCCESS) {
+            return this->last_status;
+        }
+        delay(BREAK_CMD_DELAY_MS);
+    }
+    this->last_status = this->sensor.set_periodic_data_acquisition(this->mps, repeatability);
+    this->stopped = this->last_status != Sht3x::I2C_STATUS::SUCCESS;
+    return this->last_status;
+}
+
+
+/**
+ * @brief Fetch the latest measurement and adapt the mode.
+ *        Call it every sensor.get_period_ms(), which changes
+ *        with the mode. A sensor left idle by a failed mode
+ *        change is started again first.
+ *
+ * @return Sht3x::I2C_STATUS status of the fetch, or of the
+ *         restart when it failed
+ */
+Sht3x::I2C_STATUS Sht3xRateController::fetch() {
+    if (this->stopped && !switch_mode(this->mps)) {
+        return this->last_status;
+    }
+    Sht3x::I2C_STATUS status = this->sensor.fetch_data();
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        update();
+    }
+    return status;
+}
+
+
+/**
+ * @brief Add the last reading of the sensor to the current
+ *        window and switch the mode at the end of the window.
+ *        Call after every reading when the sensor is not read
+ *        through fetch().
+ *
+ * @return true the acquisition was restarted, a fetch scheduler has
+ *         to be started again
+ */
+bool Sht3xRateController::update() {
+    uint32_t now_ms = millis();
+    int16_t temperature_centi = this->sensor.get_temperature_centi();
+    uint16_t rh_centi = this->sensor.get_rh_centi();
+
+    if (!this->window_started) {
+        this->window_started = true;
+        this->window_start_ms = now_ms;
+        this->window_temperature_centi = temperature_centi;
+        this->window_rh_centi = rh_centi;
+        return false;
+    }
+
+    uint32_t elapsed_ms = now_ms - this->window_start_ms;
+    if (elapsed_ms < RATE_WINDOW_MS) {
+        return false;
+    }
+
+    /*Rates in 0.01 units per second*/
+    uint32_t temperature_rate = (uint32_t)abs(temperature_centi - this->window_temperature_centi)
+        * 1000UL / elapsed_ms;
+    uint32_t rh_rate = (uint32_t)abs((int32_t)rh_centi - (int32_t)this->window_rh_centi)
+        * 1000UL / elapsed_ms;
+    this->window_start_ms = now_ms;
+    this->window_temperature_centi = temperature_centi;
+    this->window_rh_centi = rh_centi;
+
+    if (temperature_rate > this->policy.temperature_up || rh_rate > this->policy.rh_up) {
+        this->calm_count = 0;
+        return switch_mode(this->policy.max_mps);
+    }
+
+    if (temperature_rate >= this->policy.temperature_down || rh_rate >= this->policy.rh_down) {
+        this->calm_count = 0;
+        return false;
+    }
+
+    if (++this->calm_count < this->policy.calm_windows) {
+        return false;
+    }
+    this->calm_count = 0;
+    if (this->mps <= this->policy.min_mps) {
+        return false;
+    }
+    return switch_mode(static_cast<Mps>(static_cast<uint8_t>(this->mps) - 1));
+}
+
+
+/**
+ * @brief Set the thresholds and the allowed modes
+ *
+ * @param policy new policy, used from the next window on
+ */
+void Sht3xRateController::set_policy(const Policy &policy) {
+    this->policy = policy;
+}
+
+
+/**
+ * @brief Get the thresholds and the allowed modes
+ *
+ * @return Sht3xRateController::Policy current policy
+ */
+Sht3xRateController::Policy Sht3xRateController::get_policy() {
+    return this->policy;
+}
+
+
+/**
+ * @brief Get the mode the controller selected
+ *
+ * @return Mps measurements per second
+ */
+Mps Sht3xRateController::get_mps() {
+    return this->mps;
+}
+
+
+/**
+ * @brief Get the number of mode changes so far
+ *
+ * @return uint16_t number of mode changes
+ */
+uint16_t Sht3xRateController::get_mode_changes() {
+    return this->mode_changes;
+}
+
+
+/**
+ * @brief Get the status of the last mode change
+ *
+ * @return Sht3x::I2C_STATUS status of the last break or mode command
+ */
+Sht3x::I2C_STATUS Sht3xRateController::get_last_status() {
+    return this->last_status;
+}
+
+
+/**
+ * @brief Stop the periodic data acquisition and restart it
+ *        in another mode. The sensor only accepts a new mode
+ *        once it has stopped, up to 1 ms after the break command.
+ *        If the new mode is not taken after the break, the
+ *        previous mode is started again. If that fails too, the
+ *        sensor stays idle and fetch() restarts the previous
+ *        mode.
+ *
+ * @param mps new mode
+ * @return true the acquisition was restarted, in the new mode
+ *         or in the previous one
+ */
+bool Sht3xRateController::switch_mode(Mps mps) {
+    if (mps == this->mps && !this->stopped) {
+        return false;
+    }
+
+    if (!this->stopped) {
+        this->last_status = this->sensor.send_break_command();
+        if (this->last_status != Sht3x::I2C_STATUS::SUCCESS) {
+            SHT3X_LOG_ERROR("Failed to stop the periodic mode");
+            return false;
+        }
+        delay(BREAK_CMD_DELAY_MS);
+        this->stopped = true;
+    }
+
+    this->last_status = this->sensor.set_periodic_data_acquisition(mps, this->repeatability);
+    if (this->last_status == Sht3x::I2C_STATUS::SUCCESS) {
+        this->stopped = false;
+        if (mps != this->mps) {
+            SHT3X_LOG_INFO("Periodic mode changed");
+            this->mps = mps;
+            this->mode_changes++;
+        }
+        return true;
+    }
+
+    SHT3X_LOG_ERROR("Failed to change the periodic mode");
+    if (mps != this->mps && this->sensor.set_periodic_data_acquisition(this->mps, this->repeatability)
+        == Sht3x::I2C_STATUS::SUCCESS) {
+        this->stopped = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_RATE_CONTROLLER_H
+#define SHT3X_DIS_RATE_CONTROLLER_H
+#include "sht3x-dis-arduino-lib.h"
+
+#define RATE_WINDOW_MS                  2000    /*time the rate of change is measured over*/
+#define RATE_DEFAULT_T_UP               5       /*0.01 C/s*/
+#define RATE_DEFAULT_T_DOWN             2       /*0.01 C/s*/
+#define RATE_DEFAULT_RH_UP              20      /*0.01 %/s*/
+#define RATE_DEFAULT_RH_DOWN            8       /*0.01 %/s*/
+#define RATE_DEFAULT_CALM_WINDOWS       5
+
+
+/**
+ * @brief Steps the periodic data acquisition between the
+ *        0.5, 1, 2, 4 and 10 mps modes following how fast the
+ *        readings change.
+ *
+ *        The rate of change of temperature and rh is measured
+ *        over windows of RATE_WINDOW_MS. A window faster than
+ *        the step up threshold switches straight to the fastest
+ *        allowed mode, so a transient is followed at once. The
+ *        mode is only lowered one step after calm_windows windows
+ *        in a row slower than the lower step down threshold.
+ *        The gap between the thresholds and the calm windows
+ *        keep the controller from toggling between two modes.
+ *        Slow modes save bus traffic and self heating while
+ *        the readings are stable.
+ */
+class Sht3xRateController {
+    public:
+        struct Policy {
+            uint16_t temperature_up;    /*0.01 C/s, switch to max_mps above*/
+            uint16_t temperature_down;  /*0.01 C/s, a window below is calm*/
+            uint16_t rh_up;             /*0.01 %/s, switch to max_mps above*/
+            uint16_t rh_down;           /*0.01 %/s, a window below is calm*/
+            uint8_t calm_windows;       /*calm windows before stepping down*/
+            Mps min_mps;
+            Mps max_mps;
+        };
+
+        Sht3xRateController(Sht3x &sensor);
+        ~Sht3xRateController() = default;
+        Sht3x::I2C_STATUS start(Repeatability repeatability = Repeatability::HIGH_REPEATABILITY);
+        Sht3x::I2C_STATUS fetch();
+        bool update();
+        void set_policy(const Policy &policy);
+        Policy get_policy();
+        Mps get_mps();
+        uint16_t get_mode_changes();
+        Sht3x::I2C_STATUS get_last_status();
+
+    private:
+        Sht3x &sensor;
+        Policy policy;
+        Repeatability repeatability = Repeatability::HIGH_REPEATABILITY;
+        Mps mps = Mps::MPS_0_5;
+        bool window_started = false;
+        uint32_t window_start_ms = 0;
+        int16_t window_temperature_centi = 0;
+        uint16_t window_rh_centi = 0;
+        uint8_t calm_count = 0;
+        uint16_t mode_changes = 0;
+        bool stopped = false;           /*the sensor is idle after a failed mode change*/
+        Sht3x::I2C_STATUS last_status = Sht3x::I2C_STATUS::SUCCESS;
+
+        bool switch_mode(Mps mps);
+};
+
+#endif
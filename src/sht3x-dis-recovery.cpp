@@ -0,0 +1,274 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-recovery.h"
+
+/**
+ * @brief Construct a new Sht3xRecovery object
+ *
+ * @param sensor sensor to recover
+ * @param sda_pin SDA pin of the bus, -1 to skip the bus clear step
+ * @param scl_pin SCL pin of the bus, -1 to skip the bus clear step
+ * @param budget_ms time after which no further step is started
+ */
+Sht3xRecovery::Sht3xRecovery(Sht3x &sensor, int8_t sda_pin, int8_t scl_pin, uint16_t budget_ms):
+    sensor{sensor}, sda_pin{sda_pin}, scl_pin{scl_pin}, budget_ms{budget_ms} {
+}
+
+
+/**
+ * @brief Try to bring the sensor back after an operation failed.
+ *        Call it when a bus operation returned an error, then
+ *        repeat the operation if it returns SUCCESS.
+ *
+ * @return Sht3x::I2C_STATUS SUCCESS when the sensor answers again
+ *         and its mode was restored, otherwise the last error
+ */
+Sht3x::I2C_STATUS Sht3xRecovery::recover() {
+    if (this->holdoff_ms != 0 && millis() - this->failed_at_ms < this->holdoff_ms) {
+        return this->last_status;
+    }
+
+    if (!this->restore_pending) {
+        this->mode = this->sensor.get_acquisition_mode();
+        this->mps = this->sensor.get_mps();
+        this->repeatability = this->sensor.get_repeatability();
+        this->heater_on = this->sensor.is_heater_on();
+        this->restore_pending = true;
+    }
+
+    this->start_ms = millis();
+    const Level levels[] = {Level::RETRY, Level::SOFT_RESET, Level::GENERAL_CALL_RESET, Level::BUS_CLEAR};
+    for (uint8_t i = 0; i < sizeof(levels) / sizeof(levels[0]) && !over_budget(); i++) {
+        if (levels[i] == Level::GENERAL_CALL_RESET && this->shared_bus) {
+            continue;
+        }
+        this->last_status = attempt(levels[i]);
+        if (this->last_status == Sht3x::I2C_STATUS::SUCCESS) {
+            this->last_status = restore();
+        }
+        if (this->last_status == Sht3x::I2C_STATUS::SUCCESS) {
+            SHT3X_LOG_INFO("Sensor recovered");
+            this->last_level = levels[i];
+            this->restore_pending = false;
+            this->holdoff_ms = 0;
+            this->recoveries++;
+            return this->last_status;
+        }
+    }
+
+    SHT3X_LOG_ERROR("Sensor recovery failed");
+    this->failures++;
+    this->failed_at_ms = millis();
+    this->holdoff_ms = this->holdoff_ms == 0 ? RECOVERY_FIRST_HOLDOFF_MS
+        : this->holdoff_ms >= RECOVERY_MAX_HOLDOFF_MS / 2 ? RECOVERY_MAX_HOLDOFF_MS
+        : this->holdoff_ms * 2;
+    return this->last_status;
+}
+
+
+/**
+ * @brief Tell if other sensors or devices share the bus. The
+ *        general call reset would reset them too, behind the
+ *        back of their drivers, so it is skipped on a shared
+ *        bus and the recovery escalates to the bus clear.
+ *
+ * @param shared true when more than one device is on the bus
+ */
+void Sht3xRecovery::set_shared_bus(bool shared) {
+    this->shared_bus = shared;
+}
+
+
+/**
+ * @brief Get the step that brought the sensor back last time
+ *
+ * @return Sht3xRecovery::Level step of the last successful recovery
+ */
+Sht3xRecovery::Level Sht3xRecovery::get_last_level() {
+    return this->last_level;
+}
+
+
+/**
+ * @brief Get the number of successful recoveries
+ *
+ * @return uint16_t number of recoveries
+ */
+uint16_t Sht3xRecovery::get_recoveries() {
+    return this->recoveries;
+}
+
+
+/**
+ * @brief Get the number of recoveries that ran all steps
+ *        without success
+ *
+ * @return uint16_t number of failed recoveries
+ */
+uint16_t Sht3xRecovery::get_failures() {
+    return this->failures;
+}
+
+
+/**
+ * @brief Run one recovery step
+ *
+ * @param level step to run
+ * @return Sht3x::I2C_STATUS SUCCESS if the sensor answers afterwards
+ */
+Sht3x::I2C_STATUS Sht3xRecovery::attempt(Level level) {
+    switch (level) {
+        case Level::RETRY: {
+            Sht3x::I2C_STATUS status = Sht3x::I2C_STATUS::OTHER_ERROR;
+            uint16_t backoff_ms = RECOVERY_FIRST_BACKOFF_MS;
+            for (uint8_t i = 0; i < RECOVERY_MAX_RETRIES && !over_budget(); i++) {
+                delay(backoff_ms);
+                backoff_ms *= 2;
+                status = probe();
+                if (status == Sht3x::I2C_STATUS::SUCCESS) {
+                    break;
+                }
+            }
+            return status;
+        }
+        case Level::SOFT_RESET:
+            this->sensor.soft_reset();
+            break;
+        case Level::GENERAL_CALL_RESET:
+            this->sensor.general_call_reset();
+            break;
+        case Level::BUS_CLEAR:
+            if (this->sda_pin < 0 || this->scl_pin < 0) {
+                return this->last_status;
+            }
+            clear_bus();
+            this->sensor.soft_reset();
+            break;
+        default:
+            break;
+    }
+    delay(RECOVERY_RESET_DURATION_MS);
+    return probe();
+}
+
+
+/**
+ * @brief Check that the sensor answers with a valid status word
+ *
+ * @return Sht3x::I2C_STATUS status of the status register read
+ */
+Sht3x::I2C_STATUS Sht3xRecovery::probe() {
+    Sht3x::DeviceStatus device_status;
+    Sht3x::I2C_STATUS status = this->sensor.read_device_status(device_status);
+    this->sensor_reset = status == Sht3x::I2C_STATUS::SUCCESS && device_status.system_reset;
+    return status;
+}
+
+
+/**
+ * @brief Release a slave that holds SDA low in the middle of
+ *        a byte by clocking SCL, then send a STOP and restart
+ *        the bus. Refer to the I2C specification UM10204
+ *        section 3.1.16 bus clear
+ */
+void Sht3xRecovery::clear_bus() {
+    SHT3X_LOG_INFO("Clearing the bus");
+    pinMode(this->sda_pin, INPUT_PULLUP);
+    pinMode(this->scl_pin, INPUT_PULLUP);
+
+    for (uint8_t i = 0; i < RECOVERY_SCL_PULSES && digitalRead(this->sda_pin) == LOW; i++) {
+        /*Open drain, pull low as output and release as input*/
+        pinMode(this->scl_pin, OUTPUT);
+        digitalWrite(this->scl_pin, LOW);
+        delayMicroseconds(RECOVERY_SCL_HALF_PERIOD_US);
+        pinMode(this->scl_pin, INPUT_PULLUP);
+        delayMicroseconds(RECOVERY_SCL_HALF_PERIOD_US);
+    }
+
+    /*STOP, SDA rising while SCL is high*/
+    pinMode(this->scl_pin, OUTPUT);
+    digitalWrite(this->scl_pin, LOW);
+    pinMode(this->sda_pin, OUTPUT);
+    digitalWrite(this->sda_pin, LOW);
+    delayMicroseconds(RECOVERY_SCL_HALF_PERIOD_US);
+    pinMode(this->scl_pin, INPUT_PULLUP);
+    delayMicroseconds(RECOVERY_SCL_HALF_PERIOD_US);
+    pinMode(this->sda_pin, INPUT_PULLUP);
+    delayMicroseconds(RECOVERY_SCL_HALF_PERIOD_US);
+
+    this->sensor.restart_bus();
+}
+
+
+/**
+ * @brief Put the sensor back into the mode and heater state
+ *        saved before the recovery
+ *
+ * @return Sht3x::I2C_STATUS status of the last command
+ */
+Sht3x::I2C_STATUS Sht3xRecovery::restore() {
+    Sht3x::I2C_STATUS status = Sht3x::I2C_STATUS::SUCCESS;
+    if (this->sensor_reset) {
+        /*Clear the flag so the next reset shows, the sensor may
+          have been reset behind the back of the driver*/
+        status = this->sensor.clear_status_register();
+        if (status != Sht3x::I2C_STATUS::SUCCESS) {
+            return status;
+        }
+        this->sensor.mark_reset();
+    }
+    if (this->heater_on != this->sensor.is_heater_on()) {
+        status = this->heater_on ? this->sensor.enable_heater() : this->sensor.disable_heater();
+    }
+    if (status != Sht3x::I2C_STATUS::SUCCESS
+        || this->mode == this->sensor.get_acquisition_mode()) {
+        return status;
+    }
+
+    /*A sensor that missed the reset may still be measuring, it
+      ignores the new mode until a break has stopped it*/
+    status = this->sensor.send_break_command();
+    if (status != Sht3x::I2C_STATUS::SUCCESS
+        || this->mode == Sht3x::AcquisitionMode::SINGLE_SHOT) {
+        return status;
+    }
+    delay(BREAK_CMD_DELAY_MS);
+    if (this->mode == Sht3x::AcquisitionMode::PERIODIC) {
+        return this->sensor.set_periodic_data_acquisition(this->mps, this->repeatability);
+    }
+    return this->sensor.art_4_hz_measurements();
+}
+
+
+/**
+ * @brief Check if the time for the recovery is used up
+ *
+ * @return true no further step should be started
+ */
+bool Sht3xRecovery::over_budget() {
+    return millis() - this->start_ms >= this->budget_ms;
+}
@@ -0,0 +1,116 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_RECOVERY_H
+#define SHT3X_DIS_RECOVERY_H
+#include "sht3x-dis-arduino-lib.h"
+
+#define RECOVERY_MAX_RETRIES            3
+#define RECOVERY_FIRST_BACKOFF_MS       1
+#define RECOVERY_RESET_DURATION_MS      2   /*datasheet table 4, 1.5ms max after a reset*/
+#define RECOVERY_DEFAULT_BUDGET_MS      50
+#define RECOVERY_FIRST_HOLDOFF_MS       100
+#define RECOVERY_MAX_HOLDOFF_MS         10000
+#define RECOVERY_SCL_PULSES             9
+#define RECOVERY_SCL_HALF_PERIOD_US     5   /*100kHz*/
+
+
+/**
+ * @brief Brings a sensor back after a bus fault with escalating
+ *        steps, and restores the mode and heater state it was
+ *        configured for.
+ *
+ *        Each step ends with a status register read to check
+ *        if the sensor answers again:
+ *        1. retry with a backoff doubling from 1ms
+ *        2. soft reset of the sensor
+ *        3. general call reset, which resets every device on
+ *           the bus that supports it. Skipped after
+ *           set_shared_bus(true), as the drivers of the other
+ *           sensors would still expect their periodic mode
+ *           and heater state.
+ *        4. clock out SCL until a slave holding SDA low lets
+ *           go, send a STOP and restart the bus, followed by
+ *           a soft reset. Only when the pins were given.
+ *
+ *        A recovery never takes much longer than its budget.
+ *        After a failed recovery the next attempts are refused
+ *        for a holdoff time doubling up to 10s, so one dead
+ *        sensor does not stall the bus for the others.
+ *        A sensor that reports a reset in its status register
+ *        is configured again even when a retry was enough, and
+ *        its status register is cleared. Alert limits are back
+ *        at their defaults after a reset and have to be written
+ *        again.
+ */
+class Sht3xRecovery {
+    public:
+        enum class Level {
+            NONE,
+            RETRY,
+            SOFT_RESET,
+            GENERAL_CALL_RESET,
+            BUS_CLEAR
+        };
+
+        Sht3xRecovery(Sht3x &sensor, int8_t sda_pin = -1, int8_t scl_pin = -1,
+            uint16_t budget_ms = RECOVERY_DEFAULT_BUDGET_MS);
+        ~Sht3xRecovery() = default;
+        Sht3x::I2C_STATUS recover();
+        void set_shared_bus(bool shared);
+        Level get_last_level();
+        uint16_t get_recoveries();
+        uint16_t get_failures();
+
+    private:
+        Sht3x &sensor;
+        int8_t sda_pin;
+        int8_t scl_pin;
+        uint16_t budget_ms;
+        bool shared_bus = false;
+        uint32_t start_ms = 0;
+        uint32_t failed_at_ms = 0;
+        uint16_t holdoff_ms = 0;
+        Level last_level = Level::NONE;
+        uint16_t recoveries = 0;
+        uint16_t failures = 0;
+        Sht3x::I2C_STATUS last_status = Sht3x::I2C_STATUS::SUCCESS;
+        bool sensor_reset = false;      /*reset flag seen by the last probe*/
+        /*Configuration to restore, saved before the first reset*/
+        bool restore_pending = false;
+        Sht3x::AcquisitionMode mode = Sht3x::AcquisitionMode::SINGLE_SHOT;
+        Mps mps = Mps::MPS_1;
+        Repeatability repeatability = Repeatability::HIGH_REPEATABILITY;
+        bool heater_on = false;
+
+        Sht3x::I2C_STATUS attempt(Level level);
+        Sht3x::I2C_STATUS probe();
+        void clear_bus();
+        Sht3x::I2C_STATUS restore();
+        bool over_budget();
+};
+
+#endif
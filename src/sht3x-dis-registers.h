@@ -68,15 +68,72 @@ SOFTWARE.
 #define CLK_STRECH_DIS_LOW_REPEAT_LSB   0x16
 
 
-struct MeasurementModesSingleShot {
-    uint8_t MODE1[2] = {CLK_STRECH_EN_MSB,CLK_STRECH_EN_HIGH_REPEAT_LSB};
-    uint8_t MODE2[2] = {CLK_STRECH_EN_MSB,CLK_STRECH_EN_MID_REPEAT_LSB};
-    uint8_t MODE3[2] = {CLK_STRECH_EN_MSB,CLK_STRECH_EN_LOW_REPEAT_LSB};
-    uint8_t MODE4[2] = {CLK_STRECH_DIS_MSB,CLK_STRECH_DIS_HIGH_REPEAT_LSB};
-    uint8_t MODE5[2] = {CLK_STRECH_DIS_MSB,CLK_STRECH_DIS_MID_REPEAT_LSB};
-    uint8_t MODE6[2] = {CLK_STRECH_DIS_MSB,CLK_STRECH_DIS_LOW_REPEAT_LSB};
+/*Maximum measurement duration for each repeatability
+  Refer to datasheet table 4 page 7*/
+#define HIGH_REPEAT_MEASUREMENT_DURATION_US   15500
+#define MID_REPEAT_MEASUREMENT_DURATION_US    6500
+#define LOW_REPEAT_MEASUREMENT_DURATION_US    4500
+
+
+/*Repeatability of a measurement, in the order of the table rows*/
+enum class Repeatability : uint8_t {
+    HIGH_REPEATABILITY,
+    MEDIUM_REPEATABILITY,
+    LOW_REPEATABILITY
 };
 
+/*Clock stretching of a single shot measurement*/
+enum class ClockStretching : uint8_t {
+    STRETCHING_ENABLED,
+    STRETCHING_DISABLED
+};
+
+
+/**
+ * @brief Single shot measurement command word
+ *
+ * @param repeatability repeatability of the measurement
+ * @param clock_stretching clock stretching selection
+ * @return constexpr uint16_t command, MSB first on the bus
+ */
+constexpr uint16_t sht3x_single_shot_command(Repeatability repeatability,
+    ClockStretching clock_stretching) {
+    return clock_stretching == ClockStretching::STRETCHING_ENABLED
+        ? (CLK_STRECH_EN_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? CLK_STRECH_EN_HIGH_REPEAT_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? CLK_STRECH_EN_MID_REPEAT_LSB
+            : CLK_STRECH_EN_LOW_REPEAT_LSB)
+        : (CLK_STRECH_DIS_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? CLK_STRECH_DIS_HIGH_REPEAT_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? CLK_STRECH_DIS_MID_REPEAT_LSB
+            : CLK_STRECH_DIS_LOW_REPEAT_LSB);
+}
+
+
+/**
+ * @brief Maximum measurement duration for a repeatability
+ *
+ * @param repeatability repeatability of the measurement
+ * @return constexpr uint32_t duration in us
+ */
+constexpr uint32_t sht3x_measurement_duration_us(Repeatability repeatability) {
+    return repeatability == Repeatability::HIGH_REPEATABILITY ? HIGH_REPEAT_MEASUREMENT_DURATION_US
+        : repeatability == Repeatability::MEDIUM_REPEATABILITY ? MID_REPEAT_MEASUREMENT_DURATION_US
+        : LOW_REPEAT_MEASUREMENT_DURATION_US;
+}
+
+/*Every command against the codes of datasheet table 8*/
+#define SHT3X_CHECK_SINGLE_SHOT(repeatability, clock_stretching, code) \
+    static_assert(sht3x_single_shot_command(Repeatability::repeatability, \
+        ClockStretching::clock_stretching) == code, "Single shot command table")
+SHT3X_CHECK_SINGLE_SHOT(HIGH_REPEATABILITY, STRETCHING_ENABLED, 0x2C06);
+SHT3X_CHECK_SINGLE_SHOT(MEDIUM_REPEATABILITY, STRETCHING_ENABLED, 0x2C0D);
+SHT3X_CHECK_SINGLE_SHOT(LOW_REPEATABILITY, STRETCHING_ENABLED, 0x2C10);
+SHT3X_CHECK_SINGLE_SHOT(HIGH_REPEATABILITY, STRETCHING_DISABLED, 0x2400);
+SHT3X_CHECK_SINGLE_SHOT(MEDIUM_REPEATABILITY, STRETCHING_DISABLED, 0x240B);
+SHT3X_CHECK_SINGLE_SHOT(LOW_REPEATABILITY, STRETCHING_DISABLED, 0x2416);
+#undef SHT3X_CHECK_SINGLE_SHOT
+
 
 /* Measurement commands for peridoic data acquisition*/
 /**
@@ -126,45 +183,105 @@ struct MeasurementModesSingleShot {
 #define MPS_4_MSB                       0x23
 #define MPS_10_MSB                      0x27
 
-#define MPS_0_5_LOW_LSB                 0x32
+#define MPS_0_5_HIGH_LSB                0x32
 #define MPS_0_5_MID_LSB                 0x24
-#define MPS_0_5_HIGH_LSB                0x2F
+#define MPS_0_5_LOW_LSB                 0x2F
 
-#define MPS_1_LOW_LSB                   0x30
+#define MPS_1_HIGH_LSB                  0x30
 #define MPS_1_MID_LSB                   0x26
-#define MPS_1_HIGH_LSB                  0x2D
+#define MPS_1_LOW_LSB                   0x2D
 
-#define MPS_2_LOW_LSB                   0x36
+#define MPS_2_HIGH_LSB                  0x36
 #define MPS_2_MID_LSB                   0x20
-#define MPS_2_HIGH_LSB                  0x2B
+#define MPS_2_LOW_LSB                   0x2B
 
-#define MPS_4_LOW_LSB                   0x34
+#define MPS_4_HIGH_LSB                  0x34
 #define MPS_4_MID_LSB                   0x22
-#define MPS_4_HIGH_LSB                  0x29
+#define MPS_4_LOW_LSB                   0x29
 
-#define MPS_10_LOW_LSB                  0x37
+#define MPS_10_HIGH_LSB                 0x37
 #define MPS_10_MID_LSB                  0x21
-#define MPS_10_HIGH_LSB                 0x2A
-
-
-struct MeasurementsPerSecondModes {
-    uint8_t MODE1[2]  = {MPS_0_5_MSB,MPS_0_5_LOW_LSB};
-    uint8_t MODE2[2]  = {MPS_0_5_MSB,MPS_0_5_MID_LSB};
-    uint8_t MODE3[2]  = {MPS_0_5_MSB,MPS_0_5_HIGH_LSB};
-    uint8_t MODE4[2]  = {MPS_1_MSB,MPS_1_LOW_LSB};
-    uint8_t MODE5[2]  = {MPS_1_MSB,MPS_1_MID_LSB};
-    uint8_t MODE6[2]  = {MPS_1_MSB,MPS_1_HIGH_LSB};
-    uint8_t MODE7[2]  = {MPS_2_MSB,MPS_2_LOW_LSB};
-    uint8_t MODE8[2]  = {MPS_2_MSB,MPS_2_MID_LSB};
-    uint8_t MODE9[2]  = {MPS_2_MSB,MPS_2_HIGH_LSB};
-    uint8_t MODE10[2] = {MPS_4_MSB,MPS_4_LOW_LSB};
-    uint8_t MODE11[2] = {MPS_4_MSB,MPS_4_MID_LSB};
-    uint8_t MODE12[2] = {MPS_4_MSB,MPS_4_HIGH_LSB};
-    uint8_t MODE13[2] = {MPS_4_MSB,MPS_10_LOW_LSB};
-    uint8_t MODE14[2] = {MPS_4_MSB,MPS_10_MID_LSB};
-    uint8_t MODE15[2] = {MPS_4_MSB,MPS_10_HIGH_LSB};
+#define MPS_10_LOW_LSB                  0x2A
+
+
+/*Measurements per second, in the order of the table rows*/
+enum class Mps : uint8_t {
+    MPS_0_5,
+    MPS_1,
+    MPS_2,
+    MPS_4,
+    MPS_10
 };
 
+
+/**
+ * @brief Periodic data acquisition command word.
+ *        The MSB is selected by the mps alone so a command
+ *        can never mix the MSB of one rate with the LSB of
+ *        another.
+ *
+ * @param mps measurements per second
+ * @param repeatability repeatability of the measurements
+ * @return constexpr uint16_t command, MSB first on the bus
+ */
+constexpr uint16_t sht3x_periodic_command(Mps mps, Repeatability repeatability) {
+    return mps == Mps::MPS_0_5
+        ? (MPS_0_5_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? MPS_0_5_HIGH_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? MPS_0_5_MID_LSB : MPS_0_5_LOW_LSB)
+        : mps == Mps::MPS_1
+        ? (MPS_1_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? MPS_1_HIGH_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? MPS_1_MID_LSB : MPS_1_LOW_LSB)
+        : mps == Mps::MPS_2
+        ? (MPS_2_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? MPS_2_HIGH_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? MPS_2_MID_LSB : MPS_2_LOW_LSB)
+        : mps == Mps::MPS_4
+        ? (MPS_4_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? MPS_4_HIGH_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? MPS_4_MID_LSB : MPS_4_LOW_LSB)
+        : (MPS_10_MSB << 8)
+            | (repeatability == Repeatability::HIGH_REPEATABILITY ? MPS_10_HIGH_LSB
+            : repeatability == Repeatability::MEDIUM_REPEATABILITY ? MPS_10_MID_LSB : MPS_10_LOW_LSB);
+}
+
+/**
+ * @brief Time between two measurements in periodic data
+ *        acquisition mode
+ *
+ * @param mps measurements per second
+ * @return constexpr uint32_t nominal period in ms
+ */
+constexpr uint32_t sht3x_period_ms(Mps mps) {
+    return mps == Mps::MPS_0_5 ? 2000
+        : mps == Mps::MPS_1 ? 1000
+        : mps == Mps::MPS_2 ? 500
+        : mps == Mps::MPS_4 ? 250
+        : 100;
+}
+
+/*Every command against the codes of datasheet table 9*/
+#define SHT3X_CHECK_PERIODIC(mps, repeatability, code) \
+    static_assert(sht3x_periodic_command(Mps::mps, Repeatability::repeatability) == code, \
+        "Periodic command table")
+SHT3X_CHECK_PERIODIC(MPS_0_5, HIGH_REPEATABILITY, 0x2032);
+SHT3X_CHECK_PERIODIC(MPS_0_5, MEDIUM_REPEATABILITY, 0x2024);
+SHT3X_CHECK_PERIODIC(MPS_0_5, LOW_REPEATABILITY, 0x202F);
+SHT3X_CHECK_PERIODIC(MPS_1, HIGH_REPEATABILITY, 0x2130);
+SHT3X_CHECK_PERIODIC(MPS_1, MEDIUM_REPEATABILITY, 0x2126);
+SHT3X_CHECK_PERIODIC(MPS_1, LOW_REPEATABILITY, 0x212D);
+SHT3X_CHECK_PERIODIC(MPS_2, HIGH_REPEATABILITY, 0x2236);
+SHT3X_CHECK_PERIODIC(MPS_2, MEDIUM_REPEATABILITY, 0x2220);
+SHT3X_CHECK_PERIODIC(MPS_2, LOW_REPEATABILITY, 0x222B);
+SHT3X_CHECK_PERIODIC(MPS_4, HIGH_REPEATABILITY, 0x2334);
+SHT3X_CHECK_PERIODIC(MPS_4, MEDIUM_REPEATABILITY, 0x2322);
+SHT3X_CHECK_PERIODIC(MPS_4, LOW_REPEATABILITY, 0x2329);
+SHT3X_CHECK_PERIODIC(MPS_10, HIGH_REPEATABILITY, 0x2737);
+SHT3X_CHECK_PERIODIC(MPS_10, MEDIUM_REPEATABILITY, 0x2721);
+SHT3X_CHECK_PERIODIC(MPS_10, LOW_REPEATABILITY, 0x272A);
+#undef SHT3X_CHECK_PERIODIC
+
 /*readout of measurement results*/
 #define FETCH_DATA_LSB                  0x00
 #define FETCH_DATA_MSB                  0xE0
@@ -173,11 +290,14 @@ struct MeasurementsPerSecondModes {
 /*ART - Accelerated Response Time command*/
 #define ART_4HZ_MSB                     0x2B
 #define ART_4HZ_LSB                     0x32
+#define ART_PERIOD_MS                   250
 
 
-/*Break command*/
+/*Break command, the sensor takes up to 1 ms to stop the
+  periodic acquisition and ignores commands meanwhile*/
 #define BREAK_CMD_MSB                   0x30
 #define BREAK_CMD_LSB                   0x93
+#define BREAK_CMD_DELAY_MS              1
 
 
 /*Soft reset command*/
@@ -205,4 +325,30 @@ struct MeasurementsPerSecondModes {
 #define CLEAR_STATUS_REGISTER_MSB       0x30
 #define CLEAR_STATUS_REGISTER_LSB       0x41
 
+
+/*Alert limits
+  Refer to the Sensirion application note SHT3x-DIS alert mode
+  Each limit packs the 7 MSBs of rh and the 9 MSBs of temperature*/
+#define READ_ALERT_LIMIT_MSB            0xE1
+#define READ_ALERT_HIGH_SET_LSB         0x1F
+#define READ_ALERT_HIGH_CLEAR_LSB       0x14
+#define READ_ALERT_LOW_CLEAR_LSB        0x09
+#define READ_ALERT_LOW_SET_LSB          0x02
+
+#define WRITE_ALERT_LIMIT_MSB           0x61
+#define WRITE_ALERT_HIGH_SET_LSB        0x1D
+#define WRITE_ALERT_HIGH_CLEAR_LSB      0x16
+#define WRITE_ALERT_LOW_CLEAR_LSB       0x0B
+#define WRITE_ALERT_LOW_SET_LSB         0x00
+
+
+/*Status register bits*/
+#define STATUS_ALERT_PENDING_BIT        15
+#define STATUS_HEATER_BIT               13
+#define STATUS_RH_ALERT_BIT             11
+#define STATUS_T_ALERT_BIT              10
+#define STATUS_SYSTEM_RESET_BIT         4
+#define STATUS_COMMAND_FAILED_BIT       1
+#define STATUS_WRITE_CRC_FAILED_BIT     0
+
 #endif
@@ -0,0 +1,247 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-repeatability.h"
+
+/*Repeatability per Repeatability value, datasheet table 1 and 2*/
+static const uint8_t TEMPERATURE_REPEATABILITY_CENTI[3] = {4, 8, 15};
+static const uint8_t RH_REPEATABILITY_CENTI[3] = {8, 15, 21};
+
+
+/**
+ * @brief Square of a difference of two raw words, limited to
+ *        SELECTOR_MAX_DIFFERENCE
+ */
+static inline uint32_t squared_difference(uint16_t a, uint16_t b) {
+    uint16_t difference = a > b ? a - b : b - a;
+    if (difference > SELECTOR_MAX_DIFFERENCE) {
+        difference = SELECTOR_MAX_DIFFERENCE;
+    }
+    return (uint32_t)difference * difference;
+}
+
+
+/**
+ * @brief Construct a new Sht3xRepeatabilitySelector object
+ *
+ * @param sensor sensor to select the repeatability for
+ * @param temperature_noise_centi highest acceptable standard
+ *        deviation of the temperature in 0.01 C
+ * @param rh_noise_centi highest acceptable standard deviation
+ *        of the rh in 0.01 %
+ */
+Sht3xRepeatabilitySelector::Sht3xRepeatabilitySelector(Sht3x &sensor,
+    uint16_t temperature_noise_centi, uint16_t rh_noise_centi):
+    sensor{sensor},
+    temperature_target_raw{(uint32_t)((temperature_noise_centi * 65535UL + 8750UL) / 17500UL)},
+    rh_target_raw{(uint32_t)((rh_noise_centi * 65535UL + 5000UL) / 10000UL)} {
+}
+
+
+/**
+ * @brief Single shot measurement with the selected repeatability
+ *
+ * @return Sht3x::I2C_STATUS status of the measurement
+ */
+Sht3x::I2C_STATUS Sht3xRepeatabilitySelector::measure() {
+    Sht3x::I2C_STATUS status = this->sensor.perform_single_shot_measurement(this->repeatability,
+        ClockStretching::STRETCHING_DISABLED);
+    if (status == Sht3x::I2C_STATUS::SUCCESS) {
+        update();
+    }
+    return status;
+}
+
+
+/**
+ * @brief Start the periodic data acquisition with the selected
+ *        repeatability and a new noise window. A periodic or
+ *        ART acquisition that runs already is stopped first.
+ *
+ * @param mps measurements per second
+ * @return Sht3x::I2C_STATUS status of the mode change
+ */
+Sht3x::I2C_STATUS Sht3xRepeatabilitySelector::start(Mps mps) {
+    this->has_previous = false;
+    this->count = 0;
+    this->temperature_sum = 0;
+    this->rh_sum = 0;
+    return start_periodic(mps);
+}
+
+
+/**
+ * @brief Fetch the latest periodic measurement. A new
+ *        repeatability is applied by restarting the periodic
+ *        data acquisition at the same rate.
+ *
+ * @return Sht3x::I2C_STATUS status of the fetch, or of the
+ *         mode change when it failed
+ */
+Sht3x::I2C_STATUS Sht3xRepeatabilitySelector::fetch() {
+    Sht3x::I2C_STATUS status = this->sensor.fetch_data();
+    if (status != Sht3x::I2C_STATUS::SUCCESS || !update()
+        || this->sensor.get_acquisition_mode() != Sht3x::AcquisitionMode::PERIODIC) {
+        return status;
+    }
+
+    return start_periodic(this->sensor.get_mps());
+}
+
+
+/**
+ * @brief Add the last reading of the sensor to the noise
+ *        estimate. Call after every reading when the sensor
+ *        is not read through measure() or fetch().
+ *
+ * @return true a different repeatability was selected
+ */
+bool Sht3xRepeatabilitySelector::update() {
+    uint16_t temperature_raw = this->sensor.get_temperature_raw();
+    uint16_t rh_raw = this->sensor.get_rh_raw();
+
+    if (this->has_previous) {
+        this->temperature_sum += squared_difference(temperature_raw, this->previous_temperature_raw);
+        this->rh_sum += squared_difference(rh_raw, this->previous_rh_raw);
+        this->count++;
+    }
+    this->has_previous = true;
+    this->previous_temperature_raw = temperature_raw;
+    this->previous_rh_raw = rh_raw;
+
+    if (this->count < SELECTOR_WINDOW) {
+        return false;
+    }
+    return evaluate();
+}
+
+
+/**
+ * @brief Get the repeatability to measure with
+ *
+ * @return Repeatability selected repeatability
+ */
+Repeatability Sht3xRepeatabilitySelector::get_repeatability() {
+    return this->repeatability;
+}
+
+
+/**
+ * @brief Get the temperature noise of the last window
+ *
+ * @return float standard deviation in C
+ */
+float Sht3xRepeatabilitySelector::get_temperature_noise() {
+    return this->temperature_noise_raw * 175.0f / 65535.0f;
+}
+
+
+/**
+ * @brief Get the rh noise of the last window
+ *
+ * @return float standard deviation in %
+ */
+float Sht3xRepeatabilitySelector::get_rh_noise() {
+    return this->rh_noise_raw * 100.0f / 65535.0f;
+}
+
+
+/**
+ * @brief Compare the noise of the finished window to the
+ *        target and select the repeatability for the next one
+ *
+ * @return true a different repeatability was selected
+ */
+bool Sht3xRepeatabilitySelector::evaluate() {
+    this->temperature_noise_raw = sqrtf(this->temperature_sum / (2.0f * this->count));
+    this->rh_noise_raw = sqrtf(this->rh_sum / (2.0f * this->count));
+    this->temperature_sum = 0;
+    this->rh_sum = 0;
+    this->count = 0;
+
+    uint8_t current = static_cast<uint8_t>(this->repeatability);
+    if (this->temperature_noise_raw > this->temperature_target_raw
+        || this->rh_noise_raw > this->rh_target_raw) {
+        this->holdoff = SELECTOR_REEVALUATE_WINDOWS;
+        if (this->repeatability == Repeatability::HIGH_REPEATABILITY) {
+            return false;
+        }
+        select(static_cast<Repeatability>(current - 1));
+        return true;
+    }
+
+    if (this->holdoff > 0) {
+        this->holdoff--;
+        return false;
+    }
+    if (this->repeatability == Repeatability::LOW_REPEATABILITY) {
+        return false;
+    }
+
+    float temperature_expected = this->temperature_noise_raw
+        * TEMPERATURE_REPEATABILITY_CENTI[current + 1] / TEMPERATURE_REPEATABILITY_CENTI[current];
+    float rh_expected = this->rh_noise_raw
+        * RH_REPEATABILITY_CENTI[current + 1] / RH_REPEATABILITY_CENTI[current];
+    if (temperature_expected > this->temperature_target_raw || rh_expected > this->rh_target_raw) {
+        return false;
+    }
+    select(static_cast<Repeatability>(current + 1));
+    return true;
+}
+
+
+/**
+ * @brief Switch to another repeatability and start a new window
+ *
+ * @param repeatability new repeatability
+ */
+void Sht3xRepeatabilitySelector::select(Repeatability repeatability) {
+    SHT3X_LOG_INFO("Repeatability changed");
+    this->repeatability = repeatability;
+    /*The first difference would span both repeatabilities*/
+    this->has_previous = false;
+}
+
+
+/**
+ * @brief Stop a running acquisition and start the periodic one
+ *        with the selected repeatability. The sensor ignores
+ *        commands for up to 1 ms after the break.
+ *
+ * @param mps measurements per second
+ * @return Sht3x::I2C_STATUS status of the last command
+ */
+Sht3x::I2C_STATUS Sht3xRepeatabilitySelector::start_periodic(Mps mps) {
+    Sht3x::AcquisitionMode mode = this->sensor.get_acquisition_mode();
+    if (mode == Sht3x::AcquisitionMode::PERIODIC || mode == Sht3x::AcquisitionMode::ART) {
+        Sht3x::I2C_STATUS status = this->sensor.send_break_command();
+        if (status != Sht3x::I2C_STATUS::SUCCESS) {
+            return status;
+        }
+        delay(BREAK_CMD_DELAY_MS);
+    }
+    return this->sensor.set_periodic_data_acquisition(mps, this->repeatability);
+}
@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_REPEATABILITY_H
+#define SHT3X_DIS_REPEATABILITY_H
+#include "sht3x-dis-arduino-lib.h"
+
+#define SELECTOR_WINDOW                 32  /*differences per noise estimate*/
+#define SELECTOR_REEVALUATE_WINDOWS     16  /*windows before a lower repeatability is tried again*/
+#define SELECTOR_MAX_DIFFERENCE         1023 /*raw, limits the effect of a step in the signal*/
+
+
+/**
+ * @brief Selects the lowest repeatability whose noise meets a
+ *        target, to save conversion time and energy.
+ *
+ *        The noise is estimated from the differences of
+ *        successive readings, sigma^2 = mean(d^2) / 2, which
+ *        ignores slow changes of the signal. After each window
+ *        of SELECTOR_WINDOW differences the noise is compared
+ *        to the target. Too much noise selects the next higher
+ *        repeatability. When the noise expected at the next
+ *        lower repeatability, scaled by the repeatability
+ *        figures of datasheet table 1 and 2, still meets the
+ *        target, the lower one is selected. After a step up a
+ *        lower repeatability is only tried again after
+ *        SELECTOR_REEVALUATE_WINDOWS windows.
+ *
+ *        measure() sends the repeatability with every single
+ *        shot. In periodic mode start the acquisition with
+ *        start(), so the sensor runs at the repeatability the
+ *        selector assumes, and read it with fetch().
+ */
+class Sht3xRepeatabilitySelector {
+    public:
+        Sht3xRepeatabilitySelector(Sht3x &sensor, uint16_t temperature_noise_centi,
+            uint16_t rh_noise_centi);
+        ~Sht3xRepeatabilitySelector() = default;
+        Sht3x::I2C_STATUS measure();
+        Sht3x::I2C_STATUS start(Mps mps);
+        Sht3x::I2C_STATUS fetch();
+        bool update();
+        Repeatability get_repeatability();
+        float get_temperature_noise();
+        float get_rh_noise();
+
+    private:
+        Sht3x &sensor;
+        uint32_t temperature_target_raw;
+        uint32_t rh_target_raw;
+        Repeatability repeatability = Repeatability::HIGH_REPEATABILITY;
+        bool has_previous = false;
+        uint16_t previous_temperature_raw = 0;
+        uint16_t previous_rh_raw = 0;
+        uint8_t count = 0;
+        uint32_t temperature_sum = 0;   /*sum of squared differences*/
+        uint32_t rh_sum = 0;
+        float temperature_noise_raw = 0.0f;
+        float rh_noise_raw = 0.0f;
+        uint8_t holdoff = 0;
+
+        bool evaluate();
+        void select(Repeatability repeatability);
+        Sht3x::I2C_STATUS start_periodic(Mps mps);
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_RING_BUFFER_H
+#define SHT3X_DIS_RING_BUFFER_H
+#include "sht3x-dis-arduino-lib.h"
+#if defined(__AVR__)
+#include <util/atomic.h>
+#endif
+
+
+/*Raw reading with the time it was fetched*/
+struct Sht3xSample {
+    uint32_t timestamp_ms;
+    uint16_t temperature_raw;
+    uint16_t rh_raw;
+};
+
+
+/**
+ * @brief Fixed capacity single producer single consumer queue
+ *        of samples for periodic data acquisition.
+ *
+ *        One context fetches with fetch() or adds samples with
+ *        push(), and one other context (loop()) drains with
+ *        pop(). fetch() uses Wire, so its producer must be an
+ *        RTOS task or a thread, not an interrupt handler or a
+ *        timer callback running in one. push() does not touch
+ *        the bus and can also be called from an interrupt.
+ *        Neither side blocks or allocates.
+ *        The head index is only written by the producer and the
+ *        tail index only by the consumer, each with release
+ *        ordering, so no lock or interrupt masking is needed.
+ *        The indices are single bytes so loads and stores are
+ *        atomic on 8 bit targets too. The 16 bit overrun count
+ *        is read with interrupts masked on AVR.
+ *
+ * @tparam CAPACITY number of samples, a power of two up to 128
+ */
+template <uint8_t CAPACITY>
+class Sht3xSampleRing {
+    static_assert(CAPACITY > 0 && CAPACITY <= 128 && (CAPACITY & (CAPACITY - 1)) == 0,
+        "Capacity must be a power of two up to 128");
+
+    public:
+        /**
+         * @brief Add a sample. Producer side only.
+         *
+         * @param sample sample to add
+         * @return true if added, false if the buffer was full
+         */
+        bool push(const Sht3xSample &sample) {
+            uint8_t head = __atomic_load_n(&this->head, __ATOMIC_RELAXED);
+            uint8_t tail = __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE);
+            if ((uint8_t)(head - tail) == CAPACITY) {
+#if defined(__AVR__)
+                this->overruns++;
+#else
+                __atomic_store_n(&this->overruns, (uint16_t)(this->overruns + 1), __ATOMIC_RELAXED);
+#endif
+                return false;
+            }
+            this->samples[head & (CAPACITY - 1)] = sample;
+            __atomic_store_n(&this->head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+            return true;
+        }
+
+
+        /**
+         * @brief Fetch the latest periodic measurement from the
+         *        sensor and add it with the current time.
+         *        Producer side only.
+         *
+         * @param sensor sensor in periodic or ART mode
+         * @return Sht3x::I2C_STATUS status of the fetch
+         */
+        Sht3x::I2C_STATUS fetch(Sht3x &sensor) {
+            Sht3x::I2C_STATUS status = sensor.fetch_data();
+            if (status == Sht3x::I2C_STATUS::SUCCESS) {
+                Sht3xSample sample = {(uint32_t)millis(), sensor.get_temperature_raw(), sensor.get_rh_raw()};
+                push(sample);
+            }
+            return status;
+        }
+
+
+        /**
+         * @brief Remove up to max_count samples, oldest first.
+         *        Consumer side only.
+         *
+         * @param samples array to copy the samples to
+         * @param max_count size of the array
+         * @return uint8_t number of samples copied
+         */
+        uint8_t pop(Sht3xSample *samples, uint8_t max_count) {
+            uint8_t tail = __atomic_load_n(&this->tail, __ATOMIC_RELAXED);
+            uint8_t head = __atomic_load_n(&this->head, __ATOMIC_ACQUIRE);
+            uint8_t count = head - tail;
+            if (count > max_count) {
+                count = max_count;
+            }
+            for (uint8_t i = 0; i < count; i++) {
+                samples[i] = this->samples[(uint8_t)(tail + i) & (CAPACITY - 1)];
+            }
+            __atomic_store_n(&this->tail, (uint8_t)(tail + count), __ATOMIC_RELEASE);
+            return count;
+        }
+
+
+        /**
+         * @brief Number of samples waiting to be popped
+         */
+        uint8_t size() const {
+            return (uint8_t)(__atomic_load_n(&this->head, __ATOMIC_ACQUIRE)
+                - __atomic_load_n(&this->tail, __ATOMIC_ACQUIRE));
+        }
+
+
+        /**
+         * @brief Number of samples dropped because the buffer was full.
+         *        On AVR the two bytes are read with interrupts
+         *        masked, so a push() from an interrupt cannot
+         *        change the count half way through the read.
+         */
+        uint16_t get_overruns() const {
+#if defined(__AVR__)
+            uint16_t overruns;
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                overruns = this->overruns;
+            }
+            return overruns;
+#else
+            return __atomic_load_n(&this->overruns, __ATOMIC_RELAXED);
+#endif
+        }
+
+    private:
+        Sht3xSample samples[CAPACITY];
+        uint8_t head = 0;
+        uint8_t tail = 0;
+        uint16_t overruns = 0;
+};
+
+#endif
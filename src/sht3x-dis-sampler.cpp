@@ -0,0 +1,308 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-sampler.h"
+
+#if !defined(__AVR__)
+
+/**
+ * @brief Replace the snapshot. Only one context may publish.
+ *        The values are stored with release, so a reader that
+ *        loads one of them also sees the odd sequence number
+ *        stored before. No fences are used, ThreadSanitizer
+ *        does not model them.
+ *
+ * @param snapshot new snapshot
+ */
+void Sht3xSnapshotCell::publish(const Sht3xSnapshot &snapshot) {
+    uint32_t sequence = __atomic_load_n(&this->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&this->sequence, sequence + 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&this->raw, ((uint32_t)snapshot.temperature_raw << 16) | snapshot.rh_raw,
+        __ATOMIC_RELEASE);
+    __atomic_store_n(&this->timestamp_ms, snapshot.timestamp_ms, __ATOMIC_RELEASE);
+    __atomic_store_n(&this->status, (uint8_t)snapshot.status, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&this->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Copy the latest snapshot. Never blocks the writer,
+ *        retries while a publish is in progress. The values
+ *        are loaded with acquire, so the second load of the
+ *        sequence number cannot move before them.
+ *
+ * @param snapshot copy of the latest snapshot
+ * @return true a snapshot has been published
+ * @return false nothing has been published yet
+ */
+bool Sht3xSnapshotCell::read(Sht3xSnapshot &snapshot) const {
+    uint32_t before;
+    uint32_t raw;
+    uint32_t timestamp_ms;
+    uint8_t status;
+    do {
+        before = __atomic_load_n(&this->sequence, __ATOMIC_ACQUIRE);
+        raw = __atomic_load_n(&this->raw, __ATOMIC_ACQUIRE);
+        timestamp_ms = __atomic_load_n(&this->timestamp_ms, __ATOMIC_ACQUIRE);
+        status = __atomic_load_n(&this->status, __ATOMIC_ACQUIRE);
+    } while ((before & 1) != 0 || before != __atomic_load_n(&this->sequence, __ATOMIC_RELAXED));
+
+    snapshot.temperature_raw = (uint16_t)(raw >> 16);
+    snapshot.rh_raw = (uint16_t)raw;
+    snapshot.timestamp_ms = timestamp_ms;
+    snapshot.status = static_cast<Sht3x::I2C_STATUS>(status);
+    return before != 0;
+}
+
+
+#if defined(SHT3X_EXECUTOR_FREERTOS)
+/**
+ * @brief Construct a new Sht3xFreeRtosExecutor object
+ *
+ * @param stack_size stack size of the task in bytes
+ * @param priority priority of the task
+ */
+Sht3xFreeRtosExecutor::Sht3xFreeRtosExecutor(uint32_t stack_size, UBaseType_t priority):
+    stack_size{stack_size}, priority{priority} {
+}
+
+
+Sht3xFreeRtosExecutor::~Sht3xFreeRtosExecutor() {
+    if (this->done != nullptr) {
+        vSemaphoreDelete(this->done);
+    }
+}
+
+
+/**
+ * @brief Start the task
+ *
+ * @param task function run by the task
+ * @param argument argument of the function
+ * @return true the task was created
+ */
+bool Sht3xFreeRtosExecutor::spawn(void (*task)(void *), void *argument) {
+    if (this->done == nullptr) {
+        this->done = xSemaphoreCreateBinary();
+    }
+    this->task = task;
+    this->argument = argument;
+    return this->done != nullptr
+        && xTaskCreate(trampoline, "sht3x", this->stack_size, this, this->priority, nullptr) == pdPASS;
+}
+
+
+/**
+ * @brief Wait until the function of the task has returned
+ */
+void Sht3xFreeRtosExecutor::join() {
+    xSemaphoreTake(this->done, portMAX_DELAY);
+}
+
+
+/**
+ * @brief Let other tasks run
+ *
+ * @param ms time to sleep
+ */
+void Sht3xFreeRtosExecutor::sleep_ms(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms) == 0 ? 1 : pdMS_TO_TICKS(ms));
+}
+
+
+/**
+ * @brief Run the function, signal join() and delete the task.
+ *        A FreeRTOS task must not return.
+ */
+void Sht3xFreeRtosExecutor::trampoline(void *executor) {
+    Sht3xFreeRtosExecutor *self = static_cast<Sht3xFreeRtosExecutor *>(executor);
+    self->task(self->argument);
+    xSemaphoreGive(self->done);
+    vTaskDelete(nullptr);
+}
+#elif defined(SHT3X_EXECUTOR_THREAD)
+/**
+ * @brief Start the thread
+ *
+ * @param task function run by the thread
+ * @param argument argument of the function
+ * @return true the thread was created
+ */
+bool Sht3xThreadExecutor::spawn(void (*task)(void *), void *argument) {
+    this->thread = std::thread(task, argument);
+    return true;
+}
+
+
+/**
+ * @brief Wait until the thread has finished
+ */
+void Sht3xThreadExecutor::join() {
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+
+/**
+ * @brief Let other threads run
+ *
+ * @param ms time to sleep
+ */
+void Sht3xThreadExecutor::sleep_ms(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+#endif
+
+
+/**
+ * @brief Construct a new Sht3xSampler object
+ *
+ * @param sensor sensor owned by the sampler while it runs
+ * @param executor runs the sampling loop in the background
+ */
+Sht3xSampler::Sht3xSampler(Sht3x &sensor, Sht3xExecutor &executor):
+    sensor{sensor}, executor{executor}, scheduler{sensor} {
+}
+
+
+/**
+ * @brief Start the periodic data acquisition and the
+ *        background sampling
+ *
+ * @param mps measurements per second
+ * @param repeatability repeatability of the measurements
+ * @return true the sampler was started
+ */
+bool Sht3xSampler::start(Mps mps, Repeatability repeatability) {
+    if (this->started) {
+        if (is_running()) {
+            return false;
+        }
+        /*The task ended on its own after an error*/
+        this->executor.join();
+        this->started = false;
+    }
+    this->mps = mps;
+    this->repeatability = repeatability;
+    __atomic_store_n(&this->running, true, __ATOMIC_RELEASE);
+    if (!this->executor.spawn(task, this)) {
+        __atomic_store_n(&this->running, false, __ATOMIC_RELEASE);
+        return false;
+    }
+    this->started = true;
+    return true;
+}
+
+
+/**
+ * @brief Stop the sampling, end the periodic data acquisition
+ *        and wait for the background task to finish
+ */
+void Sht3xSampler::stop() {
+    if (!this->started) {
+        return;
+    }
+    __atomic_store_n(&this->running, false, __ATOMIC_RELEASE);
+    this->executor.join();
+    this->started = false;
+}
+
+
+/**
+ * @brief Get the latest reading. Safe from any task and never
+ *        blocks the sampler.
+ *
+ * @param snapshot copy of the latest reading
+ * @return true a reading has been published
+ */
+bool Sht3xSampler::read(Sht3xSnapshot &snapshot) const {
+    return this->cell.read(snapshot);
+}
+
+
+/**
+ * @brief Check if the background sampling runs
+ */
+bool Sht3xSampler::is_running() const {
+    return __atomic_load_n(&this->running, __ATOMIC_ACQUIRE);
+}
+
+
+void Sht3xSampler::task(void *sampler) {
+    static_cast<Sht3xSampler *>(sampler)->run();
+}
+
+
+/**
+ * @brief Sampling loop of the background task. Sleeps until
+ *        the next sample is due and publishes every new one.
+ *        A running acquisition is stopped first, the sensor
+ *        ignores a mode command in periodic mode.
+ */
+void Sht3xSampler::run() {
+    Sht3xSnapshot snapshot = {0, 0, 0, Sht3x::I2C_STATUS::SUCCESS};
+    Sht3x::AcquisitionMode mode = this->sensor.get_acquisition_mode();
+    if (mode == Sht3x::AcquisitionMode::PERIODIC || mode == Sht3x::AcquisitionMode::ART) {
+        snapshot.status = this->sensor.send_break_command();
+        this->executor.sleep_ms(BREAK_CMD_DELAY_MS);
+    }
+    if (snapshot.status == Sht3x::I2C_STATUS::SUCCESS) {
+        snapshot.status = this->sensor.set_periodic_data_acquisition(this->mps, this->repeatability);
+    }
+    if (snapshot.status != Sht3x::I2C_STATUS::SUCCESS) {
+        snapshot.timestamp_ms = millis();
+        this->cell.publish(snapshot);
+        __atomic_store_n(&this->running, false, __ATOMIC_RELEASE);
+        return;
+    }
+    this->scheduler.start();
+
+    while (is_running()) {
+        Sht3x::MeasurementState state = this->scheduler.fetch_if_ready();
+        if (state == Sht3x::MeasurementState::READY) {
+            snapshot.temperature_raw = this->sensor.get_temperature_raw();
+            snapshot.rh_raw = this->sensor.get_rh_raw();
+            snapshot.timestamp_ms = millis();
+            snapshot.status = Sht3x::I2C_STATUS::SUCCESS;
+            this->cell.publish(snapshot);
+        } else if (state == Sht3x::MeasurementState::FAILED) {
+            snapshot.timestamp_ms = millis();
+            snapshot.status = this->scheduler.get_last_status();
+            this->cell.publish(snapshot);
+        }
+
+        int32_t wait_ms = (int32_t)(this->scheduler.next_fetch_due_ms() - millis());
+        this->executor.sleep_ms(wait_ms < SAMPLER_MIN_SLEEP_MS ? SAMPLER_MIN_SLEEP_MS : wait_ms);
+    }
+    /*The sensor takes commands again when stop() returns*/
+    this->sensor.send_break_command();
+    this->executor.sleep_ms(BREAK_CMD_DELAY_MS);
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_SAMPLER_H
+#define SHT3X_DIS_SAMPLER_H
+#include "sht3x-dis-scheduler.h"
+
+/**
+ * Background sampling for targets with threads or tasks.
+ * Not available on AVR, which has neither threads nor lock
+ * free 32 bit atomics.
+ *
+ * The built in executor is a FreeRTOS task on ESP32 and a
+ * std::thread when built outside of Arduino, for example
+ * for host tests. Define SHT3X_EXECUTOR_FREERTOS or
+ * SHT3X_EXECUTOR_THREAD to choose one, or implement
+ * Sht3xExecutor for another RTOS.
+ */
+#if !defined(__AVR__)
+
+#if !defined(SHT3X_EXECUTOR_FREERTOS) && !defined(SHT3X_EXECUTOR_THREAD)
+#if defined(ESP32) || defined(ESP_PLATFORM)
+#define SHT3X_EXECUTOR_FREERTOS
+#elif !defined(ARDUINO)
+#define SHT3X_EXECUTOR_THREAD
+#endif
+#endif
+
+#if defined(SHT3X_EXECUTOR_FREERTOS)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#define SAMPLER_DEFAULT_STACK_SIZE      4096
+#define SAMPLER_DEFAULT_PRIORITY        1
+#elif defined(SHT3X_EXECUTOR_THREAD)
+#include <thread>
+#endif
+
+#define SAMPLER_MIN_SLEEP_MS            1
+
+
+/*Latest reading as published by the sampler*/
+struct Sht3xSnapshot {
+    uint16_t temperature_raw;
+    uint16_t rh_raw;
+    uint32_t timestamp_ms;      /*millis() of the fetch*/
+    Sht3x::I2C_STATUS status;   /*the raw values are from the last successful fetch*/
+};
+
+
+/**
+ * @brief Holds one snapshot written by a single writer and
+ *        read by any number of readers without locks.
+ *
+ *        The writer makes the sequence number odd, writes the
+ *        values and makes it even again. A reader copies the
+ *        values between two reads of the sequence number and
+ *        tries again if it was odd or has changed, so it never
+ *        returns a mix of two snapshots. The writer never
+ *        waits for the readers.
+ */
+class Sht3xSnapshotCell {
+    public:
+        void publish(const Sht3xSnapshot &snapshot);
+        bool read(Sht3xSnapshot &snapshot) const;
+
+    private:
+        uint32_t sequence = 0;
+        uint32_t raw = 0;           /*temperature_raw << 16 | rh_raw*/
+        uint32_t timestamp_ms = 0;
+        uint8_t status = 0;
+};
+
+
+/**
+ * @brief Runs a task in the background. Implement it to run
+ *        the sampler on another RTOS.
+ */
+class Sht3xExecutor {
+    public:
+        virtual ~Sht3xExecutor() = default;
+        virtual bool spawn(void (*task)(void *), void *argument) = 0;
+        virtual void join() = 0;
+        virtual void sleep_ms(uint32_t ms) = 0;
+};
+
+
+#if defined(SHT3X_EXECUTOR_FREERTOS)
+/**
+ * @brief Executor running the task as a FreeRTOS task
+ */
+class Sht3xFreeRtosExecutor : public Sht3xExecutor {
+    public:
+        Sht3xFreeRtosExecutor(uint32_t stack_size = SAMPLER_DEFAULT_STACK_SIZE,
+            UBaseType_t priority = SAMPLER_DEFAULT_PRIORITY);
+        ~Sht3xFreeRtosExecutor();
+        bool spawn(void (*task)(void *), void *argument) override;
+        void join() override;
+        void sleep_ms(uint32_t ms) override;
+
+    private:
+        uint32_t stack_size;
+        UBaseType_t priority;
+        SemaphoreHandle_t done = nullptr;
+        void (*task)(void *) = nullptr;
+        void *argument = nullptr;
+
+        static void trampoline(void *executor);
+};
+#elif defined(SHT3X_EXECUTOR_THREAD)
+/**
+ * @brief Executor running the task in a std::thread
+ */
+class Sht3xThreadExecutor : public Sht3xExecutor {
+    public:
+        bool spawn(void (*task)(void *), void *argument) override;
+        void join() override;
+        void sleep_ms(uint32_t ms) override;
+
+    private:
+        std::thread thread;
+};
+#endif
+
+
+/**
+ * @brief Owns the bus of a sensor in periodic mode and
+ *        publishes every new reading as a snapshot that any
+ *        task can read without locks.
+ *
+ *        Other tasks must not use the sensor while the sampler
+ *        runs. They read the values with read() instead of the
+ *        getters of the sensor, which could mix two readings.
+ */
+class Sht3xSampler {
+    public:
+        Sht3xSampler(Sht3x &sensor, Sht3xExecutor &executor);
+        ~Sht3xSampler() = default;
+        bool start(Mps mps, Repeatability repeatability = Repeatability::HIGH_REPEATABILITY);
+        void stop();
+        bool read(Sht3xSnapshot &snapshot) const;
+        bool is_running() const;
+
+    private:
+        Sht3x &sensor;
+        Sht3xExecutor &executor;
+        Sht3xFetchScheduler scheduler;
+        Sht3xSnapshotCell cell;
+        Mps mps = Mps::MPS_1;
+        Repeatability repeatability = Repeatability::HIGH_REPEATABILITY;
+        bool running = false;
+        bool started = false;       /*task spawned and not joined yet*/
+
+        static void task(void *sampler);
+        void run();
+};
+
+#endif
+
+#endif
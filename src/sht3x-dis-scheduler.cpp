@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-scheduler.h"
+
+/**
+ * @brief Construct a new Sht3xFetchScheduler object
+ *
+ * @param sensor sensor in periodic or ART mode
+ */
+Sht3xFetchScheduler::Sht3xFetchScheduler(Sht3x &sensor): sensor{sensor} {
+}
+
+
+/**
+ * @brief Synchronise with the mode the sensor is running in.
+ *        Call after set_periodic_data_acquisition() or
+ *        art_4_hz_measurements().
+ */
+void Sht3xFetchScheduler::start() {
+    this->nominal_period_us = this->sensor.get_period_ms() * 1000UL;
+    this->period_us = this->nominal_period_us;
+
+    /*The first result is ready after one conversion*/
+    Repeatability repeatability = Repeatability::HIGH_REPEATABILITY;
+    if (this->sensor.get_acquisition_mode() == Sht3x::AcquisitionMode::PERIODIC) {
+        repeatability = this->sensor.get_repeatability();
+    }
+    this->next_due_us = this->sensor.get_acquisition_start_us()
+        + sht3x_measurement_duration_us(repeatability);
+    this->probe_margin_us = this->period_us >> SCHEDULER_PROBE_SHIFT_RETRY;
+    this->edge_valid = false;
+    this->phase_locked = false;
+    this->period_measured = false;
+    this->probing = false;
+    this->nack_seen = false;
+    this->samples_since_edge = 0;
+}
+
+
+/**
+ * @brief Time the next fetch is due
+ *
+ * @return uint32_t millis() value the next sample is expected at,
+ *         the current time if it is already due
+ */
+uint32_t Sht3xFetchScheduler::next_fetch_due_ms() {
+    int32_t remaining_us = (int32_t)(this->next_due_us - micros());
+    if (remaining_us < 0) {
+        remaining_us = 0;
+    }
+    return millis() + remaining_us / 1000;
+}
+
+
+/**
+ * @brief Fetch the next sample if it is due.
+ *        Returns at once without using the bus when it is not.
+ *
+ * @return Sht3x::MeasurementState READY when a new sample was
+ *         fetched, NOT_READY when it is not due or the sensor
+ *         has no new result yet, FAILED on a bus or CRC error,
+ *         IDLE when the sensor is not measuring periodically
+ */
+Sht3x::MeasurementState Sht3xFetchScheduler::fetch_if_ready() {
+    if (this->period_us == 0) {
+        return Sht3x::MeasurementState::IDLE;
+    }
+
+    uint32_t now_us = micros();
+    if ((int32_t)(now_us - this->next_due_us) < 0) {
+        return Sht3x::MeasurementState::NOT_READY;
+    }
+
+    this->last_status = this->sensor.fetch_data();
+    now_us = micros();
+
+    if (this->last_status == Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) {
+        /*Not ready yet, check again shortly*/
+        this->nack_seen = true;
+        this->next_due_us = now_us + (this->period_us >> SCHEDULER_PROBE_SHIFT_RETRY);
+        return Sht3x::MeasurementState::NOT_READY;
+    }
+
+    if (this->last_status != Sht3x::I2C_STATUS::SUCCESS) {
+        this->nack_seen = false;
+        this->probing = false;
+        this->next_due_us = now_us + this->period_us;
+        return Sht3x::MeasurementState::FAILED;
+    }
+
+    this->samples_since_edge++;
+    if (this->nack_seen) {
+        /*Success right after a NACK, a sample became ready just now*/
+        if (this->edge_valid) {
+            uint32_t measured_us = (now_us - this->edge_us) / this->samples_since_edge;
+            uint32_t tolerance_us = this->nominal_period_us >> SCHEDULER_PERIOD_TOLERANCE_SHIFT;
+            if (measured_us + tolerance_us > this->nominal_period_us
+                && measured_us < this->nominal_period_us + tolerance_us) {
+                if (!this->period_measured) {
+                    this->period_us = measured_us;
+                    this->period_measured = true;
+                } else {
+                    int32_t error_us = (int32_t)(measured_us - this->period_us);
+                    this->period_us += error_us / (1 << SCHEDULER_PERIOD_FILTER_SHIFT);
+                }
+            }
+        }
+        this->edge_us = now_us;
+        this->edge_valid = true;
+        this->phase_locked = true;
+        this->samples_since_edge = 0;
+        this->probe_margin_us = this->period_us >> SCHEDULER_PROBE_SHIFT_RETRY;
+        this->nack_seen = false;
+    } else if (this->probing) {
+        /*The sample was already waiting, it became ready earlier than
+        predicted. Probe earlier next time, up to the largest drift
+        the period may have.*/
+        this->phase_locked = false;
+        uint32_t max_margin_us = this->nominal_period_us >> SCHEDULER_PERIOD_TOLERANCE_SHIFT;
+        this->probe_margin_us = this->probe_margin_us * 2 < max_margin_us
+            ? this->probe_margin_us * 2 : max_margin_us;
+    }
+
+    schedule_next(now_us);
+    return Sht3x::MeasurementState::READY;
+}
+
+
+/**
+ * @brief Get the period between samples as measured so far
+ *
+ * @return uint32_t period in us
+ */
+uint32_t Sht3xFetchScheduler::get_period_us() {
+    return this->period_us;
+}
+
+
+/**
+ * @brief Get the status of the last fetch
+ *
+ * @return Sht3x::I2C_STATUS status of the last fetch on the bus
+ */
+Sht3x::I2C_STATUS Sht3xFetchScheduler::get_last_status() {
+    return this->last_status;
+}
+
+
+/**
+ * @brief Predict when the sample after the one just fetched
+ *        becomes ready and schedule the next fetch around it
+ *
+ * @param now_us time of the successful fetch
+ */
+void Sht3xFetchScheduler::schedule_next(uint32_t now_us) {
+    if (!this->phase_locked) {
+        /*Phase unknown, fetch a little early to find the edge*/
+        this->next_due_us = now_us + this->period_us - this->probe_margin_us;
+        this->probing = true;
+        return;
+    }
+
+    uint32_t ready_us = this->edge_us + (this->samples_since_edge + 1) * this->period_us;
+    this->probing = this->samples_since_edge + 1 >= SCHEDULER_PROBE_INTERVAL;
+    if (this->probing) {
+        this->next_due_us = ready_us - this->probe_margin_us;
+    } else {
+        this->next_due_us = ready_us + (this->period_us >> SCHEDULER_PROBE_SHIFT_RETRY);
+    }
+}
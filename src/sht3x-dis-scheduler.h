@@ -0,0 +1,84 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_SCHEDULER_H
+#define SHT3X_DIS_SCHEDULER_H
+#include "sht3x-dis-arduino-lib.h"
+
+/*Fetches between two re-checks of the sample phase*/
+#define SCHEDULER_PROBE_INTERVAL        16
+/*Largest accepted deviation of a measured period, 1/16 = 6%*/
+#define SCHEDULER_PERIOD_TOLERANCE_SHIFT 4
+/*Retry delay and fetch margin around the predicted sample, 1/64 of the period*/
+#define SCHEDULER_PROBE_SHIFT_RETRY     6
+/*Weight of a new period measurement, 1/8*/
+#define SCHEDULER_PERIOD_FILTER_SHIFT   3
+
+
+/**
+ * @brief Fetches periodic and ART measurements exactly once
+ *        per new sample without blocking.
+ *
+ *        The scheduler predicts when the next result becomes
+ *        ready from the configured rate and only touches the
+ *        bus once it is due. Every SCHEDULER_PROBE_INTERVAL
+ *        samples it fetches slightly early on purpose. The
+ *        NACK followed by a successful fetch then marks when
+ *        a sample became ready, which re-locks the phase and
+ *        refines the period to follow the sensor clock drift.
+ *        A probe that finds the sample already waiting means
+ *        the sensor clock runs fast, the probes then move
+ *        earlier each sample until a NACK locks the phase again.
+ */
+class Sht3xFetchScheduler {
+    public:
+        Sht3xFetchScheduler(Sht3x &sensor);
+        ~Sht3xFetchScheduler() = default;
+        void start();
+        uint32_t next_fetch_due_ms();
+        Sht3x::MeasurementState fetch_if_ready();
+        uint32_t get_period_us();
+        Sht3x::I2C_STATUS get_last_status();
+
+    private:
+        Sht3x &sensor;
+        uint32_t period_us = 0;
+        uint32_t nominal_period_us = 0;
+        uint32_t next_due_us = 0;
+        uint32_t edge_us = 0;          /*last time a sample was seen becoming ready*/
+        uint16_t samples_since_edge = 0;
+        uint32_t probe_margin_us = 0;  /*how early a probe fetches before the predicted sample*/
+        bool edge_valid = false;
+        bool phase_locked = false;     /*the next samples can be predicted from edge_us*/
+        bool period_measured = false;
+        bool probing = false;          /*the pending fetch is early on purpose*/
+        bool nack_seen = false;
+        Sht3x::I2C_STATUS last_status = Sht3x::I2C_STATUS::SUCCESS;
+
+        void schedule_next(uint32_t now_us);
+};
+
+#endif
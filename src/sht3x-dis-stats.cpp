@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-stats.h"
+
+/**
+ * @brief Construct a new Sht3xRunningStats object
+ *
+ * @param ema_shift weight of a new sample in the moving
+ *                  average is 2^-ema_shift, at most 15
+ */
+Sht3xRunningStats::Sht3xRunningStats(uint8_t ema_shift): ema_shift{ema_shift} {
+}
+
+
+/**
+ * @brief Add a raw value
+ *
+ * @param raw raw sensor word
+ */
+void Sht3xRunningStats::add(uint16_t raw) {
+    if (this->count == 0) {
+        this->offset = raw;
+        this->min_raw = raw;
+        this->max_raw = raw;
+        this->ema = (uint32_t)raw << this->ema_shift;
+    }
+    this->count++;
+
+    float delta = (float)((int32_t)raw - this->offset) - this->mean;
+    this->mean += delta / this->count;
+    this->m2 += delta * ((float)((int32_t)raw - this->offset) - this->mean);
+
+    if (raw < this->min_raw) {
+        this->min_raw = raw;
+    }
+    if (raw > this->max_raw) {
+        this->max_raw = raw;
+    }
+
+    this->ema = this->ema - (this->ema >> this->ema_shift) + raw;
+}
+
+
+/**
+ * @brief Forget all values added so far
+ */
+void Sht3xRunningStats::reset() {
+    this->count = 0;
+    this->mean = 0.0f;
+    this->m2 = 0.0f;
+}
+
+
+/**
+ * @brief Get the number of values added
+ *
+ * @return uint32_t number of values
+ */
+uint32_t Sht3xRunningStats::get_count() {
+    return this->count;
+}
+
+
+/**
+ * @brief Get the mean
+ *
+ * @return float mean raw value, 0 if no value was added
+ */
+float Sht3xRunningStats::get_mean_raw() {
+    return this->count == 0 ? 0.0f : this->offset + this->mean;
+}
+
+
+/**
+ * @brief Get the sample variance
+ *
+ * @return float variance in raw units squared, 0 for less than two values
+ */
+float Sht3xRunningStats::get_variance_raw() {
+    return this->count < 2 ? 0.0f : this->m2 / (this->count - 1);
+}
+
+
+/**
+ * @brief Get the smallest value added
+ *
+ * @return uint16_t minimum raw value
+ */
+uint16_t Sht3xRunningStats::get_min_raw() {
+    return this->min_raw;
+}
+
+
+/**
+ * @brief Get the largest value added
+ *
+ * @return uint16_t maximum raw value
+ */
+uint16_t Sht3xRunningStats::get_max_raw() {
+    return this->max_raw;
+}
+
+
+/**
+ * @brief Get the exponential moving average
+ *
+ * @return uint16_t average raw value
+ */
+uint16_t Sht3xRunningStats::get_ema_raw() {
+    return (uint16_t)((this->ema + ((1UL << this->ema_shift) >> 1)) >> this->ema_shift);
+}
@@ -0,0 +1,238 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_STATS_H
+#define SHT3X_DIS_STATS_H
+#include "sht3x-dis-arduino-lib.h"
+
+#define STATS_DEFAULT_EMA_SHIFT         3   /*EMA weight of a new sample, 1/8*/
+/*Scale of a raw word to degrees C and to percent*/
+#define STATS_TEMPERATURE_SCALE         (175.0f / 65535.0f)
+#define STATS_RH_SCALE                  (100.0f / 65535.0f)
+
+
+/**
+ * @brief Running statistics of one raw channel, updated in
+ *        constant time and memory per sample.
+ *
+ *        Mean and variance use Welford's method on the
+ *        difference to the first sample, which keeps the
+ *        float values small and precise over long runs.
+ *        The exponential moving average is kept in fixed
+ *        point with a weight of 2^-ema_shift.
+ */
+class Sht3xRunningStats {
+    public:
+        Sht3xRunningStats(uint8_t ema_shift = STATS_DEFAULT_EMA_SHIFT);
+        ~Sht3xRunningStats() = default;
+        void add(uint16_t raw);
+        void reset();
+        uint32_t get_count();
+        float get_mean_raw();
+        float get_variance_raw();
+        uint16_t get_min_raw();
+        uint16_t get_max_raw();
+        uint16_t get_ema_raw();
+
+    private:
+        uint32_t count = 0;
+        uint16_t offset = 0;
+        float mean = 0.0f;      /*mean of raw - offset*/
+        float m2 = 0.0f;        /*sum of squared differences to the mean*/
+        uint16_t min_raw = 0;
+        uint16_t max_raw = 0;
+        uint32_t ema = 0;       /*average scaled by 2^ema_shift*/
+        uint8_t ema_shift;
+};
+
+
+/**
+ * @brief Median of the last N raw values, removes single
+ *        sample spikes before they reach the statistics
+ *
+ * @tparam N window length, odd and at most 15.
+ *           1 passes the values through unchanged.
+ */
+template <uint8_t N>
+class Sht3xMedianFilter {
+    static_assert(N % 2 == 1 && N <= 15, "Window length must be odd and at most 15");
+
+    public:
+        /**
+         * @brief Add a value to the window
+         *
+         * @param raw new raw value
+         * @return uint16_t median of the window. Until the window
+         *         is full, the median of the values seen so far
+         */
+        uint16_t filter(uint16_t raw) {
+            this->window[this->next] = raw;
+            this->next = (this->next + 1) % N;
+            if (this->count < N) {
+                this->count++;
+            }
+
+            uint16_t sorted[N];
+            for (uint8_t i = 0; i < this->count; i++) {
+                uint16_t value = this->window[i];
+                uint8_t j = i;
+                for (; j > 0 && sorted[j - 1] > value; j--) {
+                    sorted[j] = sorted[j - 1];
+                }
+                sorted[j] = value;
+            }
+            return sorted[this->count / 2];
+        }
+
+
+        /**
+         * @brief Empty the window
+         */
+        void reset() {
+            this->count = 0;
+            this->next = 0;
+        }
+
+    private:
+        uint16_t window[N];
+        uint8_t count = 0;
+        uint8_t next = 0;
+};
+
+
+/**
+ * @brief Statistics stage for the fetch stream of a sensor.
+ *        Replaces storing a history of readings with a fixed
+ *        state per sensor: 54 bytes with MEDIAN_N = 1 and
+ *        110 bytes with MEDIAN_N = 15 on AVR, 64 and 120 bytes
+ *        on 32-bit targets. Each step of MEDIAN_N adds 4 bytes.
+ *
+ * @tparam MEDIAN_N length of the spike filter applied before
+ *                  the statistics, 1 to disable it
+ */
+template <uint8_t MEDIAN_N = 1>
+class Sht3xStats {
+    public:
+        Sht3xStats(uint8_t ema_shift = STATS_DEFAULT_EMA_SHIFT):
+            temperature{ema_shift}, rh{ema_shift} {
+        }
+
+
+        /**
+         * @brief Fetch the latest periodic measurement from the
+         *        sensor and add it to the statistics
+         *
+         * @param sensor sensor in periodic or ART mode
+         * @return Sht3x::I2C_STATUS status of the fetch
+         */
+        Sht3x::I2C_STATUS fetch(Sht3x &sensor) {
+            Sht3x::I2C_STATUS status = sensor.fetch_data();
+            if (status == Sht3x::I2C_STATUS::SUCCESS) {
+                add(sensor.get_temperature_raw(), sensor.get_rh_raw());
+            }
+            return status;
+        }
+
+
+        /**
+         * @brief Add a reading, for example after a single shot
+         *        measurement
+         *
+         * @param temperature_raw raw temperature word
+         * @param rh_raw raw rh word
+         */
+        void add(uint16_t temperature_raw, uint16_t rh_raw) {
+            this->temperature.add(this->temperature_filter.filter(temperature_raw));
+            this->rh.add(this->rh_filter.filter(rh_raw));
+        }
+
+
+        /**
+         * @brief Restart the statistics and the spike filter
+         */
+        void reset() {
+            this->temperature.reset();
+            this->rh.reset();
+            this->temperature_filter.reset();
+            this->rh_filter.reset();
+        }
+
+
+        /**
+         * @brief Statistics of the raw temperature words
+         */
+        Sht3xRunningStats &get_temperature_stats() {
+            return this->temperature;
+        }
+
+
+        /**
+         * @brief Statistics of the raw rh words
+         */
+        Sht3xRunningStats &get_rh_stats() {
+            return this->rh;
+        }
+
+
+        /**
+         * @brief Mean temperature in degrees C
+         */
+        float get_mean_temperature() {
+            return -45.0f + STATS_TEMPERATURE_SCALE * this->temperature.get_mean_raw();
+        }
+
+
+        /**
+         * @brief Standard deviation of the temperature in degrees C
+         */
+        float get_stddev_temperature() {
+            return STATS_TEMPERATURE_SCALE * sqrtf(this->temperature.get_variance_raw());
+        }
+
+
+        /**
+         * @brief Mean rh in percent
+         */
+        float get_mean_rh() {
+            return STATS_RH_SCALE * this->rh.get_mean_raw();
+        }
+
+
+        /**
+         * @brief Standard deviation of the rh in percent
+         */
+        float get_stddev_rh() {
+            return STATS_RH_SCALE * sqrtf(this->rh.get_variance_raw());
+        }
+
+    private:
+        Sht3xRunningStats temperature;
+        Sht3xRunningStats rh;
+        Sht3xMedianFilter<MEDIAN_N> temperature_filter;
+        Sht3xMedianFilter<MEDIAN_N> rh_filter;
+};
+
+#endif
@@ -0,0 +1,268 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#include "sht3x-dis-trace.h"
+
+/**
+ * @brief Construct a new Sht3xTraceRecorder object
+ *
+ * @param out where the trace is written to
+ */
+Sht3xTraceRecorder::Sht3xTraceRecorder(Print &out):
+    out{out} {
+}
+
+
+/**
+ * @brief Write the trace header. Call once before the
+ *        recorder is given to a sensor.
+ */
+void Sht3xTraceRecorder::start() {
+    const uint8_t header[TRACE_HEADER_SIZE] = {TRACE_MAGIC_0, TRACE_MAGIC_1,
+        TRACE_MAGIC_2, TRACE_VERSION};
+    this->bytes_written += this->out.write(header, TRACE_HEADER_SIZE);
+    this->last_us = micros();
+    this->records = 0;
+}
+
+
+/**
+ * @brief Append one transaction to the trace
+ *
+ * @param kind TRACE_RECORD_WRITE or TRACE_RECORD_READ
+ * @param address 7bit address of the transaction
+ * @param status I2C_STATUS of the transaction
+ * @param payload bytes written or read
+ * @param size number of bytes, cut to TRACE_MAX_PAYLOAD
+ * @param time_us micros() at the start of the transaction
+ */
+void Sht3xTraceRecorder::record(uint8_t kind, uint8_t address, uint8_t status,
+    const uint8_t *payload, uint8_t size, uint32_t time_us) {
+    if (size > TRACE_MAX_PAYLOAD) {
+        size = TRACE_MAX_PAYLOAD;
+    }
+    /*kind, address, up to 5 bytes of delta, size and payload*/
+    uint8_t buffer[8 + TRACE_MAX_PAYLOAD];
+    uint8_t length = 0;
+
+    buffer[length++] = (uint8_t)(kind << 4) | (status & 0x0F);
+    buffer[length++] = address;
+    uint32_t delta_us = time_us - this->last_us;
+    while (delta_us >= 0x80) {
+        buffer[length++] = (uint8_t)(delta_us | 0x80);
+        delta_us >>= 7;
+    }
+    buffer[length++] = (uint8_t)delta_us;
+    buffer[length++] = size;
+    for (uint8_t i = 0; i < size; i++) {
+        buffer[length++] = payload[i];
+    }
+
+    this->bytes_written += this->out.write(buffer, length);
+    this->last_us = time_us;
+    this->records++;
+}
+
+
+/**
+ * @brief Get the number of transactions recorded since start()
+ *
+ * @return uint32_t records
+ */
+uint32_t Sht3xTraceRecorder::get_records() {
+    return this->records;
+}
+
+
+/**
+ * @brief Get the size of the trace
+ *
+ * @return uint32_t bytes written, header included
+ */
+uint32_t Sht3xTraceRecorder::get_bytes_written() {
+    return this->bytes_written;
+}
+
+
+/**
+ * @brief Construct a new Sht3xTraceReplay object
+ *
+ * @param data trace starting with its header
+ * @param size size of the trace in bytes
+ */
+Sht3xTraceReplay::Sht3xTraceReplay(const uint8_t *data, size_t size):
+    data{data}, size{size} {
+    rewind();
+}
+
+
+/**
+ * @brief Start again from the first record. A trace with a
+ *        wrong header or version is empty.
+ */
+void Sht3xTraceReplay::rewind() {
+    this->time_us = 0;
+    this->mismatches = 0;
+    if (this->size < TRACE_HEADER_SIZE || this->data[0] != TRACE_MAGIC_0
+        || this->data[1] != TRACE_MAGIC_1 || this->data[2] != TRACE_MAGIC_2
+        || this->data[3] != TRACE_VERSION) {
+        this->position = this->size;
+        return;
+    }
+    this->position = TRACE_HEADER_SIZE;
+}
+
+
+/**
+ * @brief Decode the next record
+ *
+ * @param record decoded record, time_us counts from start()
+ *        of the recorder
+ * @return true when a record was decoded, false at the end
+ *         of the trace or on a truncated record
+ */
+bool Sht3xTraceReplay::next(Sht3xTraceRecord &record) {
+    size_t position = this->position;
+    if (this->size - position < 4) {
+        this->position = this->size;
+        return false;
+    }
+
+    record.kind = this->data[position] >> 4;
+    record.status = this->data[position++] & 0x0F;
+    record.address = this->data[position++];
+
+    uint32_t delta_us = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        if (position >= this->size || shift > 28) {
+            this->position = this->size;
+            return false;
+        }
+        byte = this->data[position++];
+        delta_us |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    if (position >= this->size) {
+        this->position = this->size;
+        return false;
+    }
+    record.size = this->data[position++];
+    if (record.size > TRACE_MAX_PAYLOAD || this->size - position < record.size) {
+        this->position = this->size;
+        return false;
+    }
+    for (uint8_t i = 0; i < record.size; i++) {
+        record.payload[i] = this->data[position++];
+    }
+
+    this->time_us += delta_us;
+    record.time_us = this->time_us;
+    this->position = position;
+    return true;
+}
+
+
+/**
+ * @brief Answer a write of the sensor from the next record.
+ *        The recorded status is returned even if the command
+ *        differs from the recorded one, the difference is
+ *        counted as a mismatch.
+ *
+ * @param tx_buffer bytes the sensor writes
+ * @param tx_buffer_size number of bytes
+ * @param status recorded I2C_STATUS
+ * @return true when a record was replayed, false at the end
+ *         of the trace
+ */
+bool Sht3xTraceReplay::replay_write(const uint8_t *tx_buffer, uint8_t tx_buffer_size,
+    uint8_t &status) {
+    Sht3xTraceRecord record;
+    if (!next(record)) {
+        return false;
+    }
+
+    bool match = record.kind == TRACE_RECORD_WRITE && record.size == tx_buffer_size;
+    for (uint8_t i = 0; match && i < record.size; i++) {
+        match = record.payload[i] == tx_buffer[i];
+    }
+    if (!match) {
+        this->mismatches++;
+    }
+    status = record.status;
+    return true;
+}
+
+
+/**
+ * @brief Answer a read of the sensor from the next record
+ *
+ * @param rx_buffer filled with the recorded bytes
+ * @param rx_buffer_size number of bytes the sensor reads
+ * @param status recorded I2C_STATUS
+ * @return true when a record was replayed, false at the end
+ *         of the trace
+ */
+bool Sht3xTraceReplay::replay_read(uint8_t *rx_buffer, uint8_t rx_buffer_size,
+    uint8_t &status) {
+    Sht3xTraceRecord record;
+    if (!next(record)) {
+        return false;
+    }
+
+    if (record.kind != TRACE_RECORD_READ || record.size > rx_buffer_size) {
+        this->mismatches++;
+    }
+    for (uint8_t i = 0; i < record.size && i < rx_buffer_size; i++) {
+        rx_buffer[i] = record.payload[i];
+    }
+    status = record.status;
+    return true;
+}
+
+
+/**
+ * @brief Check if all records were played
+ *
+ * @return true at the end of the trace
+ */
+bool Sht3xTraceReplay::is_done() {
+    return this->position >= this->size;
+}
+
+
+/**
+ * @brief Get the number of transactions of the sensor that
+ *        did not match the recorded ones
+ *
+ * @return uint32_t mismatches since the last rewind()
+ */
+uint32_t Sht3xTraceReplay::get_mismatches() {
+    return this->mismatches;
+}
@@ -0,0 +1,143 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+
+#ifndef SHT3X_DIS_TRACE_H
+#define SHT3X_DIS_TRACE_H
+#include <Arduino.h>
+
+/**
+ * Record and replay of the raw i2c transactions of a sensor.
+ * The hooks in the driver are compiled out unless SHT3X_TRACE
+ * is defined to 1 before the library is built, for example
+ * with -DSHT3X_TRACE=1 in the build flags. Like
+ * SHT3X_PERF_COUNTERS it changes the members of Sht3x and must
+ * be set for the whole project.
+ *
+ * A trace starts with the 4 byte header 'S' '3' 'T' version,
+ * followed by one record per transaction:
+ *
+ *   kkkk ssss                kind, I2C_STATUS of the transaction
+ *   address                  7bit address, 0 for a general call
+ *   delta_us                 time since the previous record,
+ *                            7 bits per byte LSB first, bit 7
+ *                            set on all but the last byte
+ *   size                     payload bytes
+ *   payload                  bytes written or read
+ *
+ * A fetch takes about 19 bytes. A replayed sensor gets the
+ * recorded status and data of each transaction in order, as
+ * fast as the host runs. The timing of the trace is not
+ * replayed, poll() and the schedulers see the host clock, and
+ * mux channel writes are neither recorded nor replayed.
+ */
+
+#ifndef SHT3X_TRACE
+#define SHT3X_TRACE                     0
+#endif
+
+#define TRACE_MAGIC_0                   'S'
+#define TRACE_MAGIC_1                   '3'
+#define TRACE_MAGIC_2                   'T'
+#define TRACE_VERSION                   1
+#define TRACE_HEADER_SIZE               4
+#define TRACE_MAX_PAYLOAD               6   /*a measurement result*/
+
+#define TRACE_RECORD_WRITE              0x0
+#define TRACE_RECORD_READ               0x1
+
+#if SHT3X_TRACE
+#define SHT3X_TRACE_START(trace_us)     uint32_t trace_us = micros()
+#define SHT3X_TRACE_RECORD(recorder, kind, address, status, payload, size, trace_us) \
+    do { \
+        if ((recorder) != nullptr) { \
+            (recorder)->record(kind, address, (uint8_t)(status), payload, size, trace_us); \
+        } \
+    } while (0)
+#else
+#define SHT3X_TRACE_START(trace_us)     do {} while (0)
+#define SHT3X_TRACE_RECORD(recorder, kind, address, status, payload, size, trace_us) do {} while (0)
+#endif
+
+
+/*One transaction of a trace*/
+struct Sht3xTraceRecord {
+    uint32_t time_us;   /*micros() at the start of the transaction*/
+    uint8_t kind;       /*TRACE_RECORD_WRITE or TRACE_RECORD_READ*/
+    uint8_t address;
+    uint8_t status;     /*I2C_STATUS*/
+    uint8_t size;
+    uint8_t payload[TRACE_MAX_PAYLOAD];
+};
+
+
+/**
+ * @brief Writes the transactions of a sensor to any Print
+ *        (SD card file, RAM buffer, Serial)
+ */
+class Sht3xTraceRecorder {
+    public:
+        Sht3xTraceRecorder(Print &out);
+        ~Sht3xTraceRecorder() = default;
+        void start();
+        void record(uint8_t kind, uint8_t address, uint8_t status,
+            const uint8_t *payload, uint8_t size, uint32_t time_us);
+        uint32_t get_records();
+        uint32_t get_bytes_written();
+
+    private:
+        Print &out;
+        uint32_t last_us = 0;
+        uint32_t records = 0;
+        uint32_t bytes_written = 0;
+};
+
+
+/**
+ * @brief Plays back a trace held in memory, either record by
+ *        record with next() or into a sensor through
+ *        Sht3x::set_trace_replay()
+ */
+class Sht3xTraceReplay {
+    public:
+        Sht3xTraceReplay(const uint8_t *data, size_t size);
+        ~Sht3xTraceReplay() = default;
+        bool next(Sht3xTraceRecord &record);
+        bool replay_write(const uint8_t *tx_buffer, uint8_t tx_buffer_size, uint8_t &status);
+        bool replay_read(uint8_t *rx_buffer, uint8_t rx_buffer_size, uint8_t &status);
+        void rewind();
+        bool is_done();
+        uint32_t get_mismatches();
+
+    private:
+        const uint8_t *data;
+        size_t size;
+        size_t position = 0;
+        uint32_t time_us = 0;
+        uint32_t mismatches = 0;
+};
+
+#endif
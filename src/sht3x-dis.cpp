@@ -26,48 +26,209 @@ SOFTWARE.
 #include "sht3x-dis-registers.h"
 #include "sht3x-dis-arduino-lib.h"
 
+/*Command words indexed by [clock stretching][repeatability], kept in flash*/
+static const uint16_t SINGLE_SHOT_COMMANDS[2][3] PROGMEM = {
+    {
+        sht3x_single_shot_command(Repeatability::HIGH_REPEATABILITY, ClockStretching::STRETCHING_ENABLED),
+        sht3x_single_shot_command(Repeatability::MEDIUM_REPEATABILITY, ClockStretching::STRETCHING_ENABLED),
+        sht3x_single_shot_command(Repeatability::LOW_REPEATABILITY, ClockStretching::STRETCHING_ENABLED)
+    },
+    {
+        sht3x_single_shot_command(Repeatability::HIGH_REPEATABILITY, ClockStretching::STRETCHING_DISABLED),
+        sht3x_single_shot_command(Repeatability::MEDIUM_REPEATABILITY, ClockStretching::STRETCHING_DISABLED),
+        sht3x_single_shot_command(Repeatability::LOW_REPEATABILITY, ClockStretching::STRETCHING_DISABLED)
+    }
+};
+
+/*Command words indexed by [mps][repeatability], kept in flash*/
+#define PERIODIC_COMMAND_ROW(mps) { \
+        sht3x_periodic_command(mps, Repeatability::HIGH_REPEATABILITY), \
+        sht3x_periodic_command(mps, Repeatability::MEDIUM_REPEATABILITY), \
+        sht3x_periodic_command(mps, Repeatability::LOW_REPEATABILITY) }
+
+static const uint16_t PERIODIC_COMMANDS[5][3] PROGMEM = {
+    PERIODIC_COMMAND_ROW(Mps::MPS_0_5),
+    PERIODIC_COMMAND_ROW(Mps::MPS_1),
+    PERIODIC_COMMAND_ROW(Mps::MPS_2),
+    PERIODIC_COMMAND_ROW(Mps::MPS_4),
+    PERIODIC_COMMAND_ROW(Mps::MPS_10)
+};
+
+
 /**
- * @brief function to read i2c data from sht3x
+ * @brief Map the return code of Wire.endTransmission()
+ *        to an I2C_STATUS value
  *
- * @param tx_buffer i2c data buffer to transmit
+ * @param status return code of Wire.endTransmission()
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::to_i2c_status(uint8_t status) {
+    if(status == 0) return I2C_STATUS::SUCCESS;
+    else if(status == 1) return I2C_STATUS::DATA_TOO_LONG_FOR_TX_BUFFER;
+    else if(status == 2) return I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS;
+    else if(status == 3) return I2C_STATUS::RECEIVED_NACK_ON_TX_DATA;
+    else if(status == 5) return I2C_STATUS::TIMEOUT;
+    return I2C_STATUS::OTHER_ERROR;
+}
+
+
+/**
+ * @brief Connect a mux channel before a transfer. Nothing is
+ *        sent without a mux or when the channel is already
+ *        connected. Shared with Sht3xLite.
+ *
+ * @param mux multiplexer of the sensor, nullptr for none
+ * @param mux_channel channel of the multiplexer 0-7
+ * @return Sht3x::I2C_STATUS status of the mux write
+ */
+Sht3x::I2C_STATUS Sht3x::select_mux_channel(Sht3xMux *mux, uint8_t mux_channel) {
+    if (mux == nullptr) {
+        return I2C_STATUS::SUCCESS;
+    }
+    return to_i2c_status(mux->select(mux_channel));
+}
+
+
+/**
+ * @brief Write a command and its data in one transfer.
+ *        Shared with Sht3xLite.
+ *
+ * @param wire i2c bus of the sensor
+ * @param device_address 7bit address of sht3x
+ * @param tx_buffer i2c data transmit buffer
  * @param tx_buffer_size i2c data buffer size
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::transmit(TwoWire &wire, uint8_t device_address,
+    const uint8_t *tx_buffer, uint8_t tx_buffer_size) {
+    wire.beginTransmission(device_address);
+    for (uint8_t i = 0; i < tx_buffer_size; i++) {
+        wire.write(tx_buffer[i]);
+    }
+    return to_i2c_status(wire.endTransmission());
+}
+
+
+/**
+ * @brief Read data without sending a command first. The
+ *        sensor NACKs the read header while a measurement is
+ *        in progress. Shared with Sht3xLite.
+ *
+ * @param wire i2c bus of the sensor
+ * @param device_address 7bit address of sht3x
  * @param rx_buffer i2c buffer to receive data
  * @param rx_buffer_size i2c receive buffer size
- * @return Sht3x::I2C_STATUS status of the i2c comms
+ * @return Sht3x::I2C_STATUS WIRE_AVAILABLE_FALSE when the
+ *         sensor NACKs
  */
-Sht3x::I2C_STATUS Sht3x::read_i2c_device(uint8_t *tx_buffer,
-    uint8_t tx_buffer_size,
+Sht3x::I2C_STATUS Sht3x::receive(TwoWire &wire, uint8_t device_address,
     uint8_t *rx_buffer, uint8_t rx_buffer_size) {
-    Wire.begin();
-    Wire.beginTransmission(this->device_address);
-    for (size_t i = 0; i < tx_buffer_size; i++) {
-        Wire.write(tx_buffer[i]);
+    wire.requestFrom(device_address, rx_buffer_size);
+    if (!wire.available()) {
+        return I2C_STATUS::WIRE_AVAILABLE_FALSE;
     }
+    for (uint8_t i = 0; i < rx_buffer_size; i++) {
+        rx_buffer[i] = wire.read();
+    }
+    return I2C_STATUS::SUCCESS;
+}
 
-    uint8_t status = Wire.endTransmission();
-    I2C_STATUS STATUS;
 
-    if(status == 0) STATUS = I2C_STATUS::SUCCESS;
-    else if(status == 1) STATUS = I2C_STATUS::DATA_TOO_LONG_FOR_TX_BUFFER;
-    else if(status == 2) STATUS = I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS;
-    else if(status == 3) STATUS = I2C_STATUS::RECEIVED_NACK_ON_TX_DATA;
-    else if(status == 4) STATUS = I2C_STATUS::OTHER_ERROR;
-    else if(status == 5) STATUS = I2C_STATUS::TIMEOUT;
-    else {
-      Serial.println("I2C error code unknown");
+/**
+ * @brief Check the CRC of every word of a result, each word
+ *        is 2 data bytes and their CRC. Shared with
+ *        Sht3xLite.
+ *
+ * @param data received bytes
+ * @param size number of bytes, a multiple of 3
+ * @return Sht3x::I2C_STATUS SUCCESS or CRC_ERROR
+ */
+Sht3x::I2C_STATUS Sht3x::check_crc(const uint8_t *data, uint8_t size) {
+    for (uint8_t i = 0; i + 2 < size; i += 3) {
+        if (sht3x_crc8(data + i, 2) != data[i + 2]) {
+            return I2C_STATUS::CRC_ERROR;
+        }
     }
+    return I2C_STATUS::SUCCESS;
+}
 
 
-    Wire.requestFrom(this->device_address, rx_buffer_size);
-    if (Wire.available()) {
-      for (size_t i = 0; i < rx_buffer_size; i++) {
-        rx_buffer[i] = Wire.read();
-      }
-    } else {
+/**
+ * @brief Connect the mux channel of the sensor before a
+ *        transfer. Nothing is sent without a mux or when the
+ *        channel is already connected.
+ *
+ * @return Sht3x::I2C_STATUS status of the mux write
+ */
+Sht3x::I2C_STATUS Sht3x::select_channel() {
+#if SHT3X_PERF_COUNTERS
+    if (this->mux != nullptr) {
+        /*Each control byte written to the muxes is a transaction of its own*/
+        uint32_t switches = this->mux->get_group_switch_count();
+        uint32_t start_us = micros();
+        I2C_STATUS status = select_mux_channel(this->mux, this->mux_channel);
+        uint32_t writes = this->mux->get_group_switch_count() - switches;
+        uint32_t latency_us = writes > 0 ? (micros() - start_us) / writes : 0;
+        for (uint32_t i = 0; i < writes; i++) {
+            sht3x_perf_record(this->perf_counters, latency_us, 1, 0,
+                (uint8_t)(i + 1 < writes ? I2C_STATUS::SUCCESS : status));
+        }
+        return status;
+    }
+#endif
+    return select_mux_channel(this->mux, this->mux_channel);
+}
+
+
+/**
+ * @brief function to read i2c data from sht3x.
+ *        The bus must have been started with begin()
+ *
+ * @param tx_buffer i2c data buffer to transmit
+ * @param tx_buffer_size i2c data buffer size
+ * @param rx_buffer i2c buffer to receive data
+ * @param rx_buffer_size i2c receive buffer size
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::read_i2c_device(uint8_t *tx_buffer,
+    uint8_t tx_buffer_size,
+    uint8_t *rx_buffer, uint8_t rx_buffer_size) {
+    I2C_STATUS STATUS = write_i2c_device(tx_buffer, tx_buffer_size);
+
+    if (receive_i2c_device(rx_buffer, rx_buffer_size) != I2C_STATUS::SUCCESS) {
       STATUS = I2C_STATUS::WIRE_AVAILABLE_FALSE;
     }
 
-    Wire.end();
+    return STATUS;
+}
+
+
+/**
+ * @brief Function to read i2c data from sht3x without
+ *        sending a command first. The sensor NACKs the
+ *        read header while a measurement is in progress.
+ *
+ * @param rx_buffer i2c buffer to receive data
+ * @param rx_buffer_size i2c receive buffer size
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::receive_i2c_device(uint8_t *rx_buffer,
+    uint8_t rx_buffer_size) {
+#if SHT3X_TRACE
+    if (this->trace_replay != nullptr) {
+      return replay_transaction(TRACE_RECORD_READ, rx_buffer, rx_buffer_size);
+    }
+#endif
+    if (select_channel() != I2C_STATUS::SUCCESS) {
+      return I2C_STATUS::WIRE_AVAILABLE_FALSE;
+    }
+    SHT3X_PERF_START(start_us);
+    SHT3X_TRACE_START(trace_us);
+    I2C_STATUS STATUS = receive(this->wire, this->device_address, rx_buffer, rx_buffer_size);
+    SHT3X_PERF_TRANSACTION(this->perf_counters, start_us, 0,
+      STATUS == I2C_STATUS::SUCCESS ? rx_buffer_size : 0, STATUS);
+    SHT3X_TRACE_RECORD(this->trace_recorder, TRACE_RECORD_READ, this->device_address,
+      STATUS, rx_buffer, STATUS == I2C_STATUS::SUCCESS ? rx_buffer_size : 0, trace_us);
     return STATUS;
 }
 
@@ -81,27 +242,22 @@ Sht3x::I2C_STATUS Sht3x::read_i2c_device(uint8_t *tx_buffer,
  */
 Sht3x::I2C_STATUS Sht3x::write_i2c_device(uint8_t *tx_buffer,
     uint8_t tx_buffer_size) {
-    Wire.begin();
-    Wire.beginTransmission(this->device_address);
-
-    for (size_t i = 0; i < tx_buffer_size; i++) {
-        Wire.write(tx_buffer[i]);
+#if SHT3X_TRACE
+    if (this->trace_replay != nullptr) {
+        return replay_transaction(TRACE_RECORD_WRITE, tx_buffer, tx_buffer_size);
     }
-    uint8_t status = Wire.endTransmission();
-    I2C_STATUS STATUS;
-
-    if(status == 0) STATUS = I2C_STATUS::SUCCESS;
-    else if(status == 1) STATUS = I2C_STATUS::DATA_TOO_LONG_FOR_TX_BUFFER;
-    else if(status == 2) STATUS = I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS;
-    else if(status == 3) STATUS = I2C_STATUS::RECEIVED_NACK_ON_TX_DATA;
-    else if(status == 4) STATUS = I2C_STATUS::OTHER_ERROR;
-    else if(status == 5) STATUS = I2C_STATUS::TIMEOUT;
-    else {
-      Serial.println("I2C error code unknown");
+#endif
+    I2C_STATUS STATUS = select_channel();
+    if (STATUS != I2C_STATUS::SUCCESS) {
+        return STATUS;
     }
+    SHT3X_PERF_START(start_us);
+    SHT3X_TRACE_START(trace_us);
+    STATUS = transmit(this->wire, this->device_address, tx_buffer, tx_buffer_size);
+    SHT3X_PERF_TRANSACTION(this->perf_counters, start_us, tx_buffer_size, 0, STATUS);
+    SHT3X_TRACE_RECORD(this->trace_recorder, TRACE_RECORD_WRITE, this->device_address,
+        STATUS, tx_buffer, tx_buffer_size, trace_us);
 
-
-    Wire.end();
     return STATUS;
 }
 
@@ -110,8 +266,52 @@ Sht3x::I2C_STATUS Sht3x::write_i2c_device(uint8_t *tx_buffer,
  * @brief Construct a new Sht 3x:: Sht 3x object
  *
  * @param device_address 7bit address of sht3x
+ * @param wire i2c bus the sensor is attached to
+ */
+Sht3x::Sht3x(const uint8_t device_address, TwoWire &wire):
+    wire{wire}, device_address{device_address} {
+}
+
+
+/**
+ * @brief Construct a new Sht 3x:: Sht 3x object for a sensor
+ *        behind an i2c multiplexer
+ *
+ * @param device_address 7bit address of sht3x
+ * @param mux multiplexer the sensor is attached to
+ * @param mux_channel channel of the multiplexer 0-7
+ */
+Sht3x::Sht3x(const uint8_t device_address, Sht3xMux &mux, uint8_t mux_channel):
+    wire{mux.get_wire()}, device_address{device_address}, mux{&mux},
+    mux_channel{mux_channel} {
+}
+
+
+/**
+ * @brief Start the i2c bus session used by the sensor.
+ *        Call once from setup(). The bus stays up for the
+ *        lifetime of the program and can be shared with
+ *        other devices on the same bus. The channel of a
+ *        mux is selected again on the next transfer.
+ */
+void Sht3x::begin() {
+    this->wire.begin();
+    if (this->mux != nullptr) {
+        this->mux->invalidate();
+    }
+}
+
+
+/**
+ * @brief Stop and start the i2c bus session again, for example
+ *        after the bus pins were driven as GPIOs. Some cores
+ *        keep a running bus as it is on begin(), the ESP32 one
+ *        among them, so the bus is ended first. Other devices
+ *        on the same bus are affected as well.
  */
-Sht3x::Sht3x(const uint8_t device_address): device_address{device_address} {
+void Sht3x::restart_bus() {
+    this->wire.end();
+    begin();
 }
 
 
@@ -119,49 +319,124 @@ Sht3x::Sht3x(const uint8_t device_address): device_address{device_address} {
  * @brief Perform singleshot measurement
  *
  * @param mode clock streching and repeatability selection
+ * @return Sht3x::I2C_STATUS status of the measurement,
+ *         CRC_ERROR if the result was corrupted
  */
-void Sht3x::perform_single_shot_measurement(uint8_t mode) {
+Sht3x::I2C_STATUS Sht3x::perform_single_shot_measurement(uint8_t mode) {
+    if(mode < 1 || mode > 6) {
+      SHT3X_LOG_ERROR("single shot measurement mode not found.");
+      return I2C_STATUS::INVALID_ARGUMENT;
+    }
 
+    return perform_single_shot_measurement(static_cast<Repeatability>((mode - 1) % 3),
+        mode <= 3 ? ClockStretching::STRETCHING_ENABLED : ClockStretching::STRETCHING_DISABLED);
+}
+
+
+/**
+ * @brief Perform singleshot measurement
+ *
+ * @param repeatability repeatability of the measurement
+ * @param clock_stretching clock stretching selection
+ * @return Sht3x::I2C_STATUS status of the measurement,
+ *         CRC_ERROR if the result was corrupted
+ */
+Sht3x::I2C_STATUS Sht3x::perform_single_shot_measurement(Repeatability repeatability,
+    ClockStretching clock_stretching) {
+    uint16_t command = pgm_read_word(&SINGLE_SHOT_COMMANDS[static_cast<uint8_t>(clock_stretching)]
+        [static_cast<uint8_t>(repeatability)]);
+    return measure_single_shot(command, repeatability, clock_stretching);
+}
+
+
+/**
+ * @brief Run a single shot measurement command to completion
+ *
+ * @param command single shot measurement command
+ * @param repeatability repeatability of the command
+ * @param clock_stretching clock stretching of the command
+ * @return Sht3x::I2C_STATUS status of the measurement
+ */
+Sht3x::I2C_STATUS Sht3x::measure_single_shot(uint16_t command,
+    Repeatability repeatability, ClockStretching clock_stretching) {
     I2C_STATUS status;
 
-    if(mode == 1) status = read_i2c_device(this->single_shot_mode.MODE1, 2, this->i2c_data, 6);
-    else if(mode == 2) status = read_i2c_device(this->single_shot_mode.MODE2, 2, this->i2c_data, 6);
-    else if(mode == 3) status = read_i2c_device(this->single_shot_mode.MODE3, 2, this->i2c_data, 6);
-    else if(mode == 4) status = read_i2c_device(this->single_shot_mode.MODE4, 2, this->i2c_data, 6);
-    else if(mode == 5) status = read_i2c_device(this->single_shot_mode.MODE5, 2, this->i2c_data, 6);
-    else if(mode == 6) status = read_i2c_device(this->single_shot_mode.MODE6, 2, this->i2c_data, 6);
-    else {
-      Serial.println("single shot measurement mode not found.");
+    /*Without clock stretching wait for the conversion to finish*/
+    if(clock_stretching == ClockStretching::STRETCHING_DISABLED) {
+        status = begin_single_shot(command, repeatability);
+        while (status == I2C_STATUS::SUCCESS
+            && poll() == MeasurementState::NOT_READY) {
+            delay(1);
+        }
+        if (status == I2C_STATUS::SUCCESS) {
+            status = collect();
+        }
+        if(status != Sht3x::I2C_STATUS::SUCCESS) {
+            SHT3X_LOG_ERROR("Error in i2c communications");
+        }
+        return status;
     }
 
+    uint8_t cmds[2] = {(uint8_t)(command >> 8), (uint8_t)command};
+    status = read_i2c_device(cmds, 2, this->i2c_data, 6);
+
+    if(status == Sht3x::I2C_STATUS::SUCCESS) {
+        status = check_measurement_crc();
+    }
 
     if(status != Sht3x::I2C_STATUS::SUCCESS) {
-        Serial.println("Error in i2c communications");
+        SHT3X_LOG_ERROR("Error in i2c communications");
+        return status;
     }
 
     this->read_temperature();
     this->read_relative_humidity();
+    return status;
+}
 
+
+/**
+ * @brief Send a command without data
+ *
+ * @param command command word, sent MSB first
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::send_command(uint16_t command) {
+    uint8_t cmds[2] = {(uint8_t)(command >> 8), (uint8_t)command};
+    return write_i2c_device(cmds, 2);
 }
 
 
 /**
- * @brief Convert the i2c data to floating point
- *        temperature value
+ * @brief Check the CRC of both words of a 6 byte
+ *        measurement result in i2c_data
+ *
+ * @return Sht3x::I2C_STATUS SUCCESS or CRC_ERROR
+ */
+Sht3x::I2C_STATUS Sht3x::check_measurement_crc() {
+    I2C_STATUS status = check_crc(this->i2c_data, 6);
+    if (status != I2C_STATUS::SUCCESS) {
+        SHT3X_PERF_COUNT(this->perf_counters, I2C_STATUS::CRC_ERROR);
+    }
+    return status;
+}
+
+
+/**
+ * @brief Read the raw temperature word from the i2c data
  */
 void Sht3x::read_temperature() {
   this->temperature_raw = (this->i2c_data[0] << 8) | this->i2c_data[1];
-  this->temperature = -45 + 175 * (this->temperature_raw)/(TWO_TO_THE_POWER_16 - 1);
+  this->derived_valid = 0;
 }
 
 
 /**
- * @brief Convert the i2c data to floating point
- *        rh value
+ * @brief Read the raw rh word from the i2c data
  */
 void Sht3x::read_relative_humidity() {
   this->rh_raw = (this->i2c_data[3] << 8) | this->i2c_data[4];
-  this->rh = 100 * this->rh_raw/(TWO_TO_THE_POWER_16 - 1);
+  this->derived_valid = 0;
 }
 
 
@@ -171,7 +446,7 @@ void Sht3x::read_relative_humidity() {
  * @return float temperature value
  */
 float Sht3x::get_temperature() {
-    return this->temperature;
+    return get_temperature_centi() / 100.0f;
 }
 
 
@@ -181,7 +456,92 @@ float Sht3x::get_temperature() {
  * @return float
  */
 float Sht3x::get_rh() {
-    return this->rh;
+    return get_rh_centi() / 100.0f;
+}
+
+
+/**
+ * @brief Get current temperature without floating point
+ *
+ * @return int16_t temperature in 0.01 C
+ */
+int16_t Sht3x::get_temperature_centi() {
+    return sht3x_temperature_centi(this->temperature_raw);
+}
+
+
+/**
+ * @brief Get current rh value without floating point
+ *
+ * @return uint16_t rh in 0.01 %
+ */
+uint16_t Sht3x::get_rh_centi() {
+    return sht3x_rh_centi(this->rh_raw);
+}
+
+
+/**
+ * @brief Get the raw temperature word of the last reading
+ *
+ * @return uint16_t raw temperature word
+ */
+uint16_t Sht3x::get_temperature_raw() {
+    return this->temperature_raw;
+}
+
+
+/**
+ * @brief Get the raw rh word of the last reading
+ *
+ * @return uint16_t raw rh word
+ */
+uint16_t Sht3x::get_rh_raw() {
+    return this->rh_raw;
+}
+
+
+/**
+ * @brief Get the dew point of the last reading.
+ *        Computed on the first call after a reading only.
+ *
+ * @return float dew point in C
+ */
+float Sht3x::get_dew_point() {
+    if (!(this->derived_valid & DERIVED_DEW_POINT)) {
+        this->dew_point = sht3x_dew_point(get_temperature(), get_rh());
+        this->derived_valid |= DERIVED_DEW_POINT;
+    }
+    return this->dew_point;
+}
+
+
+/**
+ * @brief Get the absolute humidity of the last reading.
+ *        Computed on the first call after a reading only.
+ *
+ * @return float absolute humidity in g/m^3
+ */
+float Sht3x::get_absolute_humidity() {
+    if (!(this->derived_valid & DERIVED_ABSOLUTE_HUMIDITY)) {
+        this->absolute_humidity = sht3x_absolute_humidity(get_temperature(), get_rh());
+        this->derived_valid |= DERIVED_ABSOLUTE_HUMIDITY;
+    }
+    return this->absolute_humidity;
+}
+
+
+/**
+ * @brief Get the heat index of the last reading.
+ *        Computed on the first call after a reading only.
+ *
+ * @return float heat index in C
+ */
+float Sht3x::get_heat_index() {
+    if (!(this->derived_valid & DERIVED_HEAT_INDEX)) {
+        this->heat_index = sht3x_heat_index(get_temperature(), get_rh());
+        this->derived_valid |= DERIVED_HEAT_INDEX;
+    }
+    return this->heat_index;
 }
 
 
@@ -190,41 +550,111 @@ float Sht3x::get_rh() {
  *        Acquisition.
  *        After the successful execution of this command
  *        Device returns to singleshot mode
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
  */
-void Sht3x::send_break_command() {
-    uint8_t cmds[2] = {BREAK_CMD_MSB, BREAK_CMD_LSB};
-    Serial.println("Sending break command");
-    I2C_STATUS status =  write_i2c_device(cmds, 2);
+Sht3x::I2C_STATUS Sht3x::send_break_command() {
+    SHT3X_LOG_INFO("Sending break command");
+    I2C_STATUS status = send_command((BREAK_CMD_MSB << 8) | BREAK_CMD_LSB);
     if (status != I2C_STATUS::SUCCESS) {
-        Serial.println("Failed to send break command");
+        SHT3X_LOG_ERROR("Failed to send break command");
+    } else {
+        this->acquisition_mode = AcquisitionMode::SINGLE_SHOT;
     }
+    return status;
 }
 
 
 /**
  * @brief Perform a soft reset on the device
  *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
  */
-void Sht3x::soft_reset() {
-    uint8_t cmds[2] = {SOFT_RESET_MSB, SOFT_RESET_LSB};
-    Serial.println("Sending soft-reset command");
-    I2C_STATUS status =  write_i2c_device(cmds, 2);
+Sht3x::I2C_STATUS Sht3x::soft_reset() {
+    SHT3X_LOG_INFO("Sending soft-reset command");
+    I2C_STATUS status = send_command((SOFT_RESET_MSB << 8) | SOFT_RESET_LSB);
+    if (status != I2C_STATUS::SUCCESS) {
+        SHT3X_LOG_ERROR("Failed to send soft-reset command");
+    } else {
+        this->heater_on = false;
+        this->acquisition_mode = AcquisitionMode::SINGLE_SHOT;
+    }
+    return status;
+}
 
+
+/**
+ * @brief Reset the sensor with the i2c general call.
+ *        Refer to datasheet section 4.9 page 12.
+ *        Every device on the bus that supports the general
+ *        call is reset as well.
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::general_call_reset() {
+    SHT3X_LOG_INFO("Sending general call reset");
+    uint8_t command = GENERAL_CALL_RESET_LSB;
+    I2C_STATUS status;
+#if SHT3X_TRACE
+    if (this->trace_replay != nullptr) {
+        status = replay_transaction(TRACE_RECORD_WRITE, &command, 1);
+    } else
+#endif
+    {
+        if (select_channel() != I2C_STATUS::SUCCESS) {
+            SHT3X_LOG_ERROR("Failed to select the mux channel");
+        }
+        SHT3X_TRACE_START(trace_us);
+        this->wire.beginTransmission(GENERAL_CALL_RESET_MSB);
+        this->wire.write(command);
+        status = to_i2c_status(this->wire.endTransmission());
+        SHT3X_TRACE_RECORD(this->trace_recorder, TRACE_RECORD_WRITE, GENERAL_CALL_RESET_MSB,
+            status, &command, 1, trace_us);
+    }
     if (status != I2C_STATUS::SUCCESS) {
-        Serial.println("Failed to send soft-reset command");
+        SHT3X_LOG_ERROR("Failed to send general call reset");
+    } else {
+        this->heater_on = false;
+        this->acquisition_mode = AcquisitionMode::SINGLE_SHOT;
     }
+    return status;
+}
+
+
+/**
+ * @brief Record that the sensor was reset without this driver,
+ *        for example by the general call reset of the driver of
+ *        another sensor on the bus, or by a brown out. The driver
+ *        then expects the sensor in single shot mode with the
+ *        heater off, as it is after a reset.
+ */
+void Sht3x::mark_reset() {
+    this->heater_on = false;
+    this->acquisition_mode = AcquisitionMode::SINGLE_SHOT;
 }
 
 
 /**
- * @brief Fetch results of the periodic measurements
+ * @brief Fetch results of the periodic measurements.
+ *        The last reading is kept if the fetch fails.
  *
+ * @return Sht3x::I2C_STATUS status of the fetch,
+ *         CRC_ERROR if the result was corrupted
  */
-void Sht3x::fetch_data() {
+Sht3x::I2C_STATUS Sht3x::fetch_data() {
     uint8_t cmds[2] = {FETCH_DATA_MSB, FETCH_DATA_LSB};
-    read_i2c_device(cmds, 2, this->i2c_data, 6);
+    I2C_STATUS status = read_i2c_device(cmds, 2, this->i2c_data, 6);
+    if (status == I2C_STATUS::SUCCESS) {
+        status = check_measurement_crc();
+    }
+    if (status != I2C_STATUS::SUCCESS) {
+        return status;
+    }
+
     this->read_temperature();
     this->read_relative_humidity();
+    this->last_fetch_us = micros();
+    return status;
 }
 
 
@@ -234,175 +664,704 @@ void Sht3x::fetch_data() {
  *        configuration
  *
  * @param mode mode combinations of mps and repeatabilties.
+ * @return Sht3x::I2C_STATUS status of the i2c comms,
+ *         INVALID_ARGUMENT for an unknown mode
  */
-void Sht3x::set_periodic_data_acquisition(uint8_t mode) {
-    /**At least give 10ms between this and calling fetch
-     * to avoid i2c timeout errors
-     * This delay is added at the end of this function
-    */
-    I2C_STATUS status;
-    if(mode == 1)  write_i2c_device(mps_modes.MODE1,  2);
-    else if(mode == 2)  write_i2c_device(mps_modes.MODE2,  2);
-    else if(mode == 3)  write_i2c_device(mps_modes.MODE3,  2);
-    else if(mode == 4)  write_i2c_device(mps_modes.MODE4,  2);
-    else if(mode == 5)  write_i2c_device(mps_modes.MODE5,  2);
-    else if(mode == 6)  write_i2c_device(mps_modes.MODE6,  2);
-    else if(mode == 7)  write_i2c_device(mps_modes.MODE7,  2);
-    else if(mode == 8)  write_i2c_device(mps_modes.MODE8,  2);
-    else if(mode == 9)  write_i2c_device(mps_modes.MODE9,  2);
-    else if(mode == 10) write_i2c_device(mps_modes.MODE10, 2);
-    else if(mode == 11) write_i2c_device(mps_modes.MODE11, 2);
-    else if(mode == 12) write_i2c_device(mps_modes.MODE12, 2);
-    else if(mode == 13) write_i2c_device(mps_modes.MODE13, 2);
-    else if(mode == 14) write_i2c_device(mps_modes.MODE14, 2);
-    else if(mode == 15) write_i2c_device(mps_modes.MODE15, 2);
-    else {
-      Serial.println("Periodic data acquisition mode not found");
+Sht3x::I2C_STATUS Sht3x::set_periodic_data_acquisition(uint8_t mode) {
+    if(mode < 1 || mode > 15) {
+      SHT3X_LOG_ERROR("Periodic data acquisition mode not found");
+      return I2C_STATUS::INVALID_ARGUMENT;
     }
 
+    return set_periodic_data_acquisition(static_cast<Mps>((mode - 1) / 3),
+        static_cast<Repeatability>((mode - 1) % 3));
+}
+
+
+/**
+ * @brief Perform periodic data acquisiton based on a
+ *        measurements per second (mps) and repeatability
+ *        configuration
+ *
+ * @param mps measurements per second
+ * @param repeatability repeatability of the measurements
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::set_periodic_data_acquisition(Mps mps, Repeatability repeatability) {
+    return start_periodic(pgm_read_word(&PERIODIC_COMMANDS[static_cast<uint8_t>(mps)]
+        [static_cast<uint8_t>(repeatability)]), mps, repeatability);
+}
+
+
+/**
+ * @brief Send a periodic data acquisition command.
+ *        The first result is ready after one conversion,
+ *        fetching earlier is NACKed by the sensor. Use
+ *        Sht3xFetchScheduler to fetch without waiting.
+ *
+ * @param command periodic data acquisition command
+ * @param mps measurements per second of the command
+ * @param repeatability repeatability of the command
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::start_periodic(uint16_t command, Mps mps, Repeatability repeatability) {
+    I2C_STATUS status = send_command(command);
+
     if(status != Sht3x::I2C_STATUS::SUCCESS) {
-        Serial.println("Error in i2c communications");
+        SHT3X_LOG_ERROR("Error in i2c communications");
+        return status;
     }
-    delay(10);
+
+    this->acquisition_mode = AcquisitionMode::PERIODIC;
+    this->periodic_mps = mps;
+    this->periodic_repeatability = repeatability;
+    this->acquisition_start_us = micros();
+    this->last_fetch_us = this->acquisition_start_us;
+    return status;
 }
 
 
 /**
- * @brief Read the status registers of the device.
- *        Parses and prints values to the serial terminal.
+ * @brief Read and decode the status register of the device.
  *
+ * @param device_status decoded status register
+ * @return Sht3x::I2C_STATUS status of the read,
+ *         CRC_ERROR if the status word was corrupted
  */
-void Sht3x::read_device_status() {
-    uint8_t cmds[2] = {READ_STATUS_REGISTER_MSB, READ_STATUS_REGISTER_LSB};
-    Serial.println("Reading device status");
+Sht3x::I2C_STATUS Sht3x::read_device_status(DeviceStatus &device_status) {
+    SHT3X_LOG_INFO("Reading device status");
 
-    I2C_STATUS status = read_i2c_device(cmds, 2, i2c_data_device_status,2);
+    uint16_t status_word;
+    I2C_STATUS status = read_status_word(status_word);
 
     if (status != I2C_STATUS::SUCCESS) {
-        Serial.println("Error reading the i2c device");
+        SHT3X_LOG_ERROR("Error reading the device status");
+        return status;
+    }
+
+    device_status.alert_pending = status_word & (0x1 << STATUS_ALERT_PENDING_BIT);
+    device_status.heater_on = status_word & (0x1 << STATUS_HEATER_BIT);
+    device_status.rh_alert = status_word & (0x1 << STATUS_RH_ALERT_BIT);
+    device_status.temperature_alert = status_word & (0x1 << STATUS_T_ALERT_BIT);
+    device_status.system_reset = status_word & (0x1 << STATUS_SYSTEM_RESET_BIT);
+    device_status.command_failed = status_word & (0x1 << STATUS_COMMAND_FAILED_BIT);
+    device_status.write_crc_failed = status_word & (0x1 << STATUS_WRITE_CRC_FAILED_BIT);
+    this->heater_on = device_status.heater_on;
+    return status;
+}
+
+
+/**
+ * @brief Read the status register word and check its CRC
+ *
+ * @param status_word status register contents
+ * @return Sht3x::I2C_STATUS status of the read,
+ *         CRC_ERROR if the word was corrupted
+ */
+Sht3x::I2C_STATUS Sht3x::read_status_word(uint16_t &status_word) {
+    uint8_t cmds[2] = {READ_STATUS_REGISTER_MSB, READ_STATUS_REGISTER_LSB};
+    uint8_t data[3] = {0}; /*Device status result is 3 bytes*/
+    I2C_STATUS status = read_i2c_device(cmds, 2, data, 3);
+    if (status != I2C_STATUS::SUCCESS) {
+        return status;
+    }
+
+    if (check_crc(data, 3) != I2C_STATUS::SUCCESS) {
+        SHT3X_PERF_COUNT(this->perf_counters, I2C_STATUS::CRC_ERROR);
+        return I2C_STATUS::CRC_ERROR;
     }
 
     /**Transfer the i2c data to the device status register*/
-    this->device_status = (i2c_data_device_status[0] << 8) | i2c_data_device_status[1];
+    status_word = (data[0] << 8) | data[1];
+    return status;
+}
 
-    if (device_status & (0x1 << 15)) {
-      Serial.println("Pending alerts PRESENT");
+
+/**
+ * @brief Clears the status register of the device.
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::clear_status_register() {
+    SHT3X_LOG_INFO("Clearing status register");
+    I2C_STATUS status = send_command((CLEAR_STATUS_REGISTER_MSB << 8) | CLEAR_STATUS_REGISTER_LSB);
+    if (status != I2C_STATUS::SUCCESS) {
+      SHT3X_LOG_ERROR("I2C write error");
+    }
+    return status;
+}
+
+
+/**
+ * @brief Enables the device heater.
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::enable_heater() {
+    SHT3X_LOG_INFO("Enabling the heater");
+    I2C_STATUS status = send_command((HEATER_EN_MSB << 8) | HEATER_EN_LSB);
+    if (status != I2C_STATUS::SUCCESS) {
+      SHT3X_LOG_ERROR("I2C write error");
     } else {
-      Serial.println("Pending alerts NONE");
+      this->heater_on = true;
     }
+    return status;
+}
 
 
-    if (device_status & (0x1 << 13)) {
-      Serial.println("Heater ON");
-      this->heater_on  = true;
+/**
+ * @brief Disables the device heater.
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::disable_heater() {
+    SHT3X_LOG_INFO("Disable heater");
+    I2C_STATUS status = send_command((HEATER_DIS_MSB << 8) | HEATER_DIS_LSB);
+    if (status != I2C_STATUS::SUCCESS) {
+      SHT3X_LOG_ERROR("I2C write error");
     } else {
-      Serial.println("Heater OFF");
       this->heater_on = false;
     }
+    return status;
+}
 
 
-    if (device_status & (0x1 << 11)) {
-      Serial.println("RH tracking alert");
+/**
+ * @brief Puts the device in a 4Hz measurement mode.
+ *        Need to call the fetch command to read the data.
+ *        The first result is ready after one conversion,
+ *        fetching earlier is NACKed by the sensor.
+ *
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::art_4_hz_measurements() {
+    SHT3X_LOG_INFO("Starting 4Hz measurements");
+    I2C_STATUS status = send_command((ART_4HZ_MSB << 8) | ART_4HZ_LSB);
+    if (status != I2C_STATUS::SUCCESS) {
+      SHT3X_LOG_ERROR("I2C write error");
+      return status;
     }
-    else {
-      Serial.println("RH tracking alert NONE");
+
+    this->acquisition_mode = AcquisitionMode::ART;
+    this->acquisition_start_us = micros();
+    this->last_fetch_us = this->acquisition_start_us;
+    return status;
+}
+
+
+/**
+ * @brief Start a single shot measurement without blocking.
+ *        Modes 1-3 are issued as their no clock stretching
+ *        equivalents 4-6 so the bus is never held during
+ *        the conversion. Use poll() to check for the result
+ *        and collect() to read it.
+ *
+ * @param mode clock streching and repeatability selection
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::start_single_shot(uint8_t mode) {
+    if (mode < 1 || mode > 6) {
+        this->measurement_state = MeasurementState::FAILED;
+        return I2C_STATUS::INVALID_ARGUMENT;
     }
+    return start_single_shot(static_cast<Repeatability>((mode - 1) % 3));
+}
+
 
+/**
+ * @brief Start a single shot measurement without blocking
+ *        and without clock stretching
+ *
+ * @param repeatability repeatability of the measurement
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::start_single_shot(Repeatability repeatability) {
+    uint16_t command = pgm_read_word(&SINGLE_SHOT_COMMANDS
+        [static_cast<uint8_t>(ClockStretching::STRETCHING_DISABLED)]
+        [static_cast<uint8_t>(repeatability)]);
+    return begin_single_shot(command, repeatability);
+}
+
+
+/**
+ * @brief Send a single shot command without clock stretching
+ *        and start tracking its conversion time
+ *
+ * @param command single shot measurement command
+ * @param repeatability repeatability of the command
+ * @return Sht3x::I2C_STATUS status of the i2c comms
+ */
+Sht3x::I2C_STATUS Sht3x::begin_single_shot(uint16_t command, Repeatability repeatability) {
+    this->pending_repeatability = repeatability;
+    I2C_STATUS status = send_command(command);
+    this->conversion_start_us = micros();
 
-    if (device_status & (0x1 << 10)) {
-      Serial.println("Temperature tracking alert");
+    if (status == I2C_STATUS::SUCCESS) {
+        this->measurement_state = MeasurementState::NOT_READY;
     } else {
-      Serial.println("Temperature tracking alert NONE");
+        this->measurement_state = MeasurementState::FAILED;
     }
+    return status;
+}
 
 
-    if (device_status & (0x1 << 4)) {
-      Serial.println("System reset detected");
-    } else {
-      Serial.println("System reset NONE");
+/**
+ * @brief Check if the measurement started with start_single_shot()
+ *        has finished. Never blocks: the bus is not touched until
+ *        the maximum conversion time for the repeatability has
+ *        passed, then the result is read if the sensor ACKs.
+ *        A result that is not available after twice the
+ *        conversion time is reported as FAILED.
+ *
+ * @return Sht3x::MeasurementState state of the measurement
+ */
+Sht3x::MeasurementState Sht3x::poll() {
+    if (this->measurement_state != MeasurementState::NOT_READY) {
+        return this->measurement_state;
     }
 
-    if (device_status & (0x1 << 1)) {
-      Serial.println("Last command did not execute");
+    uint32_t duration_us = sht3x_measurement_duration_us(this->pending_repeatability);
+
+    uint32_t elapsed_us = micros() - this->conversion_start_us;
+    if (elapsed_us < duration_us) {
+        return MeasurementState::NOT_READY;
+    }
+
+    if (receive_i2c_device(this->i2c_data, 6) == I2C_STATUS::SUCCESS) {
+        this->single_shot_latency_us[static_cast<uint8_t>(this->pending_repeatability)] =
+            micros() - this->conversion_start_us;
+        this->measurement_state = MeasurementState::READY;
+    } else if (elapsed_us > 2 * duration_us) {
+        this->measurement_state = MeasurementState::FAILED;
     } else {
-      Serial.println("Last command executed");
+        SHT3X_PERF_RETRY(this->perf_counters);
     }
+    return this->measurement_state;
+}
 
 
-    if (device_status & (0x1 << 0)) {
-      Serial.println("Checksum failed");
-    } else {
-      Serial.println("Checksum passed");
+/**
+ * @brief Convert the result of a finished single shot
+ *        measurement. The values are then available from
+ *        get_temperature() and get_rh().
+ *
+ * @return Sht3x::I2C_STATUS SUCCESS when a result was read,
+ *         CRC_ERROR if it was corrupted, WIRE_AVAILABLE_FALSE
+ *         if no result is ready
+ */
+Sht3x::I2C_STATUS Sht3x::collect() {
+    if (this->measurement_state != MeasurementState::READY) {
+        return I2C_STATUS::WIRE_AVAILABLE_FALSE;
+    }
+
+    this->measurement_state = MeasurementState::IDLE;
+    I2C_STATUS status = check_measurement_crc();
+    if (status != I2C_STATUS::SUCCESS) {
+        return status;
     }
 
-    Serial.println("=========================================================");
+    this->read_temperature();
+    this->read_relative_humidity();
+    return status;
+}
+
 
+/**
+ * @brief Get the time from the start of the last non-blocking
+ *        single shot measurement to the result being read
+ *
+ * @param mode single shot measurement mode 1-6
+ * @return uint32_t latency in us, 0 if no measurement finished yet
+ */
+uint32_t Sht3x::get_single_shot_latency_us(uint8_t mode) {
+    if (mode < 1 || mode > 6) {
+        return 0;
+    }
+    return get_single_shot_latency_us(static_cast<Repeatability>((mode - 1) % 3));
 }
 
 
 /**
- * @brief Clears the status register of the device.
+ * @brief Get the time from the start of the last non-blocking
+ *        single shot measurement to the result being read
  *
+ * @param repeatability repeatability of the measurement
+ * @return uint32_t latency in us, 0 if no measurement finished yet
  */
-void Sht3x::clear_status_register() {
-    Serial.println("Clearing status register");
-    uint8_t cmds[2] = {CLEAR_STATUS_REGISTER_MSB, CLEAR_STATUS_REGISTER_LSB};
-    I2C_STATUS status =  write_i2c_device(cmds, 2);
-    if (status != I2C_STATUS::SUCCESS) {
-      Serial.println("I2C write error");
-    } else {
-      Serial.println("Complete clearing status register");
+uint32_t Sht3x::get_single_shot_latency_us(Repeatability repeatability) {
+    return this->single_shot_latency_us[static_cast<uint8_t>(repeatability)];
+}
+
+
+/**
+ * @brief Write one of the four alert limits.
+ *        Only the 7 MSBs of rh and the 9 MSBs of temperature
+ *        are stored, about 0.8 %RH and 0.34 C resolution.
+ *
+ * @param limit limit to write
+ * @param temperature_centi temperature limit in 0.01 C, -4500 to 13000
+ * @param rh_centi rh limit in 0.01 %, 0 to 10000
+ * @return Sht3x::I2C_STATUS status of the i2c comms,
+ *         INVALID_ARGUMENT for a limit out of the sensor range
+ */
+Sht3x::I2C_STATUS Sht3x::write_alert_limit(AlertLimit limit,
+    int16_t temperature_centi, uint16_t rh_centi) {
+    if (temperature_centi < SHT3X_TEMPERATURE_CENTI_MIN || temperature_centi > SHT3X_TEMPERATURE_CENTI_MAX
+        || rh_centi > SHT3X_RH_CENTI_MAX) {
+        SHT3X_LOG_ERROR("Alert limit out of range");
+        return I2C_STATUS::INVALID_ARGUMENT;
     }
+
+    uint8_t lsb = WRITE_ALERT_HIGH_SET_LSB;
+    if (limit == AlertLimit::HIGH_CLEAR) lsb = WRITE_ALERT_HIGH_CLEAR_LSB;
+    else if (limit == AlertLimit::LOW_CLEAR) lsb = WRITE_ALERT_LOW_CLEAR_LSB;
+    else if (limit == AlertLimit::LOW_SET) lsb = WRITE_ALERT_LOW_SET_LSB;
+
+    uint16_t word = sht3x_alert_limit_pack(sht3x_temperature_raw(temperature_centi),
+        sht3x_rh_raw(rh_centi));
+    uint8_t cmds[5] = {WRITE_ALERT_LIMIT_MSB, lsb, (uint8_t)(word >> 8), (uint8_t)word, 0};
+    cmds[4] = sht3x_crc8(cmds + 2, 2);
+    return write_i2c_device(cmds, 5);
 }
 
 
 /**
- * @brief Enables the device heater.
+ * @brief Read back one of the four alert limits
  *
+ * @param limit limit to read
+ * @param temperature_centi temperature limit in 0.01 C
+ * @param rh_centi rh limit in 0.01 %
+ * @return Sht3x::I2C_STATUS status of the i2c comms,
+ *         CRC_ERROR if the limit was corrupted
  */
-void Sht3x::enable_heater() {
-    Serial.println("Enabling the heater");
-    uint8_t cmds[2] = {HEATER_EN_MSB, HEATER_EN_LSB};
-    I2C_STATUS status =  write_i2c_device(cmds, 2);
+Sht3x::I2C_STATUS Sht3x::read_alert_limit(AlertLimit limit,
+    int16_t &temperature_centi, uint16_t &rh_centi) {
+    uint8_t lsb = READ_ALERT_HIGH_SET_LSB;
+    if (limit == AlertLimit::HIGH_CLEAR) lsb = READ_ALERT_HIGH_CLEAR_LSB;
+    else if (limit == AlertLimit::LOW_CLEAR) lsb = READ_ALERT_LOW_CLEAR_LSB;
+    else if (limit == AlertLimit::LOW_SET) lsb = READ_ALERT_LOW_SET_LSB;
+
+    uint8_t cmds[2] = {READ_ALERT_LIMIT_MSB, lsb};
+    uint8_t data[3] = {0};
+    I2C_STATUS status = read_i2c_device(cmds, 2, data, 3);
     if (status != I2C_STATUS::SUCCESS) {
-      Serial.println("I2C write error");
-    } else {
-      Serial.println("Complete enabling the heater");
+        return status;
     }
+    if (check_crc(data, 3) != I2C_STATUS::SUCCESS) {
+        SHT3X_PERF_COUNT(this->perf_counters, I2C_STATUS::CRC_ERROR);
+        return I2C_STATUS::CRC_ERROR;
+    }
+
+    uint16_t word = (data[0] << 8) | data[1];
+    temperature_centi = sht3x_temperature_centi(sht3x_alert_limit_temperature_raw(word));
+    rh_centi = sht3x_rh_centi(sht3x_alert_limit_rh_raw(word));
+    return status;
 }
 
 
 /**
- * @brief Disables the device heater.
+ * @brief Record that the ALERT pin fired.
+ *        Safe to call from the pin interrupt handler, it
+ *        does not touch the bus.
+ */
+void Sht3x::notify_alert() {
+    this->alert_flag = true;
+}
+
+
+/**
+ * @brief Check if the ALERT pin fired since the last
+ *        call to service_alert()
+ */
+bool Sht3x::alert_pending() {
+    return this->alert_flag;
+}
+
+
+/**
+ * @brief Handle an ALERT pin event from loop().
+ *        The bus is only used when notify_alert() was called,
+ *        then the status register is read and the tracking
+ *        alert bits are decoded.
  *
+ * @param alert decoded alert state, all false if the pin
+ *        did not fire
+ * @return Sht3x::I2C_STATUS status of the status register read
  */
-void Sht3x::disable_heater() {
-    Serial.println("Disable heater");
-    uint8_t cmds[2] = {HEATER_DIS_MSB, HEATER_DIS_LSB};
-    I2C_STATUS status =  write_i2c_device(cmds, 2);
+Sht3x::I2C_STATUS Sht3x::service_alert(AlertStatus &alert) {
+    alert.pending = false;
+    alert.rh_alert = false;
+    alert.temperature_alert = false;
+    if (!this->alert_flag) {
+        return I2C_STATUS::SUCCESS;
+    }
+    this->alert_flag = false;
+
+    uint16_t status_word;
+    I2C_STATUS status = read_status_word(status_word);
     if (status != I2C_STATUS::SUCCESS) {
-      Serial.println("I2C write error");
-    } else {
-      Serial.println("Complete disabling the heater");
+        return status;
     }
+
+    alert.pending = status_word & (0x1 << STATUS_ALERT_PENDING_BIT);
+    alert.rh_alert = status_word & (0x1 << STATUS_RH_ALERT_BIT);
+    alert.temperature_alert = status_word & (0x1 << STATUS_T_ALERT_BIT);
+    return status;
 }
 
 
 /**
- * @brief Puts the device in a 4Hz measurement mode.
- *        Need to call the fetch command to read the data.
- *        Delay at least 10ms to avoid getting a NACK from
- *        Sensor
+ * @brief Get the measurement mode the sensor was last
+ *        configured for
+ */
+Sht3x::AcquisitionMode Sht3x::get_acquisition_mode() {
+    return this->acquisition_mode;
+}
+
+
+/**
+ * @brief Get the measurements per second of the last
+ *        periodic data acquisition mode
+ */
+Mps Sht3x::get_mps() {
+    return this->periodic_mps;
+}
+
+
+/**
+ * @brief Get the repeatability of the last periodic data
+ *        acquisition mode
+ */
+Repeatability Sht3x::get_repeatability() {
+    return this->periodic_repeatability;
+}
+
+
+/**
+ * @brief Get the nominal time between two measurements
+ *
+ * @return uint32_t period in ms, 0 in single shot mode
+ */
+uint32_t Sht3x::get_period_ms() {
+    if (this->acquisition_mode == AcquisitionMode::PERIODIC) {
+        return sht3x_period_ms(this->periodic_mps);
+    } else if (this->acquisition_mode == AcquisitionMode::ART) {
+        return ART_PERIOD_MS;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Get the time periodic or ART acquisition was started
  *
+ * @return uint32_t micros() when the command was sent
  */
-void Sht3x::art_4_hz_measurements() {
-    Serial.println("Starting 4Hz measurements");
-    uint8_t cmds[2] = {ART_4HZ_MSB, ART_4HZ_LSB};
-    I2C_STATUS status =  write_i2c_device(cmds, 2);
+uint32_t Sht3x::get_acquisition_start_us() {
+    return this->acquisition_start_us;
+}
+
+
+/**
+ * @brief Get the heater state as last set or read from
+ *        the status register
+ */
+bool Sht3x::is_heater_on() {
+    return this->heater_on;
+}
+
+
+/**
+ * @brief Save the acquisition mode, the heater state and the
+ *        age of the last fetch, to resume() after the MCU
+ *        rebooted or woke up from deep sleep. No bus access.
+ *
+ * @param state filled with the current state
+ */
+void Sht3x::save_state(State &state) {
+    state.magic = STATE_MAGIC;
+    state.acquisition_mode = static_cast<uint8_t>(this->acquisition_mode);
+    state.mps = static_cast<uint8_t>(this->periodic_mps);
+    state.repeatability = static_cast<uint8_t>(this->periodic_repeatability);
+    state.heater_on = this->heater_on;
+    state.fetch_age_ms = (micros() - this->last_fetch_us) / 1000UL;
+    state.crc = state_crc(state);
+}
+
+
+/**
+ * @brief Take over a sensor that kept running while the MCU
+ *        rebooted or slept. A single status read checks the
+ *        system reset flag: when it is clear the sensor still
+ *        runs in the saved mode and nothing is sent, when it
+ *        is set the sensor lost power or was reset, the flag
+ *        is cleared and the saved mode and heater state are
+ *        configured again.
+ *
+ * @param state state saved with save_state()
+ * @param slept_ms time between save_state() and resume(),
+ *        only used to predict the next sample for
+ *        Sht3xFetchScheduler, 0 when not known
+ * @return Sht3x::I2C_STATUS status of the i2c comms,
+ *         INVALID_ARGUMENT if the state was never saved or
+ *         is corrupted. Nothing is sent then, the caller
+ *         configures the sensor and clears the status
+ *         register, so the next resume() can rely on the
+ *         reset flag.
+ */
+Sht3x::I2C_STATUS Sht3x::resume(const State &state, uint32_t slept_ms) {
+    if (state.magic != STATE_MAGIC || state.crc != state_crc(state)
+        || state.acquisition_mode > static_cast<uint8_t>(AcquisitionMode::ART)
+        || state.mps > static_cast<uint8_t>(Mps::MPS_10)
+        || state.repeatability > static_cast<uint8_t>(Repeatability::LOW_REPEATABILITY)) {
+        SHT3X_LOG_INFO("No saved state to resume");
+        return I2C_STATUS::INVALID_ARGUMENT;
+    }
+
+    uint16_t status_word;
+    I2C_STATUS status = read_status_word(status_word);
     if (status != I2C_STATUS::SUCCESS) {
-      Serial.println("I2C write error");
-    } else {
-      Serial.println("Complete configuring device for 4Hz measurements");
+        return status;
+    }
+
+    AcquisitionMode mode = static_cast<AcquisitionMode>(state.acquisition_mode);
+    Mps mps = static_cast<Mps>(state.mps);
+    Repeatability repeatability = static_cast<Repeatability>(state.repeatability);
+
+    if (status_word & (0x1 << STATUS_SYSTEM_RESET_BIT)) {
+        SHT3X_LOG_INFO("Sensor was reset, configuring it again");
+        this->heater_on = false;
+        this->acquisition_mode = AcquisitionMode::SINGLE_SHOT;
+        this->periodic_mps = mps;
+        this->periodic_repeatability = repeatability;
+        status = clear_status_register();
+        if (status == I2C_STATUS::SUCCESS && state.heater_on) {
+            status = enable_heater();
+        }
+        if (status == I2C_STATUS::SUCCESS && mode == AcquisitionMode::PERIODIC) {
+            status = set_periodic_data_acquisition(mps, repeatability);
+        } else if (status == I2C_STATUS::SUCCESS && mode == AcquisitionMode::ART) {
+            status = art_4_hz_measurements();
+        }
+        return status;
     }
-    delay(10);
+
+    this->acquisition_mode = mode;
+    this->periodic_mps = mps;
+    this->periodic_repeatability = repeatability;
+    this->heater_on = status_word & (0x1 << STATUS_HEATER_BIT);
+
+    /*Place the acquisition start so the next sample is expected
+      one period after the last fetch, or now if that passed*/
+    uint32_t period_ms = get_period_ms();
+    uint32_t elapsed_ms = state.fetch_age_ms + slept_ms;
+    uint32_t remaining_us = elapsed_ms >= period_ms ? 0 : (period_ms - elapsed_ms) * 1000UL;
+    uint32_t duration_us = sht3x_measurement_duration_us(mode == AcquisitionMode::PERIODIC
+        ? repeatability : Repeatability::HIGH_REPEATABILITY);
+    uint32_t now_us = micros();
+    this->acquisition_start_us = now_us + remaining_us - duration_us;
+    this->last_fetch_us = now_us + remaining_us - period_ms * 1000UL;
+    return status;
+}
+
+
+/**
+ * @brief Checksum of a saved state
+ *
+ * @param state saved state
+ * @return uint8_t CRC-8 of all fields but the crc
+ */
+uint8_t Sht3x::state_crc(const State &state) {
+    uint8_t data[9] = {state.magic, state.acquisition_mode, state.mps, state.repeatability,
+        state.heater_on, (uint8_t)(state.fetch_age_ms >> 24), (uint8_t)(state.fetch_age_ms >> 16),
+        (uint8_t)(state.fetch_age_ms >> 8), (uint8_t)state.fetch_age_ms};
+    return sht3x_crc8(data, 9);
 }
+
+
+/**
+ * @brief Get the multiplexer the sensor is attached to
+ *
+ * @return Sht3xMux* nullptr for a sensor directly on the bus
+ */
+Sht3xMux *Sht3x::get_mux() {
+    return this->mux;
+}
+
+
+/**
+ * @brief Get the multiplexer channel of the sensor
+ *
+ * @return uint8_t channel 0-7, 0 without a mux
+ */
+uint8_t Sht3x::get_mux_channel() {
+    return this->mux_channel;
+}
+
+
+#if SHT3X_PERF_COUNTERS
+/**
+ * @brief Get the transport counters and latency histogram
+ *        collected since startup or the last reset
+ *
+ * @return const Sht3xPerfCounters& counters of this sensor
+ */
+const Sht3xPerfCounters &Sht3x::get_perf_counters() {
+    return this->perf_counters;
+}
+
+
+/**
+ * @brief Set all performance counters to zero
+ */
+void Sht3x::reset_perf_counters() {
+    this->perf_counters = {};
+}
+#endif
+
+
+#if SHT3X_TRACE
+/**
+ * @brief Record every transaction of the sensor from now on
+ *
+ * @param recorder recorder started with start(), nullptr to
+ *        stop recording
+ */
+void Sht3x::set_trace_recorder(Sht3xTraceRecorder *recorder) {
+    this->trace_recorder = recorder;
+}
+
+
+/**
+ * @brief Take the transactions of the sensor from a trace
+ *        instead of the bus
+ *
+ * @param replay trace to play, nullptr to go back to the bus
+ */
+void Sht3x::set_trace_replay(Sht3xTraceReplay *replay) {
+    this->trace_replay = replay;
+}
+
+
+/**
+ * @brief Answer a transaction from the replayed trace
+ *
+ * @param kind TRACE_RECORD_WRITE or TRACE_RECORD_READ
+ * @param buffer bytes written, or filled with the bytes read
+ * @param buffer_size number of bytes
+ * @return Sht3x::I2C_STATUS recorded status, OTHER_ERROR at
+ *         the end of the trace
+ */
+Sht3x::I2C_STATUS Sht3x::replay_transaction(uint8_t kind, uint8_t *buffer, uint8_t buffer_size) {
+    uint8_t status;
+    bool replayed = kind == TRACE_RECORD_WRITE
+        ? this->trace_replay->replay_write(buffer, buffer_size, status)
+        : this->trace_replay->replay_read(buffer, buffer_size, status);
+
+    if (!replayed || status > static_cast<uint8_t>(I2C_STATUS::INVALID_ARGUMENT)) {
+        return I2C_STATUS::OTHER_ERROR;
+    }
+    return static_cast<I2C_STATUS>(status);
+}
+#endif
+
@@ -0,0 +1,310 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "Arduino.h"
+#include "sht3x-dis-model.h"
+
+HardwareSerial Serial;
+
+static uint8_t pin_modes[HOST_PIN_COUNT] = {0};
+static uint8_t pin_levels[HOST_PIN_COUNT] = {0};
+
+
+uint32_t millis() {
+    SimClock::advance_us(SIM_CALL_COST_US);
+    return (uint32_t)(SimClock::now_us() / 1000);
+}
+
+
+uint32_t micros() {
+    SimClock::advance_us(SIM_CALL_COST_US);
+    return (uint32_t)SimClock::now_us();
+}
+
+
+void delay(uint32_t ms) {
+    SimClock::advance_us((uint64_t)ms * 1000);
+}
+
+
+void delayMicroseconds(uint32_t us) {
+    SimClock::advance_us(us);
+}
+
+
+void yield() {
+}
+
+
+/**
+ * @brief Level of an open drain line, low only while the pin
+ *        drives it low
+ */
+static bool line_high(uint8_t pin) {
+    return !(pin_modes[pin] == OUTPUT && pin_levels[pin] == LOW);
+}
+
+
+/**
+ * @brief Set the mode of a pin. A pin of a simulated bus is
+ *        taken away from its TwoWire, and releasing SCL clocks
+ *        the devices on the bus.
+ */
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= HOST_PIN_COUNT) {
+        return;
+    }
+    bool was_high = line_high(pin);
+    pin_modes[pin] = mode;
+    SimBus::pin_mode_changed(pin);
+    if (!was_high && line_high(pin)) {
+        SimBus::scl_released(pin);
+    }
+}
+
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin >= HOST_PIN_COUNT) {
+        return;
+    }
+    bool was_high = line_high(pin);
+    pin_levels[pin] = value;
+    if (!was_high && line_high(pin)) {
+        SimBus::scl_released(pin);
+    }
+}
+
+
+int digitalRead(uint8_t pin) {
+    if (pin >= HOST_PIN_COUNT) {
+        return LOW;
+    }
+    if (SimBus::sda_held_low(pin)) {
+        return LOW;
+    }
+    return line_high(pin) ? HIGH : LOW;
+}
+
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode) {
+    (void)interrupt;
+    (void)handler;
+    (void)mode;
+}
+
+
+void detachInterrupt(uint8_t interrupt) {
+    (void)interrupt;
+}
+
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t written = 0;
+    while (size--) {
+        written += write(*buffer++);
+    }
+    return written;
+}
+
+
+size_t Print::write(const char *string) {
+    return write(reinterpret_cast<const uint8_t *>(string), strlen(string));
+}
+
+
+size_t Print::print(const __FlashStringHelper *string) {
+    return write(reinterpret_cast<const char *>(string));
+}
+
+
+size_t Print::print(const char *string) {
+    return write(string);
+}
+
+
+size_t Print::print(char character) {
+    return write((uint8_t)character);
+}
+
+
+size_t Print::print(unsigned char value, int base) {
+    return print_number(value, base);
+}
+
+
+size_t Print::print(int value, int base) {
+    return print((long)value, base);
+}
+
+
+size_t Print::print(unsigned int value, int base) {
+    return print_number(value, base);
+}
+
+
+size_t Print::print(long value, int base) {
+    if (base == DEC && value < 0) {
+        return write('-') + print_number(0UL - (unsigned long)value, base);
+    }
+    return print_number((unsigned long)value, base);
+}
+
+
+size_t Print::print(unsigned long value, int base) {
+    return print_number(value, base);
+}
+
+
+size_t Print::print(double value, int digits) {
+    return print_float(value, digits);
+}
+
+
+size_t Print::println(const __FlashStringHelper *string) {
+    return print(string) + println();
+}
+
+
+size_t Print::println(const char *string) {
+    return print(string) + println();
+}
+
+
+size_t Print::println(char character) {
+    return print(character) + println();
+}
+
+
+size_t Print::println(unsigned char value, int base) {
+    return print(value, base) + println();
+}
+
+
+size_t Print::println(int value, int base) {
+    return print(value, base) + println();
+}
+
+
+size_t Print::println(unsigned int value, int base) {
+    return print(value, base) + println();
+}
+
+
+size_t Print::println(long value, int base) {
+    return print(value, base) + println();
+}
+
+
+size_t Print::println(unsigned long value, int base) {
+    return print(value, base) + println();
+}
+
+
+size_t Print::println(double value, int digits) {
+    return print(value, digits) + println();
+}
+
+
+size_t Print::println() {
+    return write("\r\n");
+}
+
+
+size_t Print::print_number(unsigned long value, int base) {
+    char buffer[8 * sizeof(long) + 1];
+    char *digit = &buffer[sizeof(buffer) - 1];
+    *digit = '\0';
+    if (base < 2) {
+        base = DEC;
+    }
+    do {
+        unsigned long remainder = value % base;
+        value /= base;
+        *--digit = remainder < 10 ? '0' + remainder : 'A' + remainder - 10;
+    } while (value != 0);
+    return write(digit);
+}
+
+
+size_t Print::print_float(double value, int digits) {
+    if (isnan(value)) return write("nan");
+    if (isinf(value)) return write("inf");
+    if (value > 4294967040.0 || value < -4294967040.0) return write("ovf");
+
+    size_t written = 0;
+    if (value < 0.0) {
+        written += write('-');
+        value = -value;
+    }
+    double rounding = 0.5;
+    for (int i = 0; i < digits; i++) {
+        rounding /= 10.0;
+    }
+    value += rounding;
+
+    unsigned long integer = (unsigned long)value;
+    double remainder = value - (double)integer;
+    written += print_number(integer, DEC);
+    if (digits > 0) {
+        written += write('.');
+    }
+    while (digits-- > 0) {
+        remainder *= 10.0;
+        unsigned int digit = (unsigned int)remainder;
+        written += write((uint8_t)('0' + digit));
+        remainder -= digit;
+    }
+    return written;
+}
+
+
+void HardwareSerial::begin(unsigned long baud_rate) {
+    (void)baud_rate;
+}
+
+
+void HardwareSerial::end() {
+}
+
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+
+size_t HardwareSerial::write(uint8_t byte) {
+    return fputc(byte, stdout) == EOF ? 0 : 1;
+}
+
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+
+HardwareSerial::operator bool() {
+    return true;
+}
@@ -0,0 +1,151 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_HOST_ARDUINO_H
+#define SHT3X_HOST_ARDUINO_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * Stand-in for the Arduino core to build the library and its
+ * tests on a Linux host. Only what the library and examples
+ * use is provided. Time is simulated: millis() and micros()
+ * read the clock of the device model in sht3x-dis-model.h,
+ * and delay() advances it without sleeping.
+ *
+ * ARDUINO is deliberately not defined, code that checks for it
+ * takes its host path, for example the std::thread executor of
+ * the sampler.
+ */
+
+#define HIGH                            0x1
+#define LOW                             0x0
+
+#define INPUT                           0x0
+#define OUTPUT                          0x1
+#define INPUT_PULLUP                    0x2
+
+#define CHANGE                          1
+#define FALLING                         2
+#define RISING                          3
+
+#define DEC                             10
+#define HEX                             16
+#define OCT                             8
+#define BIN                             2
+
+/*Pins of the default bus, as on the Arduino Mega*/
+#define SDA                             20
+#define SCL                             21
+#define HOST_PIN_COUNT                  64
+
+#define PROGMEM
+#define pgm_read_byte(address)          (*(const uint8_t *)(address))
+#define pgm_read_word(address)          (*(const uint16_t *)(address))
+#define pgm_read_dword(address)         (*(const uint32_t *)(address))
+#define pgm_read_float(address)         (*(const float *)(address))
+#define pgm_read_ptr(address)           (*(const void * const *)(address))
+
+class __FlashStringHelper;
+#define F(string_literal)               (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+#define digitalPinToInterrupt(pin)      (pin)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+
+/**
+ * @brief Formatted output as in the Arduino core, numbers
+ *        are printed in the given base and floats with the
+ *        given number of digits
+ */
+class Print {
+    public:
+        virtual ~Print() = default;
+        virtual size_t write(uint8_t byte) = 0;
+        virtual size_t write(const uint8_t *buffer, size_t size);
+        size_t write(const char *string);
+
+        size_t print(const __FlashStringHelper *string);
+        size_t print(const char *string);
+        size_t print(char character);
+        size_t print(unsigned char value, int base = DEC);
+        size_t print(int value, int base = DEC);
+        size_t print(unsigned int value, int base = DEC);
+        size_t print(long value, int base = DEC);
+        size_t print(unsigned long value, int base = DEC);
+        size_t print(double value, int digits = 2);
+
+        size_t println(const __FlashStringHelper *string);
+        size_t println(const char *string);
+        size_t println(char character);
+        size_t println(unsigned char value, int base = DEC);
+        size_t println(int value, int base = DEC);
+        size_t println(unsigned int value, int base = DEC);
+        size_t println(long value, int base = DEC);
+        size_t println(unsigned long value, int base = DEC);
+        size_t println(double value, int digits = 2);
+        size_t println();
+
+    private:
+        size_t print_number(unsigned long value, int base);
+        size_t print_float(double value, int digits);
+};
+
+
+/**
+ * @brief Serial port writing to the standard output
+ */
+class HardwareSerial : public Print {
+    public:
+        void begin(unsigned long baud_rate);
+        void end();
+        void flush();
+        size_t write(uint8_t byte) override;
+        size_t write(const uint8_t *buffer, size_t size) override;
+        using Print::write;
+        operator bool();
+};
+
+extern HardwareSerial Serial;
+
+#endif
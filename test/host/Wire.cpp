@@ -0,0 +1,171 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "Wire.h"
+#include "sht3x-dis-model.h"
+
+TwoWire Wire;
+TwoWire Wire1;
+
+
+TwoWire::TwoWire(): bus{new SimBus()} {
+}
+
+
+TwoWire::~TwoWire() {
+    delete this->bus;
+}
+
+
+void TwoWire::begin() {
+    if (this->started) {
+        return;
+    }
+    this->started = true;
+    this->bus->set_clock(SIM_DEFAULT_CLOCK_HZ);
+    this->bus->attach_pins();
+}
+
+
+void TwoWire::begin(int sda_pin, int scl_pin) {
+    if (this->started) {
+        return;
+    }
+    this->bus->set_pins(sda_pin, scl_pin);
+    begin();
+}
+
+
+void TwoWire::end() {
+    this->started = false;
+}
+
+
+void TwoWire::setClock(uint32_t clock_hz) {
+    this->bus->set_clock(clock_hz);
+}
+
+
+void TwoWire::beginTransmission(uint8_t address) {
+    this->tx_address = address;
+    this->tx_size = 0;
+    this->tx_overflow = false;
+}
+
+
+void TwoWire::beginTransmission(int address) {
+    beginTransmission((uint8_t)address);
+}
+
+
+uint8_t TwoWire::endTransmission(bool send_stop) {
+    (void)send_stop;
+    if (!this->started) {
+        return 4;
+    }
+    if (this->tx_overflow) {
+        return 1;
+    }
+    return this->bus->write(this->tx_address, this->tx_buffer, this->tx_size);
+}
+
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool send_stop) {
+    (void)send_stop;
+    this->rx_size = 0;
+    this->rx_index = 0;
+    if (!this->started) {
+        return 0;
+    }
+    if (quantity > WIRE_BUFFER_LENGTH) {
+        quantity = WIRE_BUFFER_LENGTH;
+    }
+    this->rx_size = this->bus->read(address, this->rx_buffer, quantity);
+    return this->rx_size;
+}
+
+
+uint8_t TwoWire::requestFrom(int address, int quantity) {
+    return requestFrom((uint8_t)address, (uint8_t)quantity, true);
+}
+
+
+size_t TwoWire::write(uint8_t byte) {
+    if (this->tx_size >= WIRE_BUFFER_LENGTH) {
+        this->tx_overflow = true;
+        return 0;
+    }
+    this->tx_buffer[this->tx_size++] = byte;
+    return 1;
+}
+
+
+size_t TwoWire::write(const uint8_t *buffer, size_t size) {
+    size_t written = 0;
+    while (size-- && write(*buffer++)) {
+        written++;
+    }
+    return written;
+}
+
+
+int TwoWire::available() {
+    return this->rx_size - this->rx_index;
+}
+
+
+int TwoWire::read() {
+    if (this->rx_index >= this->rx_size) {
+        return -1;
+    }
+    return this->rx_buffer[this->rx_index++];
+}
+
+
+int TwoWire::peek() {
+    if (this->rx_index >= this->rx_size) {
+        return -1;
+    }
+    return this->rx_buffer[this->rx_index];
+}
+
+
+void TwoWire::flush() {
+}
+
+
+/**
+ * @brief Get the simulated bus, to attach device models and
+ *        read the transfer counters
+ */
+SimBus &TwoWire::get_bus() {
+    return *this->bus;
+}
+
+
+bool TwoWire::is_started() {
+    return this->started;
+}
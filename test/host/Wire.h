@@ -0,0 +1,91 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_HOST_WIRE_H
+#define SHT3X_HOST_WIRE_H
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH              32
+
+class SimBus;
+
+
+/**
+ * @brief Stand-in for the Arduino TwoWire class on the host.
+ *        Every transfer goes to the simulated bus returned by
+ *        get_bus(), where the device models are attached.
+ *
+ *        The return codes of endTransmission() are those of the
+ *        AVR core: 0 success, 1 data too long, 2 NACK on the
+ *        address, 3 NACK on data, 4 other error.
+ *
+ *        As on ESP32, begin() does nothing while the bus is
+ *        already started, it only starts again after end().
+ *        Starting sets the clock to 100 kHz, as the AVR and
+ *        ESP32 cores do.
+ */
+class TwoWire {
+    public:
+        TwoWire();
+        ~TwoWire();
+        TwoWire(const TwoWire &) = delete;
+        TwoWire &operator=(const TwoWire &) = delete;
+
+        void begin();
+        void begin(int sda_pin, int scl_pin);
+        void end();
+        void setClock(uint32_t clock_hz);
+        void beginTransmission(uint8_t address);
+        void beginTransmission(int address);
+        uint8_t endTransmission(bool send_stop = true);
+        uint8_t requestFrom(uint8_t address, uint8_t quantity, bool send_stop = true);
+        uint8_t requestFrom(int address, int quantity);
+        size_t write(uint8_t byte);
+        size_t write(const uint8_t *buffer, size_t size);
+        int available();
+        int read();
+        int peek();
+        void flush();
+
+        SimBus &get_bus();
+        bool is_started();
+
+    private:
+        SimBus *bus;
+        bool started = false;
+        uint8_t tx_address = 0;
+        uint8_t tx_buffer[WIRE_BUFFER_LENGTH] = {0};
+        uint8_t tx_size = 0;
+        bool tx_overflow = false;
+        uint8_t rx_buffer[WIRE_BUFFER_LENGTH] = {0};
+        uint8_t rx_size = 0;
+        uint8_t rx_index = 0;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif
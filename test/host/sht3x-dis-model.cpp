@@ -0,0 +1,947 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <math.h>
+#include <algorithm>
+#include "sht3x-dis-model.h"
+
+/*Repeatability of temperature and rh relative to high repeatability,
+  datasheet tables 1 and 2*/
+static const double TEMPERATURE_NOISE_FACTOR[3] = {1.0, 0.08 / 0.04, 0.15 / 0.04};
+static const double RH_NOISE_FACTOR[3] = {1.0, 0.15 / 0.08, 0.21 / 0.08};
+static const double MPS_VALUE[5] = {0.5, 1.0, 2.0, 4.0, 10.0};
+
+/*Single shot commands, datasheet table 8, clock stretching enabled
+  and disabled by high, medium and low repeatability*/
+static const uint16_t SINGLE_SHOT_COMMAND[2][3] = {
+    {0x2C06, 0x2C0D, 0x2C10},
+    {0x2400, 0x240B, 0x2416}
+};
+
+/*Periodic commands, datasheet table 9, 0.5 to 10 mps by high,
+  medium and low repeatability*/
+static const uint16_t PERIODIC_COMMAND[5][3] = {
+    {0x2032, 0x2024, 0x202F},
+    {0x2130, 0x2126, 0x212D},
+    {0x2236, 0x2220, 0x222B},
+    {0x2334, 0x2322, 0x2329},
+    {0x2737, 0x2721, 0x272A}
+};
+
+static const uint32_t PERIOD_MS[5] = {2000, 1000, 500, 250, 100};
+
+static const uint32_t DURATION_US[3] = {SIM_HIGH_REPEAT_DURATION_US, SIM_MID_REPEAT_DURATION_US,
+    SIM_LOW_REPEAT_DURATION_US};
+
+/*Alert limit LSBs of high set, high clear, low clear and low set,
+  Sensirion application note SHT3x-DIS alert mode*/
+static const uint8_t READ_ALERT_LIMIT_LSB[4] = {0x1F, 0x14, 0x09, 0x02};
+static const uint8_t WRITE_ALERT_LIMIT_LSB[4] = {0x1D, 0x16, 0x0B, 0x00};
+
+std::atomic<uint64_t> SimClock::time_us{0};
+
+
+uint64_t SimClock::now_us() {
+    return time_us.load();
+}
+
+
+void SimClock::advance_us(uint64_t us) {
+    time_us.fetch_add(us);
+}
+
+
+/**
+ * @brief Move the clock to a time, never backwards
+ */
+void SimClock::advance_to_us(uint64_t time) {
+    uint64_t now = time_us.load();
+    while (now < time && !time_us.compare_exchange_weak(now, time)) {
+    }
+}
+
+
+void SimClock::reset() {
+    time_us.store(0);
+}
+
+
+/**
+ * @brief CRC-8 of the sensor words, datasheet section 4.12
+ */
+static uint8_t sim_crc8(const uint8_t *data, uint8_t size) {
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+
+static uint16_t temperature_to_raw(double temperature) {
+    double raw = (temperature + 45.0) / 175.0 * 65535.0 + 0.5;
+    return raw <= 0.0 ? 0 : raw >= 65535.0 ? 65535 : (uint16_t)raw;
+}
+
+
+static uint16_t rh_to_raw(double rh) {
+    double raw = rh / 100.0 * 65535.0 + 0.5;
+    return raw <= 0.0 ? 0 : raw >= 65535.0 ? 65535 : (uint16_t)raw;
+}
+
+
+/**
+ * @brief Alert limit word, the 7 MSBs of rh and the 9 MSBs
+ *        of temperature
+ */
+static uint16_t alert_limit(double temperature, double rh) {
+    return (rh_to_raw(rh) & 0xFE00) | (temperature_to_raw(temperature) >> 7);
+}
+
+
+bool SimDevice::general_call(uint8_t command) {
+    (void)command;
+    return false;
+}
+
+
+bool SimDevice::holds_sda() {
+    return false;
+}
+
+
+void SimDevice::clock_scl() {
+}
+
+
+SimMux::SimMux(uint8_t address): address{address} {
+}
+
+
+uint8_t SimMux::get_address() const {
+    return this->address;
+}
+
+
+uint8_t SimMux::write(const uint8_t *data, uint8_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    if (size != 1) {
+        return 3;
+    }
+    this->control = data[0];
+    this->writes++;
+    return 0;
+}
+
+
+uint8_t SimMux::read(uint8_t *data, uint8_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    data[0] = this->control;
+    return 1;
+}
+
+
+bool SimMux::is_connected(uint8_t channel) const {
+    return channel < SIM_MUX_CHANNEL_COUNT && (this->control & (1 << channel));
+}
+
+
+uint8_t SimMux::get_control() const {
+    return this->control;
+}
+
+
+uint32_t SimMux::get_writes() const {
+    return this->writes;
+}
+
+
+void SimMux::reset_counters() {
+    this->writes = 0;
+}
+
+
+SimBus::SimBus() {
+    buses().push_back(this);
+}
+
+
+SimBus::~SimBus() {
+    std::vector<SimBus *> &all = buses();
+    all.erase(std::remove(all.begin(), all.end(), this), all.end());
+}
+
+
+std::vector<SimBus *> &SimBus::buses() {
+    static std::vector<SimBus *> all;
+    return all;
+}
+
+
+/**
+ * @brief Attach a device directly to the bus
+ */
+void SimBus::attach(SimDevice &device) {
+    this->devices.push_back({&device, nullptr, 0});
+}
+
+
+/**
+ * @brief Attach a device behind a channel of a multiplexer,
+ *        the multiplexer itself must be attached to the bus
+ */
+void SimBus::attach(SimDevice &device, SimMux &mux, uint8_t channel) {
+    this->devices.push_back({&device, &mux, channel});
+}
+
+
+void SimBus::detach_all() {
+    this->devices.clear();
+}
+
+
+void SimBus::set_clock(uint32_t clock_hz) {
+    this->clock_hz = clock_hz;
+}
+
+
+void SimBus::set_pins(uint8_t sda_pin, uint8_t scl_pin) {
+    this->sda_pin = sda_pin;
+    this->scl_pin = scl_pin;
+}
+
+
+/**
+ * @brief Give the pins back to the i2c peripheral, called by
+ *        TwoWire::begin()
+ */
+void SimBus::attach_pins() {
+    this->pins_connected = true;
+}
+
+
+bool SimBus::pins_attached() const {
+    return this->pins_connected;
+}
+
+
+/**
+ * @brief Time of a transfer: a START, 9 clocks per byte with
+ *        the ACK, and a STOP
+ *
+ * @param bytes bytes on the wire including the address byte
+ */
+void SimBus::transfer_time(uint8_t bytes) {
+    uint64_t us = ((uint64_t)(9 * bytes + 2) * 1000000 + this->clock_hz - 1) / this->clock_hz;
+    this->counters.bytes += bytes;
+    this->counters.busy_us += us;
+    SimClock::advance_us(us);
+}
+
+
+/**
+ * @brief Check if transfers fail because SDA is held low or the
+ *        pins were taken away from the peripheral
+ */
+bool SimBus::stuck() {
+    if (!this->pins_connected) {
+        return true;
+    }
+    for (const Attachment &attachment : this->devices) {
+        if (attachment.device->holds_sda()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Devices answering an address, those behind a mux only
+ *        while their channel is connected
+ */
+std::vector<SimDevice *> SimBus::route(uint8_t address) {
+    std::vector<SimDevice *> found;
+    for (const Attachment &attachment : this->devices) {
+        if (attachment.device->get_address() == address
+            && (attachment.mux == nullptr || attachment.mux->is_connected(attachment.channel))) {
+            found.push_back(attachment.device);
+        }
+    }
+    if (found.size() > 1) {
+        this->counters.conflicts++;
+    }
+    return found;
+}
+
+
+/**
+ * @brief Write transfer
+ *
+ * @return uint8_t Wire code of endTransmission()
+ */
+uint8_t SimBus::write(uint8_t address, const uint8_t *data, uint8_t size) {
+    this->counters.transactions++;
+    if (stuck()) {
+        this->counters.nacks++;
+        return 4;
+    }
+
+    if (address == 0) {
+        bool acked = false;
+        for (const Attachment &attachment : this->devices) {
+            if (size > 0 && (attachment.mux == nullptr || attachment.mux->is_connected(attachment.channel))) {
+                acked = attachment.device->general_call(data[0]) || acked;
+            }
+        }
+        transfer_time(acked ? 1 + size : 1);
+        if (!acked) {
+            this->counters.nacks++;
+        }
+        return acked ? 0 : 2;
+    }
+
+    std::vector<SimDevice *> found = route(address);
+    if (found.empty()) {
+        transfer_time(1);
+        this->counters.nacks++;
+        return 2;
+    }
+    uint8_t result = found[0]->write(data, size);
+    for (size_t i = 1; i < found.size(); i++) {
+        found[i]->write(data, size);
+    }
+    if (result != 0) {
+        this->counters.nacks++;
+    }
+    transfer_time(result == 2 ? 1 : 1 + size);
+    return result;
+}
+
+
+/**
+ * @brief Read transfer. The controller clocks all requested
+ *        bytes, those the device does not drive read as 0xFF.
+ *
+ * @return uint8_t bytes received, 0 for a NACK
+ */
+uint8_t SimBus::read(uint8_t address, uint8_t *data, uint8_t size) {
+    this->counters.transactions++;
+    if (stuck()) {
+        this->counters.nacks++;
+        return 0;
+    }
+    std::vector<SimDevice *> found = route(address);
+    uint8_t received = found.empty() ? 0 : found[0]->read(data, size);
+    if (received == 0) {
+        transfer_time(1);
+        this->counters.nacks++;
+        return 0;
+    }
+    for (uint8_t i = received; i < size; i++) {
+        data[i] = 0xFF;
+    }
+    transfer_time(1 + size);
+    return size;
+}
+
+
+const SimBus::Counters &SimBus::get_counters() const {
+    return this->counters;
+}
+
+
+void SimBus::reset_counters() {
+    this->counters = {};
+}
+
+
+/**
+ * @brief A pin of a bus used as a GPIO is taken away from the
+ *        i2c peripheral until TwoWire::begin() starts it again
+ */
+void SimBus::pin_mode_changed(uint8_t pin) {
+    for (SimBus *bus : buses()) {
+        if (pin == bus->sda_pin || pin == bus->scl_pin) {
+            bus->pins_connected = false;
+        }
+    }
+}
+
+
+bool SimBus::sda_held_low(uint8_t pin) {
+    for (SimBus *bus : buses()) {
+        if (pin != bus->sda_pin) {
+            continue;
+        }
+        for (const Attachment &attachment : bus->devices) {
+            if (attachment.device->holds_sda()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+void SimBus::scl_released(uint8_t pin) {
+    for (SimBus *bus : buses()) {
+        if (pin != bus->scl_pin) {
+            continue;
+        }
+        for (const Attachment &attachment : bus->devices) {
+            attachment.device->clock_scl();
+        }
+    }
+}
+
+
+SimSht3x::SimSht3x(uint8_t address): address{address}, random{1} {
+    set_environment(25.0, 50.0);
+    reset();
+    this->busy_until_us = 0;
+}
+
+
+uint8_t SimSht3x::get_address() const {
+    return this->address;
+}
+
+
+/**
+ * @brief State after a power up or a reset: idle, heater off,
+ *        default alert limits, system reset bit set
+ */
+void SimSht3x::reset() {
+    this->mode = Mode::IDLE;
+    this->status = (1 << SIM_STATUS_ALERT_PENDING_BIT) | (1 << SIM_STATUS_SYSTEM_RESET_BIT);
+    this->limits[0] = alert_limit(60.0, 80.0);
+    this->limits[1] = alert_limit(58.0, 79.0);
+    this->limits[2] = alert_limit(-9.0, 22.0);
+    this->limits[3] = alert_limit(-10.0, 20.0);
+    this->output_size = 0;
+    this->last_sample = -1;
+    this->busy_until_us = SimClock::now_us() + SIM_RESET_DURATION_US;
+}
+
+
+uint8_t SimSht3x::write(const uint8_t *data, uint8_t size) {
+    if (this->fault == Fault::HANG) {
+        return 2;
+    }
+    if (this->fault == Fault::NACK) {
+        if (--this->fault_count == 0) {
+            this->fault = Fault::NONE;
+        }
+        return 2;
+    }
+    uint64_t now = SimClock::now_us();
+    if (now < this->busy_until_us
+        || (this->mode == Mode::SINGLE_SHOT && now < this->ready_us)) {
+        return 2;
+    }
+    if (size < 2) {
+        return 0;
+    }
+
+    uint16_t command = (data[0] << 8) | data[1];
+    this->commands++;
+    update_self_heating(now);
+    this->output_size = 0;
+    if (this->mode == Mode::SINGLE_SHOT) {
+        this->mode = Mode::IDLE;
+    }
+    if ((this->mode == Mode::PERIODIC || this->mode == Mode::ART)
+        && !allowed_while_periodic(command)) {
+        /*Not executed, the sensor has to be stopped with a break first*/
+        this->protocol_errors++;
+        this->status |= 1 << SIM_STATUS_COMMAND_FAILED_BIT;
+        return 0;
+    }
+    return execute(command, data + 2, size - 2) ? 0 : 3;
+}
+
+
+bool SimSht3x::allowed_while_periodic(uint16_t command) {
+    switch (command) {
+        case SIM_FETCH_DATA:
+        case SIM_BREAK:
+        case SIM_SOFT_RESET:
+        case SIM_HEATER_ENABLE:
+        case SIM_HEATER_DISABLE:
+        case SIM_READ_STATUS:
+        case SIM_CLEAR_STATUS:
+            return true;
+        default:
+            return (command >> 8) == SIM_READ_ALERT_LIMIT_MSB || (command >> 8) == SIM_WRITE_ALERT_LIMIT_MSB;
+    }
+}
+
+
+/**
+ * @brief Run a command
+ *
+ * @param command command word
+ * @param data bytes sent after the command
+ * @param size number of bytes after the command
+ * @return true the command is known, false it is NACKed
+ */
+bool SimSht3x::execute(uint16_t command, const uint8_t *data, uint8_t size) {
+    uint64_t now = SimClock::now_us();
+    if (command != SIM_READ_STATUS) {
+        this->status &= ~((1 << SIM_STATUS_COMMAND_FAILED_BIT) | (1 << SIM_STATUS_WRITE_CRC_FAILED_BIT));
+    }
+
+    for (uint8_t stretching = 0; stretching < 2; stretching++) {
+        for (uint8_t repeatability = 0; repeatability < 3; repeatability++) {
+            if (command == SINGLE_SHOT_COMMAND[stretching][repeatability]) {
+                this->mode = Mode::SINGLE_SHOT;
+                this->repeatability = repeatability;
+                this->clock_stretching = stretching == 0;
+                this->ready_us = now + duration_us();
+                return true;
+            }
+        }
+    }
+    for (uint8_t mps = 0; mps < 5; mps++) {
+        for (uint8_t repeatability = 0; repeatability < 3; repeatability++) {
+            if (command == PERIODIC_COMMAND[mps][repeatability]) {
+                start_periodic(mps, repeatability, Mode::PERIODIC);
+                return true;
+            }
+        }
+    }
+
+    switch (command) {
+        case SIM_ART_4HZ:
+            start_periodic(3, 0, Mode::ART);
+            return true;
+        case SIM_FETCH_DATA: {
+            if (this->mode != Mode::PERIODIC && this->mode != Mode::ART) {
+                return true;
+            }
+            uint64_t elapsed = now - this->start_us;
+            if (elapsed < duration_us()) {
+                return true;
+            }
+            int64_t sample = (elapsed - duration_us()) / period_us();
+            if (sample > this->last_sample) {
+                this->last_sample = sample;
+                measure(this->start_us + sample * period_us() + duration_us());
+            }
+            return true;
+        }
+        case SIM_BREAK:
+            if (this->mode == Mode::PERIODIC || this->mode == Mode::ART) {
+                this->mode = Mode::IDLE;
+                this->busy_until_us = now + SIM_BREAK_DURATION_US;
+            }
+            return true;
+        case SIM_SOFT_RESET:
+            reset();
+            return true;
+        case SIM_HEATER_ENABLE:
+            this->status |= 1 << SIM_STATUS_HEATER_BIT;
+            return true;
+        case SIM_HEATER_DISABLE:
+            this->status &= ~(1 << SIM_STATUS_HEATER_BIT);
+            return true;
+        case SIM_READ_STATUS:
+            output_word(this->status);
+            return true;
+        case SIM_CLEAR_STATUS:
+            this->status &= ~((1 << SIM_STATUS_ALERT_PENDING_BIT) | (1 << SIM_STATUS_RH_ALERT_BIT)
+                | (1 << SIM_STATUS_T_ALERT_BIT) | (1 << SIM_STATUS_SYSTEM_RESET_BIT));
+            return true;
+        default:
+            break;
+    }
+
+    for (uint8_t i = 0; i < 4; i++) {
+        if (command == ((SIM_READ_ALERT_LIMIT_MSB << 8) | READ_ALERT_LIMIT_LSB[i])) {
+            output_word(this->limits[i]);
+            return true;
+        }
+        if (command == ((SIM_WRITE_ALERT_LIMIT_MSB << 8) | WRITE_ALERT_LIMIT_LSB[i]) && size == 3) {
+            if (sim_crc8(data, 2) != data[2]) {
+                this->status |= 1 << SIM_STATUS_WRITE_CRC_FAILED_BIT;
+            } else {
+                this->limits[i] = (data[0] << 8) | data[1];
+            }
+            return true;
+        }
+    }
+    this->protocol_errors++;
+    this->status |= 1 << SIM_STATUS_COMMAND_FAILED_BIT;
+    return false;
+}
+
+
+void SimSht3x::start_periodic(uint8_t mps, uint8_t repeatability, Mode mode) {
+    this->mode = mode;
+    this->mps = mps;
+    this->repeatability = repeatability;
+    this->start_us = SimClock::now_us();
+    this->last_sample = -1;
+}
+
+
+/**
+ * @brief Period of the current mode on the sensor clock
+ */
+uint64_t SimSht3x::period_us() const {
+    uint32_t period_ms = this->mode == Mode::ART ? SIM_ART_PERIOD_MS : PERIOD_MS[this->mps];
+    return (uint64_t)(period_ms * 1000.0 * (1.0 + this->clock_error));
+}
+
+
+/**
+ * @brief Maximum measurement duration of the current
+ *        repeatability on the sensor clock
+ */
+uint64_t SimSht3x::duration_us() const {
+    return (uint64_t)(DURATION_US[this->repeatability] * (1.0 + this->clock_error));
+}
+
+
+/**
+ * @brief Take a sample and queue its 6 byte result
+ *
+ * @param time_us time the measurement finished
+ */
+void SimSht3x::measure(uint64_t time_us) {
+    double temperature;
+    double rh;
+    this->environment(time_us / 1e6, temperature, rh);
+    update_self_heating(time_us);
+    temperature += this->self_heating;
+
+    if (this->temperature_sigma > 0.0) {
+        temperature += std::normal_distribution<double>(0.0,
+            this->temperature_sigma * TEMPERATURE_NOISE_FACTOR[this->repeatability])(this->random);
+    }
+    if (this->rh_sigma > 0.0) {
+        rh += std::normal_distribution<double>(0.0,
+            this->rh_sigma * RH_NOISE_FACTOR[this->repeatability])(this->random);
+    }
+
+    uint16_t temperature_raw = temperature_to_raw(temperature);
+    uint16_t rh_raw = rh_to_raw(rh);
+    if (this->mode == Mode::PERIODIC || this->mode == Mode::ART) {
+        update_alerts(temperature_raw, rh_raw);
+    }
+    this->output_size = 0;
+    output_word(temperature_raw);
+    output_word(rh_raw);
+    this->samples++;
+}
+
+
+/**
+ * @brief Move the self heating towards the steady state of the
+ *        current mode with a first order lag. The rise of a
+ *        periodic mode scales with the measurements per second
+ *        and the measurement duration.
+ */
+void SimSht3x::update_self_heating(uint64_t time_us) {
+    if (time_us <= this->self_heating_us) {
+        return;
+    }
+    double target = 0.0;
+    if (this->mode == Mode::PERIODIC || this->mode == Mode::ART) {
+        double mps = this->mode == Mode::ART ? 4.0 : MPS_VALUE[this->mps];
+        target = this->self_heating_rise * mps / 10.0
+            * DURATION_US[this->repeatability] / DURATION_US[0];
+    }
+    if (this->status & (1 << SIM_STATUS_HEATER_BIT)) {
+        target += this->heater_rise;
+    }
+    double dt_s = (time_us - this->self_heating_us) / 1e6;
+    this->self_heating += (target - this->self_heating) * (1.0 - exp(-dt_s / this->self_heating_tau_s));
+    this->self_heating_us = time_us;
+}
+
+
+/**
+ * @brief Set or clear the tracking alerts, comparing the 9 MSBs
+ *        of temperature and the 7 MSBs of rh to the limits
+ */
+void SimSht3x::update_alerts(uint16_t temperature_raw, uint16_t rh_raw) {
+    uint16_t temperature = temperature_raw >> 7;
+    uint16_t rh = rh_raw >> 9;
+    const uint16_t (&limits)[4] = this->limits;
+    bool temperature_alert = this->status & (1 << SIM_STATUS_T_ALERT_BIT);
+    bool rh_alert = this->status & (1 << SIM_STATUS_RH_ALERT_BIT);
+
+    if (temperature > (limits[0] & 0x1FF) || temperature < (limits[3] & 0x1FF)) {
+        temperature_alert = true;
+    } else if (temperature < (limits[1] & 0x1FF) && temperature > (limits[2] & 0x1FF)) {
+        temperature_alert = false;
+    }
+    if (rh > (limits[0] >> 9) || rh < (limits[3] >> 9)) {
+        rh_alert = true;
+    } else if (rh < (limits[1] >> 9) && rh > (limits[2] >> 9)) {
+        rh_alert = false;
+    }
+
+    this->status &= ~((1 << SIM_STATUS_T_ALERT_BIT) | (1 << SIM_STATUS_RH_ALERT_BIT));
+    if (temperature_alert) this->status |= 1 << SIM_STATUS_T_ALERT_BIT;
+    if (rh_alert) this->status |= 1 << SIM_STATUS_RH_ALERT_BIT;
+    if (temperature_alert || rh_alert) this->status |= 1 << SIM_STATUS_ALERT_PENDING_BIT;
+}
+
+
+/**
+ * @brief Append a word and its CRC to the output
+ */
+void SimSht3x::output_word(uint16_t word) {
+    uint8_t *out = this->output + this->output_size;
+    out[0] = word >> 8;
+    out[1] = word;
+    out[2] = sim_crc8(out, 2);
+    if (this->corrupt_count > 0) {
+        this->corrupt_count--;
+        out[1] ^= 0x01;
+    }
+    this->output_size += 3;
+}
+
+
+uint8_t SimSht3x::read(uint8_t *data, uint8_t size) {
+    if (this->fault == Fault::HANG) {
+        return 0;
+    }
+    if (this->fault == Fault::NACK) {
+        if (--this->fault_count == 0) {
+            this->fault = Fault::NONE;
+        }
+        return 0;
+    }
+    uint64_t now = SimClock::now_us();
+    if (now < this->busy_until_us) {
+        return 0;
+    }
+    if (this->mode == Mode::SINGLE_SHOT) {
+        if (now < this->ready_us) {
+            if (!this->clock_stretching) {
+                return 0;
+            }
+            /*SCL is held low until the conversion is done*/
+            SimClock::advance_to_us(this->ready_us);
+        }
+        this->mode = Mode::IDLE;
+        measure(this->ready_us);
+    }
+    if (this->output_size == 0) {
+        return 0;
+    }
+    uint8_t count = size < this->output_size ? size : this->output_size;
+    memcpy(data, this->output, count);
+    this->output_size = 0;
+    return count;
+}
+
+
+/**
+ * @brief Only the reset general call is acknowledged. It also
+ *        ends a hang.
+ */
+bool SimSht3x::general_call(uint8_t command) {
+    if (command != SIM_GENERAL_CALL_RESET) {
+        return false;
+    }
+    if (this->fault == Fault::HANG) {
+        this->fault = Fault::NONE;
+    }
+    update_self_heating(SimClock::now_us());
+    reset();
+    return true;
+}
+
+
+bool SimSht3x::holds_sda() {
+    return this->fault == Fault::HOLD_SDA;
+}
+
+
+/**
+ * @brief A held SDA is let go after the number of clocks given
+ *        when the fault was injected
+ */
+void SimSht3x::clock_scl() {
+    if (this->fault == Fault::HOLD_SDA && --this->fault_count == 0) {
+        this->fault = Fault::NONE;
+    }
+}
+
+
+void SimSht3x::set_environment(double temperature, double rh) {
+    this->environment = [temperature, rh](double, double &t, double &h) {
+        t = temperature;
+        h = rh;
+    };
+}
+
+
+void SimSht3x::set_environment(Environment environment) {
+    this->environment = environment;
+}
+
+
+/**
+ * @brief Gaussian noise of a high repeatability measurement,
+ *        medium and low are noisier by the ratio of the
+ *        datasheet repeatabilities
+ */
+void SimSht3x::set_noise(double temperature_sigma, double rh_sigma, uint32_t seed) {
+    this->temperature_sigma = temperature_sigma;
+    this->rh_sigma = rh_sigma;
+    this->random.seed(seed);
+}
+
+
+/**
+ * @brief Self heating of the sensor by its own measurements
+ *
+ * @param rise_at_10_mps steady state rise in C at 10 mps and
+ *        high repeatability
+ * @param time_constant_s time constant of the rise
+ */
+void SimSht3x::set_self_heating(double rise_at_10_mps, double time_constant_s) {
+    update_self_heating(SimClock::now_us());
+    this->self_heating_rise = rise_at_10_mps;
+    this->self_heating_tau_s = time_constant_s;
+}
+
+
+/**
+ * @brief Steady state rise in C with the heater on, it follows
+ *        the time constant of the self heating
+ */
+void SimSht3x::set_heater_rise(double rise) {
+    update_self_heating(SimClock::now_us());
+    this->heater_rise = rise;
+}
+
+
+/**
+ * @brief Relative error of the sensor clock, 0.02 makes all
+ *        periods and conversions 2 % longer
+ */
+void SimSht3x::set_clock_error(double error) {
+    this->clock_error = error;
+}
+
+
+/**
+ * @brief Inject a fault
+ *
+ * @param fault fault to inject
+ * @param count transfers to NACK for NACK, clocks until SDA is
+ *        let go for HOLD_SDA
+ */
+void SimSht3x::inject(Fault fault, uint16_t count) {
+    this->fault = count == 0 ? Fault::NONE : fault;
+    this->fault_count = count;
+}
+
+
+/**
+ * @brief Flip a bit in the next words sent
+ */
+void SimSht3x::corrupt_crc(uint16_t count) {
+    this->corrupt_count = count;
+}
+
+
+/**
+ * @brief Power the sensor off and on, it loses its mode, heater
+ *        state and alert limits and sets the system reset bit
+ */
+void SimSht3x::power_cycle() {
+    this->fault = Fault::NONE;
+    update_self_heating(SimClock::now_us());
+    reset();
+}
+
+
+SimSht3x::Mode SimSht3x::get_mode() const {
+    return this->mode;
+}
+
+
+Mps SimSht3x::get_mps() const {
+    return static_cast<Mps>(this->mps);
+}
+
+
+Repeatability SimSht3x::get_repeatability() const {
+    return static_cast<Repeatability>(this->repeatability);
+}
+
+
+uint16_t SimSht3x::get_status() const {
+    return this->status;
+}
+
+
+bool SimSht3x::is_heater_on() const {
+    return this->status & (1 << SIM_STATUS_HEATER_BIT);
+}
+
+
+double SimSht3x::get_self_heating() const {
+    return this->self_heating;
+}
+
+
+uint32_t SimSht3x::get_commands() const {
+    return this->commands;
+}
+
+
+uint32_t SimSht3x::get_samples() const {
+    return this->samples;
+}
+
+
+uint32_t SimSht3x::get_protocol_errors() const {
+    return this->protocol_errors;
+}
+
+
+void SimSht3x::reset_counters() {
+    this->commands = 0;
+    this->samples = 0;
+    this->protocol_errors = 0;
+}
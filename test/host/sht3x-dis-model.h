@@ -0,0 +1,322 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_MODEL_H
+#define SHT3X_DIS_MODEL_H
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <vector>
+#include "Arduino.h"
+#include "sht3x-dis-registers.h"
+
+#define SIM_DEFAULT_CLOCK_HZ            100000
+#define SIM_CALL_COST_US                2       /*CPU time charged for each micros() or millis()*/
+#define SIM_BREAK_DURATION_US           1000    /*datasheet section 4.8*/
+#define SIM_RESET_DURATION_US           1500    /*datasheet table 4*/
+#define SIM_MUX_CHANNEL_COUNT           8
+#define SIM_SHT3X_ADDRESS               0x44
+
+/*Commands, status bits and timing of the datasheet. The model has
+  its own copy so a wrong code in the driver is rejected instead
+  of echoed back.*/
+#define SIM_FETCH_DATA                  0xE000
+#define SIM_ART_4HZ                     0x2B32
+#define SIM_BREAK                       0x3093
+#define SIM_SOFT_RESET                  0x30A2
+#define SIM_HEATER_ENABLE               0x306D
+#define SIM_HEATER_DISABLE              0x3066
+#define SIM_READ_STATUS                 0xF32D
+#define SIM_CLEAR_STATUS                0x3041
+#define SIM_READ_ALERT_LIMIT_MSB        0xE1
+#define SIM_WRITE_ALERT_LIMIT_MSB       0x61
+#define SIM_GENERAL_CALL_RESET          0x06
+
+#define SIM_STATUS_ALERT_PENDING_BIT    15
+#define SIM_STATUS_HEATER_BIT           13
+#define SIM_STATUS_RH_ALERT_BIT         11
+#define SIM_STATUS_T_ALERT_BIT          10
+#define SIM_STATUS_SYSTEM_RESET_BIT     4
+#define SIM_STATUS_COMMAND_FAILED_BIT   1
+#define SIM_STATUS_WRITE_CRC_FAILED_BIT 0
+
+#define SIM_HIGH_REPEAT_DURATION_US     15500   /*maximum measurement duration, datasheet table 4*/
+#define SIM_MID_REPEAT_DURATION_US      6500
+#define SIM_LOW_REPEAT_DURATION_US      4500
+#define SIM_ART_PERIOD_MS               250
+
+
+/**
+ * @brief Simulated time shared by the Arduino stand-ins and the
+ *        device models. It only moves forward when code waits,
+ *        reads the time or uses the bus, so a test runs as fast
+ *        as the host allows and gives the same result every run.
+ *        Safe to use from several threads.
+ */
+class SimClock {
+    public:
+        static uint64_t now_us();
+        static void advance_us(uint64_t us);
+        static void advance_to_us(uint64_t time_us);
+        static void reset();
+
+    private:
+        static std::atomic<uint64_t> time_us;
+};
+
+
+/**
+ * @brief Device on a simulated bus
+ */
+class SimDevice {
+    public:
+        virtual ~SimDevice() = default;
+        virtual uint8_t get_address() const = 0;
+
+        /**
+         * @brief Receive a write transfer
+         *
+         * @return uint8_t Wire code, 0 ACK, 2 NACK on the address,
+         *         3 NACK on data
+         */
+        virtual uint8_t write(const uint8_t *data, uint8_t size) = 0;
+
+        /**
+         * @brief Answer a read transfer
+         *
+         * @return uint8_t bytes sent, 0 for a NACK on the address
+         */
+        virtual uint8_t read(uint8_t *data, uint8_t size) = 0;
+
+        virtual bool general_call(uint8_t command);
+        virtual bool holds_sda();
+        virtual void clock_scl();
+};
+
+
+/**
+ * @brief TCA9548A style i2c multiplexer. A write of one byte
+ *        connects the channels of its set bits.
+ */
+class SimMux : public SimDevice {
+    public:
+        SimMux(uint8_t address = 0x70);
+        uint8_t get_address() const override;
+        uint8_t write(const uint8_t *data, uint8_t size) override;
+        uint8_t read(uint8_t *data, uint8_t size) override;
+        bool is_connected(uint8_t channel) const;
+        uint8_t get_control() const;
+        uint32_t get_writes() const;
+        void reset_counters();
+
+    private:
+        const uint8_t address;
+        uint8_t control = 0;
+        uint32_t writes = 0;
+};
+
+
+/**
+ * @brief One i2c bus with its devices, directly attached or
+ *        behind a multiplexer channel. Counts the transfers,
+ *        the bytes on the wire including the address bytes, and
+ *        advances the clock by the time they take at the bus
+ *        clock rate.
+ *
+ *        A transfer that more than one device answers is
+ *        counted as a conflict, the first device answers.
+ */
+class SimBus {
+    public:
+        struct Counters {
+            uint32_t transactions;
+            uint32_t bytes;
+            uint64_t busy_us;
+            uint32_t nacks;
+            uint32_t conflicts;
+        };
+
+        void attach(SimDevice &device);
+        void attach(SimDevice &device, SimMux &mux, uint8_t channel);
+        void detach_all();
+        void set_clock(uint32_t clock_hz);
+        void set_pins(uint8_t sda_pin, uint8_t scl_pin);
+        void attach_pins();
+        bool pins_attached() const;
+
+        uint8_t write(uint8_t address, const uint8_t *data, uint8_t size);
+        uint8_t read(uint8_t address, uint8_t *data, uint8_t size);
+
+        const Counters &get_counters() const;
+        void reset_counters();
+
+        static void pin_mode_changed(uint8_t pin);
+        static bool sda_held_low(uint8_t pin);
+        static void scl_released(uint8_t pin);
+
+        SimBus();
+        ~SimBus();
+
+    private:
+        struct Attachment {
+            SimDevice *device;
+            SimMux *mux;
+            uint8_t channel;
+        };
+
+        std::vector<Attachment> devices;
+        uint32_t clock_hz = SIM_DEFAULT_CLOCK_HZ;
+        uint8_t sda_pin = SDA;
+        uint8_t scl_pin = SCL;
+        bool pins_connected = true;
+        Counters counters = {};
+
+        void transfer_time(uint8_t bytes);
+        bool stuck();
+        std::vector<SimDevice *> route(uint8_t address);
+
+        static std::vector<SimBus *> &buses();
+};
+
+
+/**
+ * @brief Model of an SHT3x-DIS sensor answering every command of
+ *        the datasheet with its timing:
+ *        - single shot with and without clock stretching, the
+ *          read header is NACKed or stretched until the maximum
+ *          measurement duration of the repeatability has passed
+ *        - periodic and ART modes, sample k of a mode is ready one
+ *          measurement duration after k periods of the sensor
+ *          clock. A fetch without a new sample is NACKed.
+ *        - break, soft reset and general call reset, the sensor
+ *          NACKs for 1 ms after a break and 1.5 ms after a reset
+ *        - heater, status register and clear, alert limits with
+ *          their defaults and the tracking alert bits
+ *
+ *        A command other than fetch, break, reset, heater, status
+ *        and alert limits in periodic or ART mode is not executed
+ *        and sets the command failed bit, as is an unknown
+ *        command. Both are counted as protocol errors.
+ *
+ *        The measured values come from the environment plus
+ *        optional noise per repeatability, self heating per rate
+ *        and heater, and faults can be injected.
+ */
+class SimSht3x : public SimDevice {
+    public:
+        enum class Mode {
+            IDLE,
+            SINGLE_SHOT,
+            PERIODIC,
+            ART
+        };
+
+        enum class Fault {
+            NONE,
+            NACK,       /*NACK the next transfers*/
+            HANG,       /*NACK everything until a general call reset or power cycle*/
+            HOLD_SDA    /*hold SDA low until SCL is clocked*/
+        };
+
+        /*Environment at a time in s since the clock was reset*/
+        typedef std::function<void(double time_s, double &temperature, double &rh)> Environment;
+
+        SimSht3x(uint8_t address = SIM_SHT3X_ADDRESS);
+        uint8_t get_address() const override;
+        uint8_t write(const uint8_t *data, uint8_t size) override;
+        uint8_t read(uint8_t *data, uint8_t size) override;
+        bool general_call(uint8_t command) override;
+        bool holds_sda() override;
+        void clock_scl() override;
+
+        void set_environment(double temperature, double rh);
+        void set_environment(Environment environment);
+        void set_noise(double temperature_sigma, double rh_sigma, uint32_t seed = 1);
+        void set_self_heating(double rise_at_10_mps, double time_constant_s);
+        void set_heater_rise(double rise);
+        void set_clock_error(double error);
+        void inject(Fault fault, uint16_t count = 1);
+        void corrupt_crc(uint16_t count = 1);
+        void power_cycle();
+
+        Mode get_mode() const;
+        Mps get_mps() const;
+        Repeatability get_repeatability() const;
+        uint16_t get_status() const;
+        bool is_heater_on() const;
+        double get_self_heating() const;
+        uint32_t get_commands() const;
+        uint32_t get_samples() const;
+        uint32_t get_protocol_errors() const;
+        void reset_counters();
+
+    private:
+        const uint8_t address;
+        Environment environment;
+        double temperature_sigma = 0.0;
+        double rh_sigma = 0.0;
+        std::mt19937 random;
+        double self_heating_rise = 0.0;
+        double self_heating_tau_s = 1.0;
+        double self_heating = 0.0;
+        uint64_t self_heating_us = 0;
+        double heater_rise = 0.0;
+        double clock_error = 0.0;
+        Fault fault = Fault::NONE;
+        uint16_t fault_count = 0;
+        uint16_t corrupt_count = 0;
+
+        Mode mode = Mode::IDLE;
+        uint8_t mps = 1;                /*0.5, 1, 2, 4 and 10 mps*/
+        uint8_t repeatability = 0;      /*high, medium and low*/
+        bool clock_stretching = false;
+        uint16_t status = 0;
+        uint16_t limits[4] = {0};
+        uint64_t busy_until_us = 0;
+        uint64_t ready_us = 0;          /*single shot result*/
+        uint64_t start_us = 0;          /*periodic or ART*/
+        int64_t last_sample = -1;       /*index of the newest sample fetched*/
+        uint8_t output[6] = {0};
+        uint8_t output_size = 0;
+
+        uint32_t commands = 0;
+        uint32_t samples = 0;
+        uint32_t protocol_errors = 0;
+
+        void reset();
+        bool execute(uint16_t command, const uint8_t *data, uint8_t size);
+        bool allowed_while_periodic(uint16_t command);
+        void start_periodic(uint8_t mps, uint8_t repeatability, Mode mode);
+        uint64_t period_us() const;
+        uint64_t duration_us() const;
+        void measure(uint64_t time_us);
+        void update_self_heating(uint64_t time_us);
+        void update_alerts(uint16_t temperature_raw, uint16_t rh_raw);
+        void output_word(uint16_t word);
+};
+
+#endif
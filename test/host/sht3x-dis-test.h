@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#ifndef SHT3X_DIS_TEST_H
+#define SHT3X_DIS_TEST_H
+#include <stdio.h>
+#include "Arduino.h"
+#include "Wire.h"
+#include "sht3x-dis-model.h"
+
+/**
+ * Minimal checks for the host tests. A failed check prints its
+ * location and the test keeps running, main() returns the
+ * result of test_result().
+ */
+
+static int test_failures = 0;
+
+#define CHECK(condition) do { \
+        if (!(condition)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_STATUS(expression, expected) do { \
+        int check_status = static_cast<int>(expression); \
+        if (check_status != static_cast<int>(expected)) { \
+            printf("%s:%d: %s returned %d, expected %d\n", __FILE__, __LINE__, #expression, \
+                check_status, static_cast<int>(expected)); \
+            test_failures++; \
+        } \
+    } while (0)
+
+
+/**
+ * @brief Start a test case from a clean bus and clock
+ *
+ * @param name printed before the case runs, nullptr to print
+ *        nothing
+ */
+static inline void test_case(const char *name = nullptr) {
+    if (name != nullptr) {
+        printf("-- %s\n", name);
+    }
+    Wire.end();
+    Wire.get_bus().detach_all();
+    Wire.get_bus().reset_counters();
+    Wire.get_bus().set_clock(SIM_DEFAULT_CLOCK_HZ);
+    SimClock::reset();
+}
+
+
+/**
+ * @brief Name the next step of a test case, keeps the bus and
+ *        clock as they are
+ */
+static inline void test_step(const char *name) {
+    printf("-- %s\n", name);
+}
+
+
+static inline int test_result() {
+    if (test_failures != 0) {
+        printf("%d check(s) failed\n", test_failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
+
+#endif
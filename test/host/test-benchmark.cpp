@@ -0,0 +1,237 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "sht3x-dis-test.h"
+#include "../../examples/benchmark.ino"
+
+/**
+ * examples/benchmark.ino on the host, built with SHT3X_TRACE
+ * and SHT3X_PERF_COUNTERS.
+ *
+ * The sketch runs once against the model. Its bus operations
+ * are timed on the simulated clock and must stay within their
+ * datasheet budgets and byte counts. Its CPU loops only see
+ * the simulated cost of micros(), so their figures mean
+ * nothing here.
+ *
+ * The same CPU operations are then timed on the host clock
+ * and checked against HOST_BASELINE_*_NS. These are x86-64
+ * figures taken on the machine the library is developed on,
+ * not board baselines, the margin only catches gross
+ * regressions like a conversion that stops being inlined.
+ *
+ * Both CRC-8 implementations are timed whatever
+ * SHT3X_CRC_BITWISE selects, in ns and in time stamp counter
+ * cycles where the host has one.
+ */
+
+/*Debug and sanitizer builds only report*/
+#if defined(NDEBUG) && !defined(__SANITIZE_THREAD__) && !defined(__SANITIZE_ADDRESS__)
+#define HOST_CHECK_BASELINES            1
+#else
+#define HOST_CHECK_BASELINES            0
+#endif
+
+#define HOST_ITERATIONS                 1000000UL
+#define HOST_REPEATS                    5
+#define HOST_MARGIN_FACTOR              4
+
+/*RelWithDebInfo, fastest of 5 runs of 1M calls, rounded up*/
+#define HOST_BASELINE_TEMPERATURE_TO_FLOAT_NS   2
+#define HOST_BASELINE_RH_TO_FLOAT_NS            2
+#define HOST_BASELINE_PERIODIC_COMMAND_NS       2
+#define HOST_BASELINE_SINGLE_SHOT_COMMAND_NS    2
+#define HOST_BASELINE_REPLAYED_FETCH_DATA_NS    50
+#define HOST_BASELINE_REPLAYED_DEVICE_STATUS_NS 35
+#define HOST_BASELINE_CRC_TABLE_NS              3
+#define HOST_BASELINE_CRC_BITWISE_NS            11
+
+
+static void sketch_on_model() {
+    test_case("benchmark.ino against the model");
+    SimSht3x model(DEVICE_ADDRESS_B);
+    model.set_environment(22.0, 45.0);
+    Wire.get_bus().attach(model);
+    setup();
+    loop();
+    printf("\n");
+    CHECK(all_passed);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+/**
+ * @brief Time an operation on the host clock
+ *
+ * @return double fastest of HOST_REPEATS runs in ns per call
+ */
+template <typename Operation>
+static double host_ns(Operation operation) {
+    double best_ns = 1e9;
+    for (uint8_t repeat = 0; repeat < HOST_REPEATS; repeat++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < HOST_ITERATIONS; i++) {
+            operation(i);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / HOST_ITERATIONS;
+        if (ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    return best_ns;
+}
+
+
+/**
+ * @brief Time an operation in time stamp counter cycles
+ *
+ * @return double fastest of HOST_REPEATS runs in cycles per
+ *         call, 0 on hosts without a time stamp counter
+ */
+template <typename Operation>
+static double host_cycles(Operation operation) {
+#if defined(__x86_64__) || defined(__i386__)
+    double best_cycles = 1e9;
+    for (uint8_t repeat = 0; repeat < HOST_REPEATS; repeat++) {
+        uint64_t start = __rdtsc();
+        for (uint32_t i = 0; i < HOST_ITERATIONS; i++) {
+            operation(i);
+        }
+        double cycles = (double)(__rdtsc() - start) / HOST_ITERATIONS;
+        if (cycles < best_cycles) {
+            best_cycles = cycles;
+        }
+    }
+    return best_cycles;
+#else
+    (void)operation;
+    return 0;
+#endif
+}
+
+
+static void check_host_ns(const char *name, double ns, uint32_t baseline_ns) {
+    printf("%-28s %7.2f ns, baseline %lu ns\n", name, ns, (unsigned long)baseline_ns);
+    CHECK(!HOST_CHECK_BASELINES || ns <= (double)baseline_ns * HOST_MARGIN_FACTOR);
+}
+
+
+/**
+ * @brief Replay a command and its answer into a sensor that is
+ *        not on the bus, as bench_replayed() of the sketch
+ */
+template <typename Operation>
+static double host_replayed_ns(uint16_t command, const uint8_t *answer, uint8_t answer_size,
+    Operation operation) {
+    TraceBuffer trace;
+    Sht3xTraceRecorder recorder(trace);
+    recorder.start();
+    uint8_t cmds[2] = {(uint8_t)(command >> 8), (uint8_t)command};
+    recorder.record(TRACE_RECORD_WRITE, DEVICE_ADDRESS_B, 0, cmds, 2, 0);
+    recorder.record(TRACE_RECORD_READ, DEVICE_ADDRESS_B, 0, answer, answer_size, 0);
+
+    Sht3x replayed(DEVICE_ADDRESS_B, Wire1);
+    Sht3xTraceReplay replay(trace.data, trace.size);
+    replayed.set_trace_replay(&replay);
+    double ns = host_ns([&](uint32_t) {
+        replay.rewind();
+        operation(replayed);
+    });
+    CHECK(replay.get_mismatches() == 0);
+    return ns;
+}
+
+
+static void host_cpu() {
+    test_case("CPU cost on the host clock");
+    check_host_ns("temperature_to_float", host_ns([](uint32_t) {
+        float_sink = sht3x_temperature_centi(raw_source) / 100.0f;
+    }), HOST_BASELINE_TEMPERATURE_TO_FLOAT_NS);
+    check_host_ns("rh_to_float", host_ns([](uint32_t) {
+        float_sink = sht3x_rh_centi(raw_source) / 100.0f;
+    }), HOST_BASELINE_RH_TO_FLOAT_NS);
+    check_host_ns("periodic_command", host_ns([](uint32_t i) {
+        uint8_t mode = raw_source + i;
+        command_sink = sht3x_periodic_command(static_cast<Mps>(mode % 5),
+            static_cast<Repeatability>(mode % 3));
+    }), HOST_BASELINE_PERIODIC_COMMAND_NS);
+    check_host_ns("single_shot_command", host_ns([](uint32_t i) {
+        uint8_t mode = raw_source + i;
+        command_sink = sht3x_single_shot_command(static_cast<Repeatability>(mode % 3),
+            static_cast<ClockStretching>(mode & 1));
+    }), HOST_BASELINE_SINGLE_SHOT_COMMAND_NS);
+
+    const uint8_t measurement[6] = {0xBE, 0xEF, sht3x_crc8_word(0xBEEF),
+        0x66, 0x66, sht3x_crc8_word(0x6666)};
+    check_host_ns("replayed_fetch_data", host_replayed_ns((FETCH_DATA_MSB << 8) | FETCH_DATA_LSB,
+        measurement, 6, [](Sht3x &sensor) {
+        sensor.fetch_data();
+        float_sink = sensor.get_temperature() + sensor.get_rh();
+    }), HOST_BASELINE_REPLAYED_FETCH_DATA_NS);
+
+    const uint8_t status_word[3] = {0x80, 0x10, sht3x_crc8_word(0x8010)};
+    check_host_ns("replayed_read_device_status", host_replayed_ns(
+        (READ_STATUS_REGISTER_MSB << 8) | READ_STATUS_REGISTER_LSB, status_word, 3, [](Sht3x &sensor) {
+        Sht3x::DeviceStatus device_status;
+        sensor.read_device_status(device_status);
+    }), HOST_BASELINE_REPLAYED_DEVICE_STATUS_NS);
+}
+
+
+/**
+ * @brief Time the CRC check of one data word
+ */
+template <typename Crc>
+static void check_host_crc(const char *name, Crc crc, uint32_t baseline_ns) {
+    auto operation = [crc](uint32_t i) {
+        uint8_t word[2] = {(uint8_t)(raw_source >> 8), (uint8_t)(raw_source + i)};
+        command_sink = crc(word, 2);
+    };
+    double ns = host_ns(operation);
+    printf("%-28s %7.2f ns, %7.2f cycles, baseline %lu ns\n", name, ns, host_cycles(operation),
+        (unsigned long)baseline_ns);
+    CHECK(!HOST_CHECK_BASELINES || ns <= (double)baseline_ns * HOST_MARGIN_FACTOR);
+}
+
+
+static void host_crc() {
+    test_case("CRC-8 cost on the host clock");
+    check_host_crc("crc8_table", sht3x_crc8_table, HOST_BASELINE_CRC_TABLE_NS);
+    check_host_crc("crc8_bitwise", sht3x_crc8_bitwise, HOST_BASELINE_CRC_BITWISE_NS);
+}
+
+
+int main() {
+    sketch_on_model();
+    host_cpu();
+    host_crc();
+    return test_result();
+}
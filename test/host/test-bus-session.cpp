@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <chrono>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * fetch_data() and perform_single_shot_measurement() on a
+ * persistent bus session, against the old behaviour emulated
+ * like examples/bus_session_timing.ino does: Wire.end() and
+ * Wire.begin() before each call. The bus runs at 400 kHz, which
+ * a restart puts back to the 100 kHz default of the core.
+ * Prints the simulated time and bus time per call and the host
+ * CPU time of the driver.
+ */
+
+#define ITERATIONS                      20
+#define FAST_CLOCK_HZ                   400000
+
+
+struct Timing {
+    uint64_t wall_us;
+    uint64_t busy_us;
+    uint32_t transactions;
+    uint64_t cpu_ns;
+};
+
+
+static Timing time_calls(Sht3x &sensor, bool restart_bus, bool fetch) {
+    Wire.setClock(FAST_CLOCK_HZ);
+    Wire.get_bus().reset_counters();
+    Timing timing = {};
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        if (fetch) {
+            delay(sht3x_period_ms(Mps::MPS_10));
+        }
+        uint64_t start_us = SimClock::now_us();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (restart_bus) {
+            Wire.end();
+            Wire.begin();
+        }
+        Sht3x::I2C_STATUS status = fetch ? sensor.fetch_data()
+            : sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+                ClockStretching::STRETCHING_ENABLED);
+        timing.cpu_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        timing.wall_us += SimClock::now_us() - start_us;
+        CHECK_STATUS(status, Sht3x::I2C_STATUS::SUCCESS);
+    }
+    const SimBus::Counters &counters = Wire.get_bus().get_counters();
+    timing.busy_us = counters.busy_us;
+    timing.transactions = counters.transactions;
+    return timing;
+}
+
+
+static void report(const char *name, const Timing &before, const Timing &after) {
+    printf("%-34s %12s %12s\n", name, "restarted", "persistent");
+    printf("%-34s %12.1f %12.1f\n", "  simulated us per call", (double)before.wall_us / ITERATIONS,
+        (double)after.wall_us / ITERATIONS);
+    printf("%-34s %12.1f %12.1f\n", "  bus us per call", (double)before.busy_us / ITERATIONS,
+        (double)after.busy_us / ITERATIONS);
+    printf("%-34s %12.1f %12.1f\n", "  transactions per call", (double)before.transactions / ITERATIONS,
+        (double)after.transactions / ITERATIONS);
+    printf("%-34s %12.0f %12.0f\n", "  host cpu ns per call", (double)before.cpu_ns / ITERATIONS,
+        (double)after.cpu_ns / ITERATIONS);
+}
+
+
+static void single_shot() {
+    test_case("perform_single_shot_measurement() with clock stretching");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    Timing before = time_calls(sensor, true, false);
+    Timing after = time_calls(sensor, false, false);
+    report("perform_single_shot_measurement()", before, after);
+    CHECK(after.transactions == before.transactions);
+    CHECK(after.busy_us * 3 < before.busy_us);
+    CHECK(after.wall_us < before.wall_us);
+    CHECK(model.get_samples() == 2 * ITERATIONS);
+}
+
+
+static void fetch() {
+    test_case("fetch_data() at 10 mps");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+
+    Timing before = time_calls(sensor, true, true);
+    Timing after = time_calls(sensor, false, true);
+    report("fetch_data()", before, after);
+    CHECK(after.transactions == before.transactions);
+    CHECK(after.busy_us * 3 < before.busy_us);
+    CHECK(after.wall_us * 3 < before.wall_us);
+    CHECK(model.get_samples() == 2 * ITERATIONS);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    single_shot();
+    fetch();
+    return test_result();
+}
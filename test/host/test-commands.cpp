@@ -0,0 +1,132 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * The command words put on the bus for every single shot and
+ * periodic mode, with the numbered modes of the tables and the
+ * typed API, against the codes of datasheet tables 8 and 9.
+ * The typed words are also pinned with static_asserts in
+ * sht3x-dis-registers.h, this checks what reaches the bus.
+ */
+
+/*Datasheet table 8, in the order of the modes 1-6*/
+static const uint16_t SINGLE_SHOT_CODE[6] = {
+    0x2C06, 0x2C0D, 0x2C10, 0x2400, 0x240B, 0x2416
+};
+
+/*Datasheet table 9, in the order of the modes 1-15*/
+static const uint16_t PERIODIC_CODE[15] = {
+    0x2032, 0x2024, 0x202F,
+    0x2130, 0x2126, 0x212D,
+    0x2236, 0x2220, 0x222B,
+    0x2334, 0x2322, 0x2329,
+    0x2737, 0x2721, 0x272A
+};
+
+
+// Model that remembers the last command it was sent
+class RecordingSht3x : public SimSht3x {
+    public:
+        uint16_t last_command = 0;
+
+        uint8_t write(const uint8_t *data, uint8_t size) override {
+            if (size >= 2) {
+                this->last_command = (data[0] << 8) | data[1];
+            }
+            return SimSht3x::write(data, size);
+        }
+};
+
+
+static void single_shot() {
+    test_case("single shot commands");
+    for (uint8_t mode = 1; mode <= 6; mode++) {
+        Repeatability repeatability = static_cast<Repeatability>((mode - 1) % 3);
+        ClockStretching clock_stretching = static_cast<ClockStretching>((mode - 1) / 3);
+        CHECK(sht3x_single_shot_command(repeatability, clock_stretching) == SINGLE_SHOT_CODE[mode - 1]);
+
+        RecordingSht3x model;
+        Wire.get_bus().attach(model);
+        Sht3x sensor(DEVICE_ADDRESS_A);
+        sensor.begin();
+        CHECK_STATUS(sensor.perform_single_shot_measurement(mode), Sht3x::I2C_STATUS::SUCCESS);
+        CHECK(model.last_command == SINGLE_SHOT_CODE[mode - 1]);
+        CHECK_STATUS(sensor.perform_single_shot_measurement(repeatability, clock_stretching),
+            Sht3x::I2C_STATUS::SUCCESS);
+        CHECK(model.last_command == SINGLE_SHOT_CODE[mode - 1]);
+
+        /*The non-blocking start never stretches the clock*/
+        CHECK_STATUS(sensor.start_single_shot(mode), Sht3x::I2C_STATUS::SUCCESS);
+        CHECK(model.last_command == SINGLE_SHOT_CODE[3 + (mode - 1) % 3]);
+        CHECK(model.get_protocol_errors() == 0);
+        Wire.get_bus().detach_all();
+    }
+}
+
+
+static void periodic() {
+    test_case("periodic commands");
+    for (uint8_t mode = 1; mode <= 15; mode++) {
+        Mps mps = static_cast<Mps>((mode - 1) / 3);
+        Repeatability repeatability = static_cast<Repeatability>((mode - 1) % 3);
+        CHECK(sht3x_periodic_command(mps, repeatability) == PERIODIC_CODE[mode - 1]);
+
+        RecordingSht3x model;
+        Wire.get_bus().attach(model);
+        Sht3x sensor(DEVICE_ADDRESS_A);
+        sensor.begin();
+        CHECK_STATUS(sensor.set_periodic_data_acquisition(mode), Sht3x::I2C_STATUS::SUCCESS);
+        CHECK(model.last_command == PERIODIC_CODE[mode - 1]);
+        CHECK(model.get_mps() == mps);
+        CHECK(model.get_repeatability() == repeatability);
+        CHECK_STATUS(sensor.send_break_command(), Sht3x::I2C_STATUS::SUCCESS);
+        delay(BREAK_CMD_DELAY_MS);
+        CHECK_STATUS(sensor.set_periodic_data_acquisition(mps, repeatability), Sht3x::I2C_STATUS::SUCCESS);
+        CHECK(model.last_command == PERIODIC_CODE[mode - 1]);
+        CHECK(model.get_protocol_errors() == 0);
+        Wire.get_bus().detach_all();
+    }
+
+    test_step("modes outside the tables are rejected without a transfer");
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    Wire.get_bus().reset_counters();
+    CHECK_STATUS(sensor.perform_single_shot_measurement(7), Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(0), Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(16), Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK_STATUS(sensor.start_single_shot(7), Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK(Wire.get_bus().get_counters().transactions == 0);
+}
+
+
+int main() {
+    single_shot();
+    periodic();
+    return test_result();
+}
@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <math.h>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-compensation.h"
+
+/**
+ * Sht3xSelfHeatingCompensator on the model with a self heating
+ * of 0.27 C at 10 mps and a time constant of 20 s, in a room at
+ * a constant 25 C.
+ */
+
+#define AMBIENT_TEMPERATURE             25.0
+#define SELF_HEATING_RISE               0.27    /*C at 10 mps*/
+#define SELF_HEATING_TAU_S              20.0
+
+
+static void attach_model(SimSht3x &model) {
+    model.set_environment(AMBIENT_TEMPERATURE, 50.0);
+    model.set_self_heating(SELF_HEATING_RISE, SELF_HEATING_TAU_S);
+    Wire.get_bus().attach(model);
+}
+
+
+static void calibrate_from_periodic() {
+    test_case("calibrate() measures the rise and restores the periodic mode");
+    SimSht3x model;
+    attach_model(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::MEDIUM_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+
+    Sht3xSelfHeatingCompensator compensator(sensor);
+    CHECK_STATUS(compensator.calibrate(), Sht3x::I2C_STATUS::SUCCESS);
+    printf("offset at 10 mps %d (0.01 C), time constant %lu ms\n", compensator.get_offset(Mps::MPS_10),
+        (unsigned long)compensator.get_time_constant());
+    /*the 0.5 mps baseline carries 1/20 of the rise*/
+    CHECK(abs(compensator.get_offset(Mps::MPS_10) - 26) <= 2);
+    CHECK(abs(compensator.get_offset(Mps::MPS_1) - 3) <= 1);
+    CHECK(compensator.get_time_constant() > 15000 && compensator.get_time_constant() < 25000);
+    CHECK(model.get_protocol_errors() == 0);
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_mps() == Mps::MPS_1);
+    CHECK(model.get_repeatability() == Repeatability::MEDIUM_REPEATABILITY);
+    CHECK(sensor.get_acquisition_mode() == Sht3x::AcquisitionMode::PERIODIC);
+}
+
+
+static void calibrate_from_art() {
+    test_case("calibrate() from ART mode");
+    SimSht3x model;
+    attach_model(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    CHECK_STATUS(sensor.art_4_hz_measurements(), Sht3x::I2C_STATUS::SUCCESS);
+    Sht3xSelfHeatingCompensator compensator(sensor);
+    CHECK_STATUS(compensator.calibrate(60), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_protocol_errors() == 0);
+    CHECK(model.get_mode() == SimSht3x::Mode::ART);
+}
+
+
+static void compensated_across_switch() {
+    test_case("the compensated temperature across a 0.5 to 10 mps switch");
+    SimSht3x model;
+    attach_model(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    Sht3xSelfHeatingCompensator compensator(sensor);
+    CHECK_STATUS(compensator.calibrate(), Sht3x::I2C_STATUS::SUCCESS);
+
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_0_5, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    for (uint8_t i = 0; i < 60; i++) {
+        delay(2000);
+        CHECK_STATUS(compensator.fetch(), Sht3x::I2C_STATUS::SUCCESS);
+    }
+
+    CHECK_STATUS(sensor.send_break_command(), Sht3x::I2C_STATUS::SUCCESS);
+    delay(BREAK_CMD_DELAY_MS);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    double max_raw_error = 0.0;
+    double max_error = 0.0;
+    for (uint16_t i = 0; i < 1200; i++) {
+        delay(100);
+        if (compensator.fetch() != Sht3x::I2C_STATUS::SUCCESS) {
+            continue;
+        }
+        max_raw_error = fmax(max_raw_error, fabs(sensor.get_temperature() - AMBIENT_TEMPERATURE));
+        max_error = fmax(max_error, fabs(compensator.get_temperature() - AMBIENT_TEMPERATURE));
+    }
+    printf("max error over 120 s: %.3f C measured, %.3f C compensated\n", max_raw_error, max_error);
+    CHECK(max_raw_error > 0.2);
+    CHECK(max_error <= 0.03);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    calibrate_from_periodic();
+    calibrate_from_art();
+    compensated_across_switch();
+    return test_result();
+}
@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * Integer conversion against the datasheet formula over every
+ * raw value
+ */
+
+
+static void exact_over_all_raw_values() {
+    test_case("centi values are within half a digit of the formula");
+    double max_temperature_error = 0.0;
+    double max_rh_error = 0.0;
+    for (uint32_t raw = 0; raw <= 0xFFFF; raw++) {
+        double temperature = (-45.0 + 175.0 * raw / 65535.0) * 100.0;
+        double rh = (100.0 * raw / 65535.0) * 100.0;
+        max_temperature_error = fmax(max_temperature_error,
+            fabs(sht3x_temperature_centi(raw) - temperature));
+        max_rh_error = fmax(max_rh_error, fabs(sht3x_rh_centi(raw) - rh));
+    }
+    printf("max error: temperature %.4f, rh %.4f in 0.01\n", max_temperature_error, max_rh_error);
+    CHECK(max_temperature_error <= 0.5 + 1e-9);
+    CHECK(max_rh_error <= 0.5 + 1e-9);
+    CHECK(sht3x_temperature_centi(0) == -4500);
+    CHECK(sht3x_temperature_centi(0xFFFF) == 13000);
+    CHECK(sht3x_rh_centi(0xFFFF) == 10000);
+}
+
+
+static void batch_matches_scalar() {
+    test_case("batch conversion matches the scalar one");
+    static uint16_t raw[0x10000];
+    static int16_t temperature[0x10000];
+    static uint16_t rh[0x10000];
+    for (uint32_t i = 0; i <= 0xFFFF; i++) {
+        raw[i] = i;
+    }
+    sht3x_temperature_centi_batch(raw, temperature, 0x10000);
+    sht3x_rh_centi_batch(raw, rh, 0x10000);
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i <= 0xFFFF; i++) {
+        mismatches += temperature[i] != sht3x_temperature_centi(i) || rh[i] != sht3x_rh_centi(i);
+    }
+    CHECK(mismatches == 0);
+}
+
+
+static void driver_readings() {
+    test_case("the driver getters use the same conversion");
+    SimSht3x model;
+    model.set_environment(-12.34, 87.65);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sensor.get_temperature_centi() == sht3x_temperature_centi(sensor.get_temperature_raw()));
+    CHECK(sensor.get_rh_centi() == sht3x_rh_centi(sensor.get_rh_raw()));
+    CHECK(abs(sensor.get_temperature_centi() + 1234) <= 1);
+    CHECK(abs((int)sensor.get_rh_centi() - 8765) <= 1);
+    CHECK(fabs(sensor.get_temperature() - sensor.get_temperature_centi() / 100.0f) < 1e-4f);
+}
+
+
+static void raw_from_centi() {
+    test_case("centi values convert back to raw words and are clamped");
+    for (int32_t centi = SHT3X_TEMPERATURE_CENTI_MIN; centi <= SHT3X_TEMPERATURE_CENTI_MAX; centi++) {
+        if (abs(sht3x_temperature_centi(sht3x_temperature_raw(centi)) - centi) > 1) {
+            CHECK(centi == 0);
+            break;
+        }
+    }
+    CHECK(sht3x_temperature_raw(13001) == 0xFFFF);
+    CHECK(sht3x_temperature_raw(30000) == 0xFFFF);
+    CHECK(sht3x_temperature_raw(-4501) == 0);
+    CHECK(sht3x_temperature_raw(-32768) == 0);
+    CHECK(sht3x_rh_raw(10001) == 0xFFFF);
+    CHECK(sht3x_rh_raw(65535) == 0xFFFF);
+}
+
+
+static void alert_limit_range() {
+    test_case("alert limits out of the sensor range are rejected");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 13001, 8000),
+        Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::LOW_SET, -4501, 2000),
+        Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 6000, 10001),
+        Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK(Wire.get_bus().get_counters().transactions == 0);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 13000, 10000),
+        Sht3x::I2C_STATUS::SUCCESS);
+}
+
+
+int main() {
+    exact_over_all_raw_values();
+    batch_matches_scalar();
+    driver_readings();
+    raw_from_centi();
+    alert_limit_range();
+    return test_result();
+}
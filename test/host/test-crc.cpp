@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-crc.h"
+
+/**
+ * The table and bitwise CRC-8 implementations against each
+ * other and against the compile time sht3x_crc8_word() on every
+ * 16 bit data word, and on blocks as long as a log header.
+ * Built once for each value of SHT3X_CRC_BITWISE, so that
+ * sht3x_crc8() is checked in both configurations.
+ */
+
+#define BLOCK_SIZE                      14
+#define BLOCK_COUNT                     10000
+
+
+static void every_word() {
+    test_case("every data word");
+    uint32_t table_mismatches = 0;
+    uint32_t bitwise_mismatches = 0;
+    uint32_t selected_mismatches = 0;
+    for (uint32_t word = 0; word <= 0xFFFF; word++) {
+        uint8_t data[2] = {(uint8_t)(word >> 8), (uint8_t)word};
+        uint8_t expected = sht3x_crc8_word((uint16_t)word);
+        table_mismatches += sht3x_crc8_table(data, 2) != expected;
+        bitwise_mismatches += sht3x_crc8_bitwise(data, 2) != expected;
+        selected_mismatches += sht3x_crc8(data, 2) != expected;
+    }
+    CHECK(table_mismatches == 0);
+    CHECK(bitwise_mismatches == 0);
+    CHECK(selected_mismatches == 0);
+
+    const uint8_t example[2] = {0xBE, 0xEF};
+    CHECK(sht3x_crc8(example, 2) == 0x92);
+}
+
+
+static void blocks() {
+    test_case("blocks of every length");
+    uint32_t state = 1;
+    uint32_t mismatches = 0;
+    for (uint32_t block = 0; block < BLOCK_COUNT; block++) {
+        uint8_t data[BLOCK_SIZE];
+        for (uint8_t i = 0; i < BLOCK_SIZE; i++) {
+            state = state * 1103515245UL + 12345UL;
+            data[i] = (uint8_t)(state >> 16);
+        }
+        for (uint8_t size = 0; size <= BLOCK_SIZE; size++) {
+            mismatches += sht3x_crc8_table(data, size) != sht3x_crc8_bitwise(data, size);
+        }
+    }
+    CHECK(mismatches == 0);
+    CHECK(sht3x_crc8_table(nullptr, 0) == SHT3X_CRC_INIT);
+    CHECK(sht3x_crc8_bitwise(nullptr, 0) == SHT3X_CRC_INIT);
+}
+
+
+int main() {
+    printf("SHT3X_CRC_BITWISE %s\n",
+#if defined(SHT3X_CRC_BITWISE)
+        "defined"
+#else
+        "not defined"
+#endif
+    );
+    every_word();
+    blocks();
+    return test_result();
+}
@@ -0,0 +1,264 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * Behaviour of the device model, seen through the driver and
+ * through raw Wire transfers
+ */
+
+
+static uint8_t send(uint16_t command) {
+    Wire.beginTransmission(DEVICE_ADDRESS_A);
+    Wire.write(command >> 8);
+    Wire.write(command & 0xFF);
+    return Wire.endTransmission();
+}
+
+
+static void nack_until_ready() {
+    test_case("single shot read header is NACKed until the conversion is done");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Wire.begin();
+
+    CHECK(send(sht3x_single_shot_command(Repeatability::MEDIUM_REPEATABILITY,
+        ClockStretching::STRETCHING_DISABLED)) == 0);
+    CHECK(Wire.requestFrom(DEVICE_ADDRESS_A, 6) == 0);
+    CHECK(send((READ_STATUS_REGISTER_MSB << 8) | READ_STATUS_REGISTER_LSB) == 2);
+    delayMicroseconds(MID_REPEAT_MEASUREMENT_DURATION_US);
+    CHECK(Wire.requestFrom(DEVICE_ADDRESS_A, 6) == 6);
+    CHECK(Wire.requestFrom(DEVICE_ADDRESS_A, 6) == 0);
+
+    test_step("clock stretching holds the read until the conversion is done");
+    CHECK(send(sht3x_single_shot_command(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED)) == 0);
+    uint64_t start_us = SimClock::now_us();
+    CHECK(Wire.requestFrom(DEVICE_ADDRESS_A, 6) == 6);
+    CHECK(SimClock::now_us() - start_us >= HIGH_REPEAT_MEASUREMENT_DURATION_US);
+}
+
+
+static void periodic_fetch() {
+    test_case("a fetch without a new sample is NACKed");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::LOW_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE);
+    delayMicroseconds(LOW_REPEAT_MEASUREMENT_DURATION_US);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE);
+    delay(sht3x_period_ms(Mps::MPS_10));
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_samples() == 2);
+
+    test_step("a fetch after several periods returns the newest sample once");
+    delay(5 * sht3x_period_ms(Mps::MPS_10));
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE);
+}
+
+
+static void mode_changes() {
+    test_case("a mode change without a break is not executed");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_mps() == Mps::MPS_1);
+    CHECK(model.get_protocol_errors() == 1);
+    Sht3x::DeviceStatus status;
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(status.command_failed);
+
+    test_step("the sensor NACKs for 1 ms after a break");
+    model.reset_counters();
+    CHECK_STATUS(sensor.send_break_command(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_mode() == SimSht3x::Mode::IDLE);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS);
+    delay(1);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_mps() == Mps::MPS_10);
+    CHECK(model.get_protocol_errors() == 0);
+
+    test_step("ART runs at 4 Hz");
+    CHECK_STATUS(sensor.send_break_command(), Sht3x::I2C_STATUS::SUCCESS);
+    delay(1);
+    CHECK_STATUS(sensor.art_4_hz_measurements(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_mode() == SimSht3x::Mode::ART);
+    delay(1000);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_samples() == 1);
+}
+
+
+static void status_and_heater() {
+    test_case("heater, reset and status register");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    Sht3x::DeviceStatus status;
+
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(status.system_reset);
+    CHECK(status.alert_pending);
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(!status.system_reset);
+    CHECK(!status.alert_pending);
+
+    CHECK_STATUS(sensor.enable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(status.heater_on);
+    CHECK_STATUS(sensor.disable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(!model.is_heater_on());
+
+    CHECK_STATUS(sensor.enable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.soft_reset(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE);
+    delayMicroseconds(SIM_RESET_DURATION_US);
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(status.system_reset);
+    CHECK(!status.heater_on);
+
+    test_step("an unknown command is NACKed and sets the command failed bit");
+    CHECK(send(0x1234) == 3);
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(status.command_failed);
+
+    test_step("a corrupted word fails the CRC check");
+    model.corrupt_crc();
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::LOW_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::CRC_ERROR);
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::LOW_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::SUCCESS);
+}
+
+
+static void alert_limits() {
+    test_case("default alert limits");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    int16_t temperature_centi;
+    uint16_t rh_centi;
+
+    CHECK_STATUS(sensor.read_alert_limit(Sht3x::AlertLimit::HIGH_SET, temperature_centi, rh_centi),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(abs(temperature_centi - 6000) < 35);
+    CHECK(abs((int)rh_centi - 8000) < 80);
+    CHECK_STATUS(sensor.read_alert_limit(Sht3x::AlertLimit::LOW_SET, temperature_centi, rh_centi),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(abs(temperature_centi + 1000) < 35);
+    CHECK(abs((int)rh_centi - 2000) < 80);
+
+    test_step("a temperature above the high limit raises the alert");
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 2000, 9000),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_CLEAR, 1900, 8900),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.read_alert_limit(Sht3x::AlertLimit::HIGH_SET, temperature_centi, rh_centi),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(abs(temperature_centi - 2000) < 35);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    delay(200);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+    Sht3x::AlertStatus alert;
+    sensor.notify_alert();
+    CHECK_STATUS(sensor.service_alert(alert), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(alert.pending);
+    CHECK(alert.temperature_alert);
+    CHECK(!alert.rh_alert);
+}
+
+
+static void general_call() {
+    test_case("a general call resets every sensor on the bus");
+    SimSht3x model_a(DEVICE_ADDRESS_A);
+    SimSht3x model_b(DEVICE_ADDRESS_B);
+    Wire.get_bus().attach(model_a);
+    Wire.get_bus().attach(model_b);
+    Sht3x sensor_a(DEVICE_ADDRESS_A);
+    Sht3x sensor_b(DEVICE_ADDRESS_B);
+    sensor_a.begin();
+
+    CHECK_STATUS(sensor_a.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor_b.enable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor_a.general_call_reset(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model_a.get_mode() == SimSht3x::Mode::IDLE);
+    CHECK(!model_b.is_heater_on());
+    CHECK(model_b.get_status() & (1 << STATUS_SYSTEM_RESET_BIT));
+}
+
+
+static void bus_timing() {
+    test_case("transfers take 9 clocks per byte");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(Wire.get_bus().get_counters().busy_us == 290);
+    Wire.setClock(400000);
+    Wire.get_bus().reset_counters();
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(Wire.get_bus().get_counters().busy_us == 73);
+
+    test_step("nothing answers an empty address");
+    Wire.get_bus().detach_all();
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS);
+}
+
+
+int main() {
+    nack_until_ready();
+    periodic_fetch();
+    mode_changes();
+    status_and_heater();
+    alert_limits();
+    general_call();
+    bus_timing();
+    return test_result();
+}
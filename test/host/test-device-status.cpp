@@ -0,0 +1,150 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * read_device_status() with each bit of the status register
+ * driven by the model the way the sensor sets it. Every field
+ * of DeviceStatus is compared with the bit the model holds at
+ * its datasheet position, and only the bits the event sets may
+ * be set.
+ */
+
+#define ALERT_PENDING                   (1 << SIM_STATUS_ALERT_PENDING_BIT)
+#define HEATER                          (1 << SIM_STATUS_HEATER_BIT)
+#define RH_ALERT                        (1 << SIM_STATUS_RH_ALERT_BIT)
+#define T_ALERT                         (1 << SIM_STATUS_T_ALERT_BIT)
+#define SYSTEM_RESET                    (1 << SIM_STATUS_SYSTEM_RESET_BIT)
+#define COMMAND_FAILED                  (1 << SIM_STATUS_COMMAND_FAILED_BIT)
+#define WRITE_CRC_FAILED                (1 << SIM_STATUS_WRITE_CRC_FAILED_BIT)
+/*Datasheet table 21, write the high alert set limit*/
+#define WRITE_HIGH_SET_LSB              0x1D
+
+
+/**
+ * @brief Read the status and check every field against the
+ *        register of the model and the bits expected
+ */
+static void check_status(Sht3x &sensor, SimSht3x &model, uint16_t expected) {
+    Sht3x::DeviceStatus status;
+    CHECK_STATUS(sensor.read_device_status(status), Sht3x::I2C_STATUS::SUCCESS);
+    uint16_t word = model.get_status();
+    CHECK(word == expected);
+    CHECK(status.alert_pending == ((word & ALERT_PENDING) != 0));
+    CHECK(status.heater_on == ((word & HEATER) != 0));
+    CHECK(status.rh_alert == ((word & RH_ALERT) != 0));
+    CHECK(status.temperature_alert == ((word & T_ALERT) != 0));
+    CHECK(status.system_reset == ((word & SYSTEM_RESET) != 0));
+    CHECK(status.command_failed == ((word & COMMAND_FAILED) != 0));
+    CHECK(status.write_crc_failed == ((word & WRITE_CRC_FAILED) != 0));
+}
+
+
+static uint8_t send(const uint8_t *data, uint8_t size) {
+    Wire.beginTransmission(DEVICE_ADDRESS_A);
+    for (uint8_t i = 0; i < size; i++) {
+        Wire.write(data[i]);
+    }
+    return Wire.endTransmission();
+}
+
+
+/**
+ * @brief Run periodic measurements until one sample was
+ *        compared with the alert limits, then stop
+ */
+static void measure_against_limits(Sht3x &sensor) {
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    delay(200);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.send_break_command(), Sht3x::I2C_STATUS::SUCCESS);
+    delay(BREAK_CMD_DELAY_MS);
+}
+
+
+static void each_bit() {
+    test_case("each status bit");
+    SimSht3x model;
+    model.set_environment(25.0, 50.0);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    test_step("power up sets system reset and alert pending");
+    check_status(sensor, model, SYSTEM_RESET | ALERT_PENDING);
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    check_status(sensor, model, 0);
+
+    test_step("heater");
+    CHECK_STATUS(sensor.enable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    check_status(sensor, model, HEATER);
+    CHECK_STATUS(sensor.disable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    check_status(sensor, model, 0);
+
+    test_step("temperature alert");
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 2000, 9000),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_CLEAR, 1900, 8900),
+        Sht3x::I2C_STATUS::SUCCESS);
+    measure_against_limits(sensor);
+    check_status(sensor, model, T_ALERT | ALERT_PENDING);
+
+    test_step("rh alert");
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_SET, 6000, 4000),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.write_alert_limit(Sht3x::AlertLimit::HIGH_CLEAR, 5900, 3900),
+        Sht3x::I2C_STATUS::SUCCESS);
+    measure_against_limits(sensor);
+    /*the pending bit stays set until the register is cleared*/
+    check_status(sensor, model, RH_ALERT | ALERT_PENDING);
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    check_status(sensor, model, 0);
+
+    test_step("command failed");
+    const uint8_t unknown[2] = {0x12, 0x34};
+    CHECK(send(unknown, 2) == 3);
+    check_status(sensor, model, COMMAND_FAILED);
+
+    test_step("write data checksum failed");
+    uint8_t write[5] = {SIM_WRITE_ALERT_LIMIT_MSB, WRITE_HIGH_SET_LSB, 0x12, 0x34, 0};
+    write[4] = sht3x_crc8(write + 2, 2) ^ 0xFF;
+    CHECK(send(write, 5) == 0);
+    check_status(sensor, model, WRITE_CRC_FAILED);
+
+    test_step("a successful command clears both");
+    CHECK_STATUS(sensor.clear_status_register(), Sht3x::I2C_STATUS::SUCCESS);
+    check_status(sensor, model, 0);
+    CHECK(model.get_protocol_errors() == 1);
+}
+
+
+int main() {
+    each_bit();
+    return test_result();
+}
@@ -0,0 +1,212 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <chrono>
+#include <vector>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-encoder.h"
+#include "sht3x-dis-scheduler.h"
+
+/**
+ * Sht3xLogEncoder and Sht3xLogDecoder on samples fetched from
+ * the model at 10 mps with the noise of a high repeatability
+ * measurement in a room.
+ */
+
+#define LOG_SAMPLES                     20000UL
+#define DECODE_ROUNDS                   50
+/*Datasheet repeatability at high repeatability is 3 sigma*/
+#define INDOOR_TEMPERATURE_SIGMA        (0.04 / 3)
+#define INDOOR_RH_SIGMA                 (0.08 / 3)
+
+
+// Print that keeps the stream in memory
+class VectorLog : public Print {
+    public:
+        std::vector<uint8_t> data;
+
+        size_t write(uint8_t c) override {
+            data.push_back(c);
+            return 1;
+        }
+};
+
+
+static double indoor_temperature(double time_s) {
+    return 22.0 + 0.5 * sin(time_s / 600.0);
+}
+
+
+static double indoor_rh(double time_s) {
+    return 45.0 - 2.0 * sin(time_s / 900.0);
+}
+
+
+/**
+ * @brief Fetch samples from the model in periodic mode
+ *
+ * @param samples fetched samples, in order
+ * @param count number of samples to fetch
+ */
+static void fetch_indoor(std::vector<Sht3xSample> &samples, uint32_t count) {
+    static SimSht3x model;
+    model.set_environment([](double time_s, double &temperature, double &rh) {
+        temperature = indoor_temperature(time_s);
+        rh = indoor_rh(time_s);
+    });
+    model.set_noise(INDOOR_TEMPERATURE_SIGMA, INDOOR_RH_SIGMA);
+    Wire.get_bus().attach(model);
+
+    static Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+    Sht3xFetchScheduler scheduler(sensor);
+    scheduler.start();
+    while (samples.size() < count) {
+        if (scheduler.fetch_if_ready() == Sht3x::MeasurementState::READY) {
+            Sht3xSample sample = {millis(), sensor.get_temperature_raw(), sensor.get_rh_raw()};
+            samples.push_back(sample);
+        }
+        int32_t wait_ms = (int32_t)(scheduler.next_fetch_due_ms() - millis());
+        delay(wait_ms > 1 ? wait_ms : 1);
+    }
+    samples.resize(count);
+}
+
+
+static void compact_indoor_log(const std::vector<Sht3xSample> &samples, VectorLog &log) {
+    test_case("indoor noise takes at most 2 bytes per sample");
+    Sht3xLogEncoder encoder(log);
+    encoder.start(0, 100);
+    for (const Sht3xSample &sample : samples) {
+        encoder.write(sample);
+    }
+    double bytes_per_sample = (double)encoder.get_bytes_written() / encoder.get_samples_written();
+    printf("%lu samples in %lu bytes, %.3f bytes per sample\n",
+        (unsigned long)encoder.get_samples_written(), (unsigned long)encoder.get_bytes_written(),
+        bytes_per_sample);
+    CHECK(encoder.get_bytes_written() == log.data.size());
+    CHECK(bytes_per_sample <= 2.0);
+}
+
+
+static void round_trip(const std::vector<Sht3xSample> &samples, const VectorLog &log) {
+    test_case("the decoder returns the raw words and the schedule");
+    Sht3xLogDecoder decoder(log.data.data(), log.data.size());
+    Sht3xSample sample;
+    size_t count = 0;
+    uint32_t raw_diffs = 0;
+    uint32_t max_time_error_ms = 0;
+    while (decoder.next(sample) && count < samples.size()) {
+        const Sht3xSample &expected = samples[count++];
+        raw_diffs += sample.temperature_raw != expected.temperature_raw
+            || sample.rh_raw != expected.rh_raw;
+        uint32_t error = sample.timestamp_ms > expected.timestamp_ms
+            ? sample.timestamp_ms - expected.timestamp_ms : expected.timestamp_ms - sample.timestamp_ms;
+        max_time_error_ms = error > max_time_error_ms ? error : max_time_error_ms;
+    }
+    printf("%lu samples decoded, %lu raw differences, timestamps within %lu ms\n",
+        (unsigned long)count, (unsigned long)raw_diffs, (unsigned long)max_time_error_ms);
+    CHECK(count == samples.size());
+    CHECK(raw_diffs == 0);
+    CHECK(max_time_error_ms <= 50);
+    CHECK(!decoder.next(sample));
+}
+
+
+static void seek_and_off_schedule() {
+    test_case("seek() starts at a block and a gap starts a new block");
+    VectorLog log;
+    Sht3xLogEncoder encoder(log, 4);
+    encoder.start(0x15, 100);
+    for (uint32_t i = 0; i < 10; i++) {
+        Sht3xSample sample = {1000 + i * 100, (uint16_t)(26000 + (i & 1)), (uint16_t)(29000 - (i & 1))};
+        encoder.write(sample);
+    }
+    /*350 ms late, off schedule, and a jump that needs the absolute escape*/
+    Sht3xSample late = {2350, 26010, 29000};
+    encoder.write(late);
+    Sht3xSample jump = {2450, 60000, 1000};
+    encoder.write(jump);
+    /*blocks of 4, 4, 2 and 2 samples, with 1 byte deltas*/
+    CHECK(encoder.get_bytes_written() == 4 * ENCODER_BLOCK_HEADER_SIZE + 3 + 3 + 1 + ENCODER_ABSOLUTE_SIZE);
+
+    Sht3xLogDecoder decoder(log.data.data(), log.data.size());
+    size_t block = decoder.seek(1);
+    CHECK(block == ENCODER_BLOCK_HEADER_SIZE + 3);
+    Sht3xSample sample;
+    CHECK(decoder.next(sample));
+    CHECK(sample.timestamp_ms == 1400 && sample.temperature_raw == 26000 && sample.rh_raw == 29000);
+    CHECK(decoder.get_mode() == 0x15 && decoder.get_period_ms() == 100);
+    for (uint32_t i = 5; i < 10; i++) {
+        CHECK(decoder.next(sample));
+        CHECK(sample.timestamp_ms == 1000 + i * 100 && sample.temperature_raw == 26000 + (i & 1)
+            && sample.rh_raw == 29000 - (i & 1));
+    }
+    CHECK(decoder.next(sample));
+    CHECK(sample.timestamp_ms == 2350 && sample.temperature_raw == 26010);
+    CHECK(decoder.next(sample));
+    CHECK(sample.timestamp_ms == 2450 && sample.temperature_raw == 60000 && sample.rh_raw == 1000);
+    CHECK(!decoder.next(sample));
+
+    /*a corrupt header is skipped by seek()*/
+    log.data[ENCODER_BLOCK_HEADER_SIZE + 3 + 5] ^= 0x01;
+    Sht3xLogDecoder corrupt(log.data.data(), log.data.size());
+    CHECK(corrupt.seek(1) > ENCODER_BLOCK_HEADER_SIZE + 3);
+}
+
+
+static void decoder_throughput(const VectorLog &log) {
+    test_case("decoder throughput on the host");
+    Sht3xSample sample;
+    uint32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < DECODE_ROUNDS; round++) {
+        Sht3xLogDecoder decoder(log.data.data(), log.data.size());
+        while (decoder.next(sample)) {
+            checksum += sample.temperature_raw;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double bytes = (double)log.data.size() * DECODE_ROUNDS;
+    double samples = (double)LOG_SAMPLES * DECODE_ROUNDS;
+    printf("%.0f MB/s of log, %.0f MB/s of Sht3xSample, %.1f ns per sample (checksum %lu)\n",
+        bytes / seconds / 1e6, samples * sizeof(Sht3xSample) / seconds / 1e6, seconds * 1e9 / samples,
+        (unsigned long)checksum);
+}
+
+
+int main() {
+    test_case();
+    std::vector<Sht3xSample> samples;
+    fetch_indoor(samples, LOG_SAMPLES);
+    VectorLog log;
+    compact_indoor_log(samples, log);
+    round_trip(samples, log);
+    seek_and_off_schedule();
+    decoder_throughput(log);
+    return test_result();
+}
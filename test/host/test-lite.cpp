@@ -0,0 +1,189 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <memory>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-lite.h"
+
+/**
+ * Sht3xLite and sht3x_lite_sweep() on the model, with the 16
+ * sensors behind one mux of examples/lite_many_sensors.ino.
+ * Every sensor has its own temperature, so a reading from the
+ * wrong channel is caught.
+ */
+
+#define SENSOR_COUNT                    16
+
+
+// Sensor that takes the command but never finishes a conversion
+class StuckSht3x : public SimSht3x {
+    public:
+        using SimSht3x::SimSht3x;
+
+        uint8_t read(uint8_t *, uint8_t) override {
+            return 0;
+        }
+};
+
+static double temperature_of(uint8_t i) {
+    return 20.0 + 0.5 * i;
+}
+
+
+static void sweep_behind_mux() {
+    test_case("16 sensors behind a mux in one sweep");
+    SimMux sim_mux(MUX_DEFAULT_ADDRESS);
+    Wire.get_bus().attach(sim_mux);
+    std::unique_ptr<SimSht3x> models[SENSOR_COUNT];
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        models[i].reset(new SimSht3x(i % 2 == 0 ? DEVICE_ADDRESS_A : DEVICE_ADDRESS_B));
+        models[i]->set_environment(temperature_of(i), 40.0 + i);
+        Wire.get_bus().attach(*models[i], sim_mux, i / 2);
+    }
+    delay(2);
+
+    Sht3xMux mux(MUX_DEFAULT_ADDRESS);
+    /*listed channel by channel as in the example*/
+    Sht3xLite sensors[SENSOR_COUNT] = {
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 0), Sht3xLite(DEVICE_ADDRESS_B, mux, 0),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 1), Sht3xLite(DEVICE_ADDRESS_B, mux, 1),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 2), Sht3xLite(DEVICE_ADDRESS_B, mux, 2),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 3), Sht3xLite(DEVICE_ADDRESS_B, mux, 3),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 4), Sht3xLite(DEVICE_ADDRESS_B, mux, 4),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 5), Sht3xLite(DEVICE_ADDRESS_B, mux, 5),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 6), Sht3xLite(DEVICE_ADDRESS_B, mux, 6),
+        Sht3xLite(DEVICE_ADDRESS_A, mux, 7), Sht3xLite(DEVICE_ADDRESS_B, mux, 7)
+    };
+    Sht3xReading readings[SENSOR_COUNT];
+    Wire.begin();
+
+    for (uint8_t sweep = 0; sweep < 3; sweep++) {
+        uint32_t writes = sim_mux.get_writes();
+        uint32_t start_ms = millis();
+        CHECK(sht3x_lite_sweep(sensors, readings, SENSOR_COUNT, Repeatability::MEDIUM_REPEATABILITY)
+            == SENSOR_COUNT);
+        writes = sim_mux.get_writes() - writes;
+        printf("sweep %u: %lu mux writes, %lu ms\n", sweep, (unsigned long)writes,
+            (unsigned long)(millis() - start_ms));
+        /*each channel once to start and once to read*/
+        CHECK(writes == SENSOR_COUNT);
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+            CHECK_STATUS(readings[i].status, Sht3x::I2C_STATUS::SUCCESS);
+            CHECK(abs(sht3x_temperature_centi(readings[i].temperature_raw)
+                - (int16_t)(temperature_of(i) * 100)) <= 1);
+            CHECK(abs((int)sht3x_rh_centi(readings[i].rh_raw) - (int)((40.0 + i) * 100)) <= 1);
+        }
+    }
+
+    test_step("a corrupted result only fails its sensor");
+    models[5]->corrupt_crc();
+    CHECK(sht3x_lite_sweep(sensors, readings, SENSOR_COUNT) == SENSOR_COUNT - 1);
+    CHECK_STATUS(readings[5].status, Sht3x::I2C_STATUS::CRC_ERROR);
+    CHECK_STATUS(readings[4].status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(Wire.get_bus().get_counters().conflicts == 0);
+}
+
+
+static void sweep_timeout() {
+    test_case("a sensor that never finishes times out");
+    SimSht3x model(DEVICE_ADDRESS_A);
+    StuckSht3x stuck(DEVICE_ADDRESS_B);
+    Wire.get_bus().attach(model);
+    Wire.get_bus().attach(stuck);
+    delay(2);
+    Wire.begin();
+
+    Sht3xLite sensors[2] = {Sht3xLite(DEVICE_ADDRESS_A), Sht3xLite(DEVICE_ADDRESS_B)};
+    Sht3xReading readings[2];
+    uint32_t start_us = micros();
+    CHECK(sht3x_lite_sweep(sensors, readings, 2) == 1);
+    uint32_t elapsed_us = micros() - start_us;
+    CHECK_STATUS(readings[0].status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(readings[1].status, Sht3x::I2C_STATUS::TIMEOUT);
+    uint32_t duration_us = sht3x_measurement_duration_us(Repeatability::HIGH_REPEATABILITY);
+    CHECK(elapsed_us >= 2 * duration_us);
+    CHECK(elapsed_us < 2 * duration_us + 2000);
+}
+
+
+static void single_sensor() {
+    test_case("single shot, periodic and status calls");
+    SimSht3x model(DEVICE_ADDRESS_A);
+    model.set_environment(22.0, 45.0);
+    Wire.get_bus().attach(model);
+    delay(2);
+    Wire.begin();
+    Sht3xLite sensor(DEVICE_ADDRESS_A);
+
+    uint16_t status_word = 0;
+    CHECK_STATUS(sensor.read_status(status_word), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK((status_word & (1 << STATUS_SYSTEM_RESET_BIT)) != 0);
+
+    Sht3xReading reading = sensor.measure();
+    CHECK_STATUS(reading.status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sht3x_temperature_centi(reading.temperature_raw) == 2200);
+
+    CHECK_STATUS(sensor.start(Repeatability::LOW_REPEATABILITY), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.read().status, Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE);
+    delayMicroseconds(sht3x_measurement_duration_us(Repeatability::LOW_REPEATABILITY));
+    reading = sensor.read();
+    CHECK_STATUS(reading.status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sht3x_rh_centi(reading.rh_raw) == 4500);
+
+    CHECK_STATUS(sensor.start_periodic(Mps::MPS_10), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sensor.fetch().status != Sht3x::I2C_STATUS::SUCCESS);
+    delay(100);
+    CHECK_STATUS(sensor.fetch().status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sensor.fetch().status != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.stop(), Sht3x::I2C_STATUS::SUCCESS);
+    delay(BREAK_CMD_DELAY_MS);
+    CHECK(model.get_mode() == SimSht3x::Mode::IDLE);
+
+    CHECK_STATUS(sensor.soft_reset(), Sht3x::I2C_STATUS::SUCCESS);
+    delay(2);
+    CHECK_STATUS(sensor.read_status(status_word), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK((status_word & (1 << STATUS_SYSTEM_RESET_BIT)) != 0);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+static void footprint() {
+    test_case("footprint");
+    printf("sizeof(Sht3xLite) %u, sizeof(Sht3x) %u, sizeof(Sht3xReading) %u\n",
+        (unsigned)sizeof(Sht3xLite), (unsigned)sizeof(Sht3x), (unsigned)sizeof(Sht3xReading));
+    /*the bus, the mux and two bytes, 6 bytes with the 2 byte pointers of AVR*/
+    CHECK(sizeof(Sht3xLite) <= 2 * sizeof(void *) + sizeof(void *));
+    CHECK(sizeof(Sht3xLite) * 4 < sizeof(Sht3x));
+}
+
+
+int main() {
+    sweep_behind_mux();
+    sweep_timeout();
+    single_sensor();
+    footprint();
+    return test_result();
+}
@@ -0,0 +1,126 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-manager.h"
+
+/**
+ * Sht3xManager with sensors on both addresses of two buses and
+ * no mux. A sweep starts every conversion before it reads any,
+ * so it takes one conversion time plus the transfers and the
+ * 1 ms poll interval, not one conversion time per sensor.
+ */
+
+#define SENSOR_COUNT                    4
+#define TRANSFER_US                     1000    /*start and read of one sensor at 100 kHz, with margin*/
+#define POLL_INTERVAL_US                1000
+
+
+static void reset_wire1() {
+    Wire1.end();
+    Wire1.get_bus().detach_all();
+    Wire1.get_bus().reset_counters();
+}
+
+
+static void two_buses() {
+    test_case("one sweep over two addresses on two buses");
+    reset_wire1();
+    SimSht3x models[SENSOR_COUNT] = {
+        SimSht3x(DEVICE_ADDRESS_A), SimSht3x(DEVICE_ADDRESS_B),
+        SimSht3x(DEVICE_ADDRESS_A), SimSht3x(DEVICE_ADDRESS_B)
+    };
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        models[i].set_environment(20.0 + i, 40.0 + i);
+    }
+    Wire.get_bus().attach(models[0]);
+    Wire.get_bus().attach(models[1]);
+    Wire1.get_bus().attach(models[2]);
+    Wire1.get_bus().attach(models[3]);
+
+    Sht3x sensor_0(DEVICE_ADDRESS_A, Wire);
+    Sht3x sensor_1(DEVICE_ADDRESS_B, Wire);
+    Sht3x sensor_2(DEVICE_ADDRESS_A, Wire1);
+    Sht3x sensor_3(DEVICE_ADDRESS_B, Wire1);
+    Sht3x *sensors[SENSOR_COUNT] = {&sensor_0, &sensor_1, &sensor_2, &sensor_3};
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        sensors[i]->begin();
+    }
+    Sht3xManager manager(sensors, SENSOR_COUNT);
+    Sht3xResult results[SENSOR_COUNT];
+
+    for (uint8_t r = 0; r < 3; r++) {
+        Repeatability repeatability = static_cast<Repeatability>(r);
+        uint32_t duration_us = sht3x_measurement_duration_us(repeatability);
+        uint64_t start_us = SimClock::now_us();
+        CHECK(manager.sweep(results, 4 + r) == SENSOR_COUNT);
+        uint64_t sweep_us = SimClock::now_us() - start_us;
+        printf("repeatability %u: sweep %lu us, conversion %lu us, %lu us one by one\n", r,
+            (unsigned long)sweep_us, (unsigned long)duration_us,
+            (unsigned long)(SENSOR_COUNT * (duration_us + TRANSFER_US)));
+        CHECK(sweep_us >= duration_us);
+        CHECK(sweep_us <= duration_us + SENSOR_COUNT * TRANSFER_US + POLL_INTERVAL_US);
+
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+            CHECK_STATUS(results[i].status, Sht3x::I2C_STATUS::SUCCESS);
+            CHECK(fabs(results[i].temperature - (20.0f + i)) < 0.01f);
+            CHECK(fabs(results[i].rh - (40.0f + i)) < 0.01f);
+            CHECK(models[i].get_samples() == r + 1u);
+            CHECK(models[i].get_protocol_errors() == 0);
+        }
+    }
+    CHECK(Wire.get_bus().get_counters().conflicts == 0);
+    CHECK(Wire1.get_bus().get_counters().conflicts == 0);
+}
+
+
+static void missing_sensor() {
+    test_case("a sensor that does not answer does not hold up the others");
+    reset_wire1();
+    SimSht3x model_a(DEVICE_ADDRESS_A);
+    Wire.get_bus().attach(model_a);
+
+    Sht3x sensor_a(DEVICE_ADDRESS_A, Wire);
+    Sht3x sensor_b(DEVICE_ADDRESS_B, Wire);
+    Sht3x *sensors[2] = {&sensor_a, &sensor_b};
+    sensor_a.begin();
+    Sht3xManager manager(sensors, 2);
+    Sht3xResult results[2];
+
+    uint64_t start_us = SimClock::now_us();
+    CHECK(manager.sweep(results) == 1);
+    CHECK(SimClock::now_us() - start_us <= HIGH_REPEAT_MEASUREMENT_DURATION_US + 2 * TRANSFER_US
+        + POLL_INTERVAL_US);
+    CHECK_STATUS(results[0].status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(results[1].status, Sht3x::I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS);
+}
+
+
+int main() {
+    two_buses();
+    missing_sensor();
+    return test_result();
+}
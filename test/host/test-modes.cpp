@@ -0,0 +1,166 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+#include "sht3x-dis-scheduler.h"
+
+/**
+ * Bus transactions, bytes and simulated time per reading for
+ * every measurement mode, with the sensor at 25 C and 50 %RH.
+ * Periodic and ART readings are fetched with
+ * Sht3xFetchScheduler, the cost of starting the mode is left
+ * out.
+ */
+
+#define READINGS                        32
+
+static const char *REPEATABILITY_NAME[3] = {"high", "medium", "low"};
+static const char *MPS_NAME[5] = {"0.5", "1", "2", "4", "10"};
+
+
+static void report(const char *mode, const char *repeatability, uint32_t readings, uint64_t wall_us) {
+    const SimBus::Counters &counters = Wire.get_bus().get_counters();
+    printf("%-22s %-7s %8.2f %8.2f %10.0f %12.0f\n", mode, repeatability,
+        (double)counters.transactions / readings, (double)counters.bytes / readings,
+        (double)counters.busy_us / readings, (double)wall_us / readings);
+}
+
+
+static void check_reading(Sht3x &sensor) {
+    CHECK(fabs(sensor.get_temperature() - 25.0f) < 0.01f);
+    CHECK(fabs(sensor.get_rh() - 50.0f) < 0.01f);
+}
+
+
+static void single_shot(ClockStretching clock_stretching) {
+    for (uint8_t r = 0; r < 3; r++) {
+        test_case();
+        SimSht3x model;
+        Wire.get_bus().attach(model);
+        Sht3x sensor(DEVICE_ADDRESS_A);
+        sensor.begin();
+
+        uint64_t start_us = SimClock::now_us();
+        for (uint16_t i = 0; i < READINGS; i++) {
+            CHECK_STATUS(sensor.perform_single_shot_measurement(static_cast<Repeatability>(r),
+                clock_stretching), Sht3x::I2C_STATUS::SUCCESS);
+            check_reading(sensor);
+        }
+        report(clock_stretching == ClockStretching::STRETCHING_ENABLED
+            ? "single shot, stretch" : "single shot, polled", REPEATABILITY_NAME[r],
+            READINGS, SimClock::now_us() - start_us);
+
+        const SimBus::Counters &counters = Wire.get_bus().get_counters();
+        if (clock_stretching == ClockStretching::STRETCHING_ENABLED) {
+            CHECK(counters.transactions == 2 * READINGS);
+            CHECK(counters.nacks == 0);
+        }
+        CHECK(counters.bytes == 10 * READINGS + counters.nacks);
+        CHECK(model.get_samples() == READINGS);
+        CHECK(model.get_protocol_errors() == 0);
+    }
+}
+
+
+/**
+ * @brief Fetch readings with the scheduler, sleeping until the
+ *        next fetch is due
+ */
+static void fetch_readings(Sht3x &sensor, uint32_t &readings) {
+    Sht3xFetchScheduler scheduler(sensor);
+    scheduler.start();
+    Wire.get_bus().reset_counters();
+    uint32_t failures = 0;
+    while (readings < READINGS && failures < READINGS) {
+        Sht3x::MeasurementState state = scheduler.fetch_if_ready();
+        if (state == Sht3x::MeasurementState::READY) {
+            check_reading(sensor);
+            readings++;
+        } else if (state == Sht3x::MeasurementState::FAILED) {
+            failures++;
+        }
+        int32_t wait_ms = (int32_t)(scheduler.next_fetch_due_ms() - millis());
+        delay(wait_ms > 1 ? wait_ms : 1);
+    }
+    CHECK(failures == 0);
+}
+
+
+static void periodic() {
+    for (uint8_t m = 0; m < 5; m++) {
+        for (uint8_t r = 0; r < 3; r++) {
+            test_case();
+            SimSht3x model;
+            Wire.get_bus().attach(model);
+            Sht3x sensor(DEVICE_ADDRESS_A);
+            sensor.begin();
+
+            CHECK_STATUS(sensor.set_periodic_data_acquisition(static_cast<Mps>(m),
+                static_cast<Repeatability>(r)), Sht3x::I2C_STATUS::SUCCESS);
+            uint32_t readings = 0;
+            uint64_t start_us = SimClock::now_us();
+            fetch_readings(sensor, readings);
+            char mode[24];
+            snprintf(mode, sizeof(mode), "periodic %s mps", MPS_NAME[m]);
+            report(mode, REPEATABILITY_NAME[r], readings, SimClock::now_us() - start_us);
+
+            const SimBus::Counters &counters = Wire.get_bus().get_counters();
+            CHECK(readings == READINGS);
+            CHECK(counters.transactions <= 2 * READINGS + 2 * (READINGS / SCHEDULER_PROBE_INTERVAL + 1));
+            CHECK(model.get_protocol_errors() == 0);
+        }
+    }
+}
+
+
+static void art() {
+    test_case();
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.art_4_hz_measurements(), Sht3x::I2C_STATUS::SUCCESS);
+    uint32_t readings = 0;
+    uint64_t start_us = SimClock::now_us();
+    fetch_readings(sensor, readings);
+    report("art", "high", readings, SimClock::now_us() - start_us);
+    CHECK(readings == READINGS);
+    CHECK(model.get_mode() == SimSht3x::Mode::ART);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    printf("%-22s %-7s %8s %8s %10s %12s\n", "mode", "repeat", "transfer", "bytes",
+        "bus us", "wall us");
+    single_shot(ClockStretching::STRETCHING_ENABLED);
+    single_shot(ClockStretching::STRETCHING_DISABLED);
+    periodic();
+    art();
+    return test_result();
+}
@@ -0,0 +1,169 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <memory>
+#include <vector>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-manager.h"
+
+/**
+ * Sht3xManager sweeps over sensors behind muxes like
+ * examples/mux_sweep.ino: 32 sensors on two linked muxes, and
+ * muxes with the same address on two buses. Every sensor of
+ * the model has its own temperature, so a result read from the
+ * wrong sensor is caught.
+ */
+
+#define CHANNELS                        8
+#define SWEEPS                          5
+/*Writes of one pass over two linked muxes: 8 channels each and
+  one write disconnecting the other mux*/
+#define WRITES_PER_PASS                 (2 * (CHANNELS + 1))
+
+
+struct Node {
+    std::unique_ptr<SimSht3x> model;
+    std::unique_ptr<Sht3x> sensor;
+};
+
+
+static void add_node(std::vector<Node> &nodes, TwoWire &wire, uint8_t address, SimMux &sim_mux,
+    Sht3xMux &mux, uint8_t channel) {
+    Node node;
+    node.model.reset(new SimSht3x(address));
+    node.model->set_environment(20.0 + 0.25 * nodes.size(), 30.0 + nodes.size());
+    wire.get_bus().attach(*node.model, sim_mux, channel);
+    node.sensor.reset(new Sht3x(address, mux, channel));
+    nodes.push_back(std::move(node));
+}
+
+
+/**
+ * @brief Sweep and check every result against its model
+ *
+ * @return uint8_t number of sensors measured
+ */
+static uint8_t sweep_and_check(Sht3xManager &manager, std::vector<Node> &nodes, Sht3xResult *results) {
+    uint8_t measured = manager.sweep(results);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        CHECK_STATUS(results[i].status, Sht3x::I2C_STATUS::SUCCESS);
+        CHECK(fabs(results[i].temperature - (20.0 + 0.25 * i)) < 0.01);
+        CHECK(fabs(results[i].rh - (30.0 + i)) < 0.01);
+    }
+    return measured;
+}
+
+
+static void two_linked_muxes() {
+    test_case("32 sensors on two linked muxes");
+    SimMux sim_mux_a(0x70);
+    SimMux sim_mux_b(0x71);
+    Wire.get_bus().attach(sim_mux_a);
+    Wire.get_bus().attach(sim_mux_b);
+    Sht3xMux mux_a(0x70);
+    Sht3xMux mux_b(0x71);
+    mux_a.link(mux_b);
+
+    /*listed by address, so neighbours in the array sit on different channels*/
+    std::vector<Node> nodes;
+    for (uint8_t address : {DEVICE_ADDRESS_A, DEVICE_ADDRESS_B}) {
+        for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+            add_node(nodes, Wire, address, sim_mux_a, mux_a, channel);
+        }
+        for (uint8_t channel = 0; channel < CHANNELS; channel++) {
+            add_node(nodes, Wire, address, sim_mux_b, mux_b, channel);
+        }
+    }
+    Sht3x *sensors[2 * 2 * CHANNELS];
+    for (size_t i = 0; i < nodes.size(); i++) {
+        sensors[i] = nodes[i].sensor.get();
+    }
+    sensors[0]->begin();
+    Sht3xManager manager(sensors, nodes.size());
+    Sht3xResult results[2 * 2 * CHANNELS];
+
+    for (uint8_t sweep = 0; sweep < SWEEPS; sweep++) {
+        uint32_t writes = sim_mux_a.get_writes() + sim_mux_b.get_writes();
+        uint32_t start_ms = millis();
+        CHECK(sweep_and_check(manager, nodes, results) == nodes.size());
+        writes = sim_mux_a.get_writes() + sim_mux_b.get_writes() - writes;
+        printf("sweep %u: %lu mux writes, %lu ms\n", sweep, (unsigned long)writes,
+            (unsigned long)(millis() - start_ms));
+        /*one pass starts the conversions and one collects them*/
+        CHECK(writes == 2 * WRITES_PER_PASS);
+    }
+    CHECK(mux_a.get_switch_count() + mux_b.get_switch_count()
+        == sim_mux_a.get_writes() + sim_mux_b.get_writes());
+    CHECK(Wire.get_bus().get_counters().conflicts == 0);
+}
+
+
+static void same_address_on_two_buses() {
+    test_case("muxes with the same address on two buses");
+    Wire1.end();
+    Wire1.get_bus().detach_all();
+    Wire1.get_bus().reset_counters();
+    SimMux sim_mux_0(0x70);
+    SimMux sim_mux_1(0x70);
+    Wire.get_bus().attach(sim_mux_0);
+    Wire1.get_bus().attach(sim_mux_1);
+    Sht3xMux mux_0(0x70, Wire);
+    Sht3xMux mux_1(0x70, Wire1);
+
+    std::vector<Node> nodes;
+    add_node(nodes, Wire, DEVICE_ADDRESS_A, sim_mux_0, mux_0, 0);
+    add_node(nodes, Wire1, DEVICE_ADDRESS_A, sim_mux_1, mux_1, 1);
+    add_node(nodes, Wire, DEVICE_ADDRESS_A, sim_mux_0, mux_0, 1);
+    add_node(nodes, Wire1, DEVICE_ADDRESS_A, sim_mux_1, mux_1, 0);
+    Sht3x *sensors[4];
+    for (size_t i = 0; i < nodes.size(); i++) {
+        sensors[i] = nodes[i].sensor.get();
+    }
+    sensors[0]->begin();
+    sensors[1]->begin();
+    Sht3xManager manager(sensors, nodes.size());
+    Sht3xResult results[4];
+
+    for (uint8_t sweep = 0; sweep < SWEEPS; sweep++) {
+        CHECK(sweep_and_check(manager, nodes, results) == nodes.size());
+    }
+    /*each mux is on its own bus and never disconnects the other*/
+    CHECK(mux_0.get_switch_count() == sim_mux_0.get_writes());
+    CHECK(mux_1.get_switch_count() == sim_mux_1.get_writes());
+    CHECK(mux_0.get_switch_count() % 2 == 0);
+    CHECK(mux_1.get_switch_count() % 2 == 0);
+    CHECK(Wire.get_bus().get_counters().conflicts == 0);
+    CHECK(Wire1.get_bus().get_counters().conflicts == 0);
+    Wire1.end();
+    Wire1.get_bus().detach_all();
+}
+
+
+int main() {
+    two_linked_muxes();
+    same_address_on_two_buses();
+    return test_result();
+}
@@ -0,0 +1,188 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <memory>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * Exact counts of Sht3xPerfCounters for known sequences of
+ * transfers: transactions, bytes, statuses, read retries and
+ * CRC failures, and the mux control bytes written to select
+ * the channel of a sensor. Built with SHT3X_PERF_COUNTERS.
+ */
+
+#define MEASUREMENTS                    3
+
+
+static uint16_t status_count(const Sht3xPerfCounters &counters, Sht3x::I2C_STATUS status) {
+    return counters.status_count[static_cast<uint8_t>(status)];
+}
+
+
+static uint32_t histogram_total(const Sht3xPerfCounters &counters) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < SHT3X_PERF_HISTOGRAM_BUCKETS; i++) {
+        total += counters.latency_histogram[i];
+    }
+    return total;
+}
+
+
+static void single_shot() {
+    test_case("single shot with clock stretching");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    for (uint8_t i = 0; i < MEASUREMENTS; i++) {
+        CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+            ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::SUCCESS);
+    }
+    const Sht3xPerfCounters &counters = sensor.get_perf_counters();
+    CHECK(counters.transactions == 2 * MEASUREMENTS);
+    CHECK(counters.bytes_written == 2 * MEASUREMENTS);
+    CHECK(counters.bytes_read == 6 * MEASUREMENTS);
+    CHECK(status_count(counters, Sht3x::I2C_STATUS::SUCCESS) == 2 * MEASUREMENTS);
+    CHECK(counters.retries == 0);
+    CHECK(histogram_total(counters) == counters.transactions);
+
+    test_step("reset_perf_counters() clears everything");
+    sensor.reset_perf_counters();
+    CHECK(counters.transactions == 0);
+    CHECK(counters.bytes_read == 0);
+    CHECK(status_count(counters, Sht3x::I2C_STATUS::SUCCESS) == 0);
+    CHECK(histogram_total(counters) == 0);
+}
+
+
+static void retries_and_crc() {
+    test_case("NACKed polls and a corrupted result");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    CHECK_STATUS(sensor.start_single_shot(Repeatability::LOW_REPEATABILITY), Sht3x::I2C_STATUS::SUCCESS);
+    delayMicroseconds(sht3x_measurement_duration_us(Repeatability::LOW_REPEATABILITY));
+    model.inject(SimSht3x::Fault::NACK, 2);
+    CHECK(sensor.poll() == Sht3x::MeasurementState::NOT_READY);
+    CHECK(sensor.poll() == Sht3x::MeasurementState::NOT_READY);
+    CHECK(sensor.poll() == Sht3x::MeasurementState::READY);
+    CHECK_STATUS(sensor.collect(), Sht3x::I2C_STATUS::SUCCESS);
+
+    const Sht3xPerfCounters &counters = sensor.get_perf_counters();
+    CHECK(counters.transactions == 4);
+    CHECK(counters.bytes_written == 2);
+    CHECK(counters.bytes_read == 6);
+    CHECK(status_count(counters, Sht3x::I2C_STATUS::SUCCESS) == 2);
+    CHECK(status_count(counters, Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE) == 2);
+    CHECK(counters.retries == 2);
+
+    test_step("a CRC failure is counted on top of its transactions");
+    sensor.reset_perf_counters();
+    model.corrupt_crc();
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::CRC_ERROR);
+    CHECK(counters.transactions == 2);
+    CHECK(status_count(counters, Sht3x::I2C_STATUS::SUCCESS) == 2);
+    CHECK(status_count(counters, Sht3x::I2C_STATUS::CRC_ERROR) == 1);
+    CHECK(counters.retries == 0);
+}
+
+
+/**
+ * @brief Measure once and return the transactions and bytes
+ *        written that it added to the counters
+ */
+static void measure(Sht3x &sensor, uint32_t &transactions, uint32_t &bytes_written) {
+    const Sht3xPerfCounters &counters = sensor.get_perf_counters();
+    transactions = counters.transactions;
+    bytes_written = counters.bytes_written;
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::SUCCESS);
+    transactions = counters.transactions - transactions;
+    bytes_written = counters.bytes_written - bytes_written;
+}
+
+
+static void mux_writes() {
+    test_case("mux control bytes behind two linked muxes");
+    SimMux sim_mux_0(MUX_DEFAULT_ADDRESS);
+    SimMux sim_mux_1(MUX_DEFAULT_ADDRESS + 1);
+    SimSht3x model_0(DEVICE_ADDRESS_A);
+    SimSht3x model_1(DEVICE_ADDRESS_A);
+    Wire.get_bus().attach(sim_mux_0);
+    Wire.get_bus().attach(sim_mux_1);
+    Wire.get_bus().attach(model_0, sim_mux_0, 0);
+    Wire.get_bus().attach(model_1, sim_mux_1, 3);
+
+    Sht3xMux mux_0(MUX_DEFAULT_ADDRESS);
+    Sht3xMux mux_1(MUX_DEFAULT_ADDRESS + 1);
+    mux_0.link(mux_1);
+    Sht3x sensor_0(DEVICE_ADDRESS_A, mux_0, 0);
+    Sht3x sensor_1(DEVICE_ADDRESS_A, mux_1, 3);
+    sensor_0.begin();
+    sensor_1.begin();
+    uint32_t transactions;
+    uint32_t bytes_written;
+
+    test_step("the first transfer disconnects the other mux and selects the channel");
+    measure(sensor_0, transactions, bytes_written);
+    CHECK(transactions == 2 + 2);
+    CHECK(bytes_written == 2 + 2);
+
+    test_step("the channel is still selected");
+    measure(sensor_0, transactions, bytes_written);
+    CHECK(transactions == 2);
+    CHECK(bytes_written == 2);
+
+    test_step("switching to the other mux");
+    measure(sensor_1, transactions, bytes_written);
+    CHECK(transactions == 2 + 2);
+    CHECK(bytes_written == 2 + 2);
+    measure(sensor_0, transactions, bytes_written);
+    CHECK(transactions == 2 + 2);
+    CHECK(bytes_written == 2 + 2);
+
+    const Sht3xPerfCounters &counters_0 = sensor_0.get_perf_counters();
+    const Sht3xPerfCounters &counters_1 = sensor_1.get_perf_counters();
+    CHECK(counters_0.bytes_read == 3 * 6);
+    CHECK(counters_1.bytes_read == 6);
+    CHECK(counters_0.transactions + counters_1.transactions
+        == 4 * 2 + sim_mux_0.get_writes() + sim_mux_1.get_writes());
+    CHECK(status_count(counters_0, Sht3x::I2C_STATUS::SUCCESS) == counters_0.transactions);
+    CHECK(histogram_total(counters_0) == counters_0.transactions);
+}
+
+
+int main() {
+    single_shot();
+    retries_and_crc();
+    mux_writes();
+    return test_result();
+}
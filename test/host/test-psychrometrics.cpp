@@ -0,0 +1,137 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <chrono>
+#include <math.h>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * Fast psychrometrics against the exact formulas over the raw
+ * range of the sensor, and the time per call of both on the host.
+ */
+
+#define SWEEP_STEP                      7       /*raw word step of the accuracy sweep*/
+#define BENCHMARK_CALLS                 1000000UL
+/*Limits checked by the sweep, the stated errors rounded up*/
+#define MAX_DEW_POINT_ERROR             0.015f  /*C*/
+#define MAX_ABSOLUTE_HUMIDITY_ERROR     0.00025f /*relative*/
+
+static volatile float sink;
+
+
+static void accuracy_sweep() {
+    test_case("fast formulas over the raw range");
+    float dew_point_error = 0.0f;
+    float absolute_humidity_error = 0.0f;
+    uint32_t points = 0;
+    for (uint32_t temperature_raw = 0; temperature_raw < TWO_TO_THE_POWER_16; temperature_raw += SWEEP_STEP) {
+        float temperature = sht3x_temperature_centi(temperature_raw) / 100.0f;
+        for (uint32_t rh_raw = SWEEP_STEP; rh_raw < TWO_TO_THE_POWER_16; rh_raw += SWEEP_STEP) {
+            float rh = sht3x_rh_centi(rh_raw) / 100.0f;
+            float error = fabsf(sht3x_dew_point_fast(temperature, rh)
+                - sht3x_dew_point_exact(temperature, rh));
+            dew_point_error = error > dew_point_error ? error : dew_point_error;
+            float exact = sht3x_absolute_humidity_exact(temperature, rh);
+            error = fabsf(sht3x_absolute_humidity_fast(temperature, rh) - exact) / exact;
+            absolute_humidity_error = error > absolute_humidity_error ? error : absolute_humidity_error;
+            points++;
+        }
+    }
+    printf("%lu points, max dew point error %.4f C, max absolute humidity error %.4f %%\n",
+        (unsigned long)points, dew_point_error, absolute_humidity_error * 100.0f);
+    CHECK(dew_point_error < MAX_DEW_POINT_ERROR);
+    CHECK(absolute_humidity_error < MAX_ABSOLUTE_HUMIDITY_ERROR);
+}
+
+
+static void reference_values() {
+    test_case("exact formulas against reference values");
+    /*Sensirion "Introduction to Humidity": 25 C and 50 %RH*/
+    CHECK(fabsf(sht3x_dew_point_exact(25.0f, 50.0f) - 13.85f) < 0.02f);
+    CHECK(fabsf(sht3x_absolute_humidity_exact(25.0f, 50.0f) - 11.5f) < 0.1f);
+    CHECK(fabsf(sht3x_dew_point_exact(20.0f, 100.0f) - 20.0f) < 0.01f);
+    /*NWS heat index table, 90 F and 70 % give 106 F*/
+    CHECK(fabsf(sht3x_heat_index(32.22f, 70.0f) - 41.1f) < 0.3f);
+    /*Below 80 F the simple formula is used, close to the temperature*/
+    CHECK(fabsf(sht3x_heat_index(20.0f, 50.0f) - 20.0f) < 1.0f);
+}
+
+
+static void cached_getters() {
+    test_case("the driver caches the values of each reading");
+    SimSht3x model;
+    model.set_environment(25.0, 50.0);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::SUCCESS);
+    float dew_point = sensor.get_dew_point();
+    CHECK(dew_point == sht3x_dew_point(sensor.get_temperature(), sensor.get_rh()));
+    CHECK(sensor.get_dew_point() == dew_point);
+    CHECK(sensor.get_absolute_humidity() == sht3x_absolute_humidity(sensor.get_temperature(), sensor.get_rh()));
+
+    model.set_environment(10.0, 80.0);
+    CHECK_STATUS(sensor.perform_single_shot_measurement(Repeatability::HIGH_REPEATABILITY,
+        ClockStretching::STRETCHING_ENABLED), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sensor.get_dew_point() != dew_point);
+    CHECK(fabsf(sensor.get_dew_point() - sht3x_dew_point_exact(10.0f, 80.0f)) < 0.02f);
+}
+
+
+/**
+ * @brief Time one implementation
+ *
+ * @return double ns per call
+ */
+static double benchmark(float (*function)(float, float)) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCHMARK_CALLS; i++) {
+        sink = function(-40.0f + (i % 100), 5.0f + (i % 90));
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+        / BENCHMARK_CALLS;
+}
+
+
+static void host_benchmark() {
+    test_case("time per call on the host");
+    printf("dew point exact %.1f ns, fast %.1f ns\n", benchmark(sht3x_dew_point_exact),
+        benchmark(sht3x_dew_point_fast));
+    printf("absolute humidity exact %.1f ns, fast %.1f ns\n",
+        benchmark(sht3x_absolute_humidity_exact), benchmark(sht3x_absolute_humidity_fast));
+    printf("heat index %.1f ns\n", benchmark(sht3x_heat_index));
+}
+
+
+int main() {
+    accuracy_sweep();
+    reference_values();
+    cached_getters();
+    host_benchmark();
+    return test_result();
+}
@@ -0,0 +1,216 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-rate-controller.h"
+
+/**
+ * Sht3xRateController over a simulated 300 s run: calm at 22 C,
+ * a ramp of 0.1 C/s from 60 s to 90 s, calm again, and a step
+ * of 2 C at 180 s. The fetch loop follows the period of the
+ * mode like examples/adaptive_rate.ino.
+ */
+
+#define RUN_S                           300
+#define RAMP_START_S                    60.0
+#define RAMP_END_S                      90.0
+#define STEP_S                          180.0
+
+
+/**
+ * @brief Sensor that NACKs the transfers right after a break
+ */
+class NackAfterBreak : public SimSht3x {
+    public:
+        uint16_t nacks = 0;
+
+        uint8_t write(const uint8_t *data, uint8_t size) override {
+            if (this->pending > 0) {
+                this->pending--;
+                return 2;
+            }
+            uint8_t result = SimSht3x::write(data, size);
+            if (result == 0 && size == 2 && ((data[0] << 8) | data[1]) == SIM_BREAK) {
+                this->pending = this->nacks;
+                this->nacks = 0;
+            }
+            return result;
+        }
+
+    private:
+        uint16_t pending = 0;
+};
+
+
+static void room(double time_s, double &temperature, double &rh) {
+    temperature = 22.0;
+    if (time_s >= RAMP_START_S) {
+        temperature += 0.1 * ((time_s < RAMP_END_S ? time_s : RAMP_END_S) - RAMP_START_S);
+    }
+    if (time_s >= STEP_S) {
+        temperature += 2.0;
+    }
+    rh = 45.0;
+}
+
+
+static void ramp_and_step() {
+    test_case("the rate follows a ramp and a step");
+    SimSht3x model;
+    model.set_environment(room);
+    model.set_noise(0.04 / 3, 0.08 / 3);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    Sht3xRateController controller(sensor);
+    CHECK_STATUS(controller.start(), Sht3x::I2C_STATUS::SUCCESS);
+
+    uint32_t fetches = 0;
+    uint32_t ramp_fast_ms = 0;
+    uint32_t step_fast_ms = 0;
+    uint32_t ramp_slow_ms = 0;
+    while (millis() < RUN_S * 1000UL) {
+        delay(sensor.get_period_ms());
+        if (controller.fetch() != Sht3x::I2C_STATUS::SUCCESS) {
+            continue;
+        }
+        fetches++;
+        uint32_t now_ms = millis();
+        if (controller.get_mps() == Mps::MPS_10) {
+            if (ramp_fast_ms == 0 && now_ms >= RAMP_START_S * 1000) {
+                ramp_fast_ms = now_ms;
+            }
+            if (step_fast_ms == 0 && now_ms >= STEP_S * 1000) {
+                step_fast_ms = now_ms;
+            }
+        }
+        if (ramp_slow_ms == 0 && ramp_fast_ms != 0 && now_ms < STEP_S * 1000
+            && controller.get_mps() == Mps::MPS_0_5) {
+            ramp_slow_ms = now_ms;
+        }
+    }
+
+    printf("%lu fetches in %u s, %u at a fixed 10 mps, %u mode changes\n", (unsigned long)fetches,
+        RUN_S, RUN_S * 10, controller.get_mode_changes());
+    printf("10 mps %.1f s after the ramp and %.1f s after the step, 0.5 mps %.1f s after the ramp\n",
+        ramp_fast_ms / 1000.0 - RAMP_START_S, step_fast_ms / 1000.0 - STEP_S,
+        ramp_slow_ms / 1000.0 - RAMP_END_S);
+    /*one window and the period of the slowest mode*/
+    CHECK(ramp_fast_ms != 0 && ramp_fast_ms - RAMP_START_S * 1000 <= RATE_WINDOW_MS + 2000);
+    CHECK(step_fast_ms != 0 && step_fast_ms - STEP_S * 1000 <= RATE_WINDOW_MS + 2000);
+    CHECK(ramp_slow_ms != 0 && ramp_slow_ms - RAMP_END_S * 1000 <= 60000);
+    CHECK(controller.get_mps() == Mps::MPS_0_5);
+    CHECK(fetches < RUN_S * 10 / 3);
+    CHECK(model.get_protocol_errors() == 0);
+    CHECK(model.get_mps() == controller.get_mps());
+}
+
+
+static void start_while_periodic() {
+    test_case("start() stops a running acquisition first");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    CHECK_STATUS(sensor.art_4_hz_measurements(), Sht3x::I2C_STATUS::SUCCESS);
+    Sht3xRateController controller(sensor);
+    CHECK_STATUS(controller.start(Repeatability::LOW_REPEATABILITY), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_mps() == Mps::MPS_0_5);
+    CHECK(model.get_repeatability() == Repeatability::LOW_REPEATABILITY);
+
+    CHECK_STATUS(controller.start(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_repeatability() == Repeatability::HIGH_REPEATABILITY);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+/**
+ * @brief Fetch until the controller has seen one window at the
+ *        current temperature, then jump by 5 C so the next
+ *        window switches to the fastest mode
+ */
+static void jump(Sht3x &sensor, Sht3xRateController &controller, NackAfterBreak &model, double temperature) {
+    for (uint8_t i = 0; i < 2; i++) {
+        delay(sensor.get_period_ms());
+        CHECK_STATUS(controller.fetch(), Sht3x::I2C_STATUS::SUCCESS);
+        delay(RATE_WINDOW_MS);
+    }
+    model.set_environment(temperature, 45.0);
+    delay(RATE_WINDOW_MS);
+    controller.fetch();
+}
+
+
+static void set_nacked_after_break() {
+    test_case("a mode NACKed after the break falls back to the previous mode");
+    NackAfterBreak model;
+    model.set_environment(22.0, 45.0);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    Sht3xRateController controller(sensor);
+    CHECK_STATUS(controller.start(), Sht3x::I2C_STATUS::SUCCESS);
+
+    model.nacks = 1;
+    jump(sensor, controller, model, 27.0);
+    CHECK_STATUS(controller.get_last_status(), Sht3x::I2C_STATUS::RECEIVED_NACK_AT_TX_ADDRESS);
+    CHECK(controller.get_mps() == Mps::MPS_0_5);
+    CHECK(controller.get_mode_changes() == 0);
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_mps() == Mps::MPS_0_5);
+    delay(sensor.get_period_ms());
+    CHECK_STATUS(controller.fetch(), Sht3x::I2C_STATUS::SUCCESS);
+
+    test_step("the next switch goes through");
+    jump(sensor, controller, model, 32.0);
+    CHECK(controller.get_mps() == Mps::MPS_10);
+    CHECK(model.get_mps() == Mps::MPS_10);
+    CHECK(controller.get_mode_changes() == 1);
+
+    test_step("a sensor left idle is restarted by the next fetch");
+    controller.set_policy({RATE_DEFAULT_T_UP, RATE_DEFAULT_T_DOWN, RATE_DEFAULT_RH_UP, RATE_DEFAULT_RH_DOWN,
+        RATE_DEFAULT_CALM_WINDOWS, Mps::MPS_0_5, Mps::MPS_4});
+    model.nacks = 2;
+    jump(sensor, controller, model, 37.0);
+    CHECK(model.get_mode() == SimSht3x::Mode::IDLE);
+    CHECK(controller.get_mps() == Mps::MPS_10);
+    CHECK_STATUS(controller.fetch(), Sht3x::I2C_STATUS::WIRE_AVAILABLE_FALSE);
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_mps() == Mps::MPS_10);
+    delay(sensor.get_period_ms());
+    CHECK_STATUS(controller.fetch(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(controller.get_mode_changes() == 1);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    ramp_and_step();
+    start_while_periodic();
+    set_nacked_after_break();
+    return test_result();
+}
@@ -0,0 +1,171 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-recovery.h"
+
+/**
+ * Sht3xRecovery against the faults of the model: transient
+ * NACKs, a hang that only a general call reset ends, and a
+ * sensor holding SDA low. The sensor runs at 2 mps with the
+ * heater on before each fault.
+ */
+
+static void start_sensor(Sht3x &sensor) {
+    sensor.begin();
+    CHECK_STATUS(sensor.enable_heater(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_2, Repeatability::MEDIUM_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    delay(500);
+}
+
+
+static void check_restored(SimSht3x &model, Sht3x &sensor) {
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_mps() == Mps::MPS_2);
+    CHECK(model.get_repeatability() == Repeatability::MEDIUM_REPEATABILITY);
+    CHECK(model.is_heater_on());
+    CHECK(model.get_protocol_errors() == 0);
+    CHECK(sensor.get_acquisition_mode() == Sht3x::AcquisitionMode::PERIODIC);
+    delay(500);
+    CHECK_STATUS(sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+}
+
+
+static void transient_nack() {
+    test_case("transient NACKs end with a retry");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    start_sensor(sensor);
+    Sht3xRecovery recovery(sensor);
+
+    model.inject(SimSht3x::Fault::NACK, 2);
+    CHECK(sensor.fetch_data() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(recovery.recover(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.get_last_level() == Sht3xRecovery::Level::RETRY);
+    check_restored(model, sensor);
+}
+
+
+static void long_nack() {
+    test_case("a longer NACK burst ends with a soft reset");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    start_sensor(sensor);
+    Sht3xRecovery recovery(sensor);
+
+    /*the fetch and the three retries*/
+    model.inject(SimSht3x::Fault::NACK, 8);
+    CHECK(sensor.fetch_data() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(recovery.recover(), Sht3x::I2C_STATUS::SUCCESS);
+    printf("recovered at level %u\n", (unsigned)recovery.get_last_level());
+    CHECK(recovery.get_last_level() == Sht3xRecovery::Level::SOFT_RESET);
+    check_restored(model, sensor);
+}
+
+
+static void hang() {
+    test_case("a hang ends with a general call reset");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    start_sensor(sensor);
+    Sht3xRecovery recovery(sensor);
+
+    model.inject(SimSht3x::Fault::HANG, 1);
+    CHECK(sensor.fetch_data() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(recovery.recover(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.get_last_level() == Sht3xRecovery::Level::GENERAL_CALL_RESET);
+    check_restored(model, sensor);
+    CHECK(recovery.get_recoveries() == 1);
+}
+
+
+static void shared_bus() {
+    test_case("no general call on a shared bus");
+    SimSht3x model;
+    SimSht3x other(DEVICE_ADDRESS_B);
+    Wire.get_bus().attach(model);
+    Wire.get_bus().attach(other);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    Sht3x other_sensor(DEVICE_ADDRESS_B);
+    start_sensor(sensor);
+    CHECK_STATUS(other_sensor.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    Sht3xRecovery recovery(sensor);
+    recovery.set_shared_bus(true);
+
+    model.inject(SimSht3x::Fault::HANG, 1);
+    CHECK(sensor.fetch_data() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.recover() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.get_failures() == 1);
+    /*refused during the holdoff*/
+    CHECK(recovery.recover() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.get_failures() == 1);
+    /*the other sensor kept its mode*/
+    CHECK(other.get_mode() == SimSht3x::Mode::PERIODIC);
+    delay(1000);
+    CHECK_STATUS(other_sensor.fetch_data(), Sht3x::I2C_STATUS::SUCCESS);
+
+    /*after a power cycle a retry reaches the sensor, which
+      reports the reset and is configured again*/
+    model.power_cycle();
+    CHECK_STATUS(recovery.recover(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.get_last_level() == Sht3xRecovery::Level::RETRY);
+    CHECK((model.get_status() & (1 << STATUS_SYSTEM_RESET_BIT)) == 0);
+    check_restored(model, sensor);
+    CHECK(other.get_mode() == SimSht3x::Mode::PERIODIC);
+}
+
+
+static void held_sda() {
+    test_case("a held SDA is released by the bus clear");
+    SimSht3x model;
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    start_sensor(sensor);
+    Sht3xRecovery recovery(sensor, SDA, SCL);
+    recovery.set_shared_bus(true);
+
+    model.inject(SimSht3x::Fault::HOLD_SDA, 5);
+    CHECK(sensor.fetch_data() != Sht3x::I2C_STATUS::SUCCESS);
+    CHECK_STATUS(recovery.recover(), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(recovery.get_last_level() == Sht3xRecovery::Level::BUS_CLEAR);
+    CHECK(Wire.get_bus().pins_attached());
+    check_restored(model, sensor);
+}
+
+
+int main() {
+    transient_nack();
+    long_nack();
+    hang();
+    shared_bus();
+    held_sda();
+    return test_result();
+}
@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-repeatability.h"
+
+/**
+ * Sht3xRepeatabilitySelector on the model, whose noise grows
+ * with lower repeatability by the datasheet figures: 2 times
+ * for medium and 3.75 times for low in temperature.
+ */
+
+#define TARGET_TEMPERATURE_CENTI        4
+#define TARGET_RH_CENTI                 100
+
+
+static void periodic_settles_and_steps_back() {
+    test_case("periodic mode settles on medium and steps back to high");
+    SimSht3x model;
+    model.set_environment(22.0, 45.0);
+    /*0.012 C at high, 0.024 C at medium and 0.045 C at low*/
+    model.set_noise(0.012, 0.02);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    /*started by the application at another repeatability*/
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_2, Repeatability::LOW_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+
+    Sht3xRepeatabilitySelector selector(sensor, TARGET_TEMPERATURE_CENTI, TARGET_RH_CENTI);
+    CHECK_STATUS(selector.start(Mps::MPS_10), Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(model.get_repeatability() == Repeatability::HIGH_REPEATABILITY);
+    CHECK(model.get_mps() == Mps::MPS_10);
+
+    for (uint16_t i = 0; i < 600; i++) {
+        delay(100);
+        selector.fetch();
+    }
+    printf("noise %.3f C at repeatability %u\n", selector.get_temperature_noise(),
+        (unsigned)selector.get_repeatability());
+    CHECK(selector.get_repeatability() == Repeatability::MEDIUM_REPEATABILITY);
+    CHECK(model.get_repeatability() == Repeatability::MEDIUM_REPEATABILITY);
+
+    model.set_noise(0.024, 0.02);
+    for (uint16_t i = 0; i < 1200; i++) {
+        delay(100);
+        selector.fetch();
+    }
+    printf("noise doubled: %.3f C at repeatability %u\n", selector.get_temperature_noise(),
+        (unsigned)selector.get_repeatability());
+    CHECK(selector.get_repeatability() == Repeatability::HIGH_REPEATABILITY);
+    CHECK(model.get_repeatability() == Repeatability::HIGH_REPEATABILITY);
+    CHECK(model.get_mps() == Mps::MPS_10);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+static void single_shot_steps_down() {
+    test_case("single shot steps down to low with a quiet sensor");
+    SimSht3x model;
+    model.set_environment(22.0, 45.0);
+    model.set_noise(0.005, 0.01);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    Sht3xRepeatabilitySelector selector(sensor, 5, 10);
+    for (uint16_t i = 0; i < 200; i++) {
+        CHECK_STATUS(selector.measure(), Sht3x::I2C_STATUS::SUCCESS);
+    }
+    CHECK(selector.get_repeatability() == Repeatability::LOW_REPEATABILITY);
+    CHECK(model.get_repeatability() == Repeatability::LOW_REPEATABILITY);
+}
+
+
+int main() {
+    periodic_settles_and_steps_back();
+    single_shot_steps_down();
+    return test_result();
+}
@@ -0,0 +1,164 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-scheduler.h"
+
+/**
+ * Sht3x::save_state() and resume() through the wake cycle of
+ * examples/deep_sleep_resume.ino: 1 Hz acquisition and 5 s of
+ * deep sleep, where every wake starts with a new driver object
+ * and only the saved state survives.
+ */
+
+#define SLEEP_MS                        5000
+#define WAKES                           5
+
+
+struct Wake {
+    Sht3x::I2C_STATUS status;
+    uint32_t transactions;      /*from resume() to the first sample*/
+    uint32_t duration_us;
+};
+
+
+/**
+ * @brief One wake of the sketch: resume or configure, fetch the
+ *        waiting sample and save the state for the next wake
+ */
+static Wake wake(Sht3x::State &state) {
+    Sht3x sensor(DEVICE_ADDRESS_B);
+    Sht3xFetchScheduler scheduler(sensor);
+    sensor.begin();
+    uint32_t transactions = Wire.get_bus().get_counters().transactions;
+    uint32_t start_us = micros();
+
+    Wake result;
+    result.status = sensor.resume(state, SLEEP_MS);
+    if (result.status == Sht3x::I2C_STATUS::INVALID_ARGUMENT) {
+        CHECK(Wire.get_bus().get_counters().transactions == transactions);
+        result.status = sensor.clear_status_register();
+        if (result.status == Sht3x::I2C_STATUS::SUCCESS) {
+            result.status = sensor.set_periodic_data_acquisition(Mps::MPS_1,
+                Repeatability::HIGH_REPEATABILITY);
+        }
+    }
+    if (result.status == Sht3x::I2C_STATUS::SUCCESS) {
+        scheduler.start();
+        Sht3x::MeasurementState measurement = scheduler.fetch_if_ready();
+        while (measurement == Sht3x::MeasurementState::NOT_READY) {
+            delay(1);
+            measurement = scheduler.fetch_if_ready();
+        }
+        if (measurement != Sht3x::MeasurementState::READY) {
+            result.status = scheduler.get_last_status();
+        }
+        CHECK(fabs(sensor.get_temperature() - 22.0) < 0.01);
+        sensor.save_state(state);
+    }
+    result.duration_us = micros() - start_us;
+    result.transactions = Wire.get_bus().get_counters().transactions - transactions;
+    return result;
+}
+
+
+static void sleep_cycle() {
+    test_case("warm wakes resume the running sensor");
+    SimSht3x model(DEVICE_ADDRESS_B);
+    model.set_environment(22.0, 45.0);
+    Wire.get_bus().attach(model);
+    delay(2);
+
+    /*RTC memory is zero after a cold boot*/
+    Sht3x::State state;
+    memset(&state, 0, sizeof(state));
+    Wake cold = wake(state);
+    CHECK_STATUS(cold.status, Sht3x::I2C_STATUS::SUCCESS);
+    printf("cold boot: %lu transactions, %lu us\n", (unsigned long)cold.transactions,
+        (unsigned long)cold.duration_us);
+    CHECK((model.get_status() & (1 << STATUS_SYSTEM_RESET_BIT)) == 0);
+
+    for (uint8_t i = 0; i < WAKES; i++) {
+        delay(SLEEP_MS);
+        Wake warm = wake(state);
+        printf("warm wake: %lu transactions, %lu us\n", (unsigned long)warm.transactions,
+            (unsigned long)warm.duration_us);
+        CHECK_STATUS(warm.status, Sht3x::I2C_STATUS::SUCCESS);
+        /*status read and fetch*/
+        CHECK(warm.transactions == 4);
+    }
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_protocol_errors() == 0);
+
+    test_step("a reset during the sleep is detected");
+    delay(SLEEP_MS / 2);
+    model.power_cycle();
+    delay(SLEEP_MS / 2);
+    Wake reset = wake(state);
+    printf("after a reset: %lu transactions, %lu us\n", (unsigned long)reset.transactions,
+        (unsigned long)reset.duration_us);
+    CHECK_STATUS(reset.status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(reset.transactions > 4);
+    CHECK(model.get_mode() == SimSht3x::Mode::PERIODIC);
+    CHECK(model.get_mps() == Mps::MPS_1);
+    CHECK((model.get_status() & (1 << STATUS_SYSTEM_RESET_BIT)) == 0);
+
+    delay(SLEEP_MS);
+    Wake warm = wake(state);
+    CHECK_STATUS(warm.status, Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(warm.transactions == 4);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+static void invalid_state() {
+    test_case("a corrupted state is not resumed and nothing is sent");
+    SimSht3x model(DEVICE_ADDRESS_B);
+    Wire.get_bus().attach(model);
+    delay(2);
+    Sht3x sensor(DEVICE_ADDRESS_B);
+    sensor.begin();
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    Sht3x::State state;
+    sensor.save_state(state);
+    state.mps ^= 1;
+
+    uint32_t transactions = Wire.get_bus().get_counters().transactions;
+    Sht3x woken(DEVICE_ADDRESS_B);
+    woken.begin();
+    CHECK_STATUS(woken.resume(state), Sht3x::I2C_STATUS::INVALID_ARGUMENT);
+    CHECK(Wire.get_bus().get_counters().transactions == transactions);
+    /*the reset flag of the power-up is left to the caller*/
+    CHECK((model.get_status() & (1 << STATUS_SYSTEM_RESET_BIT)) != 0);
+}
+
+
+int main() {
+    sleep_cycle();
+    invalid_state();
+    return test_result();
+}
@@ -0,0 +1,155 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <thread>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-ring-buffer.h"
+
+/**
+ * Sht3xSampleRing with the producer and the consumer in two
+ * threads. Build with -DSHT3X_HOST_SANITIZE=thread to check for
+ * data races.
+ */
+
+#define SAMPLE_COUNT                    20000UL
+
+
+static Sht3xSample make_sample(uint32_t i) {
+    Sht3xSample sample = {i, (uint16_t)i, (uint16_t)~i};
+    return sample;
+}
+
+
+static bool is_sample(const Sht3xSample &sample, uint32_t i) {
+    return sample.timestamp_ms == i && sample.temperature_raw == (uint16_t)i
+        && sample.rh_raw == (uint16_t)~i;
+}
+
+
+static void in_order() {
+    test_case("every sample arrives once and in order");
+    static Sht3xSampleRing<64> ring;
+    std::thread producer([] {
+        for (uint32_t i = 0; i < SAMPLE_COUNT;) {
+            if (ring.push(make_sample(i))) {
+                i++;
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t bad = 0;
+    Sht3xSample batch[16];
+    while (expected < SAMPLE_COUNT) {
+        uint8_t count = ring.pop(batch, 16);
+        for (uint8_t i = 0; i < count; i++) {
+            bad += !is_sample(batch[i], expected++);
+        }
+    }
+    producer.join();
+    printf("%lu samples, %u overruns, %u torn or reordered\n", SAMPLE_COUNT,
+        (unsigned)ring.get_overruns(), (unsigned)bad);
+    CHECK(bad == 0);
+    CHECK(ring.size() == 0);
+}
+
+
+static void overruns_counted() {
+    test_case("a full buffer drops and counts samples");
+    static Sht3xSampleRing<8> ring;
+    std::thread producer([] {
+        for (uint32_t i = 0; i < 60000; i++) {
+            ring.push(make_sample(i));
+        }
+    });
+
+    uint32_t popped = 0;
+    uint32_t last = 0;
+    bool ordered = true;
+    Sht3xSample batch[4];
+    for (uint32_t round = 0; round < 20000; round++) {
+        uint8_t count = ring.pop(batch, 4);
+        for (uint8_t i = 0; i < count; i++) {
+            ordered = ordered && (popped == 0 || batch[i].timestamp_ms > last)
+                && is_sample(batch[i], batch[i].timestamp_ms);
+            last = batch[i].timestamp_ms;
+            popped++;
+        }
+        (void)ring.get_overruns();
+    }
+    producer.join();
+    uint8_t count;
+    while ((count = ring.pop(batch, 4)) != 0) {
+        popped += count;
+    }
+    CHECK(ordered);
+    CHECK(popped + ring.get_overruns() == 60000);
+}
+
+
+static void fetch_from_thread() {
+    test_case("a thread fetches from the sensor while loop() drains");
+    SimSht3x model;
+    model.set_environment(21.5, 40.0);
+    Wire.get_bus().attach(model);
+    static Sht3x sensor(DEVICE_ADDRESS_A);
+    static Sht3xSampleRing<16> ring;
+    sensor.begin();
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+
+    std::thread producer([] {
+        for (uint16_t i = 0; i < 200;) {
+            delay(sht3x_period_ms(Mps::MPS_10));
+            if (ring.fetch(sensor) == Sht3x::I2C_STATUS::SUCCESS) {
+                i++;
+            }
+        }
+    });
+
+    uint32_t popped = 0;
+    uint32_t wrong = 0;
+    Sht3xSample batch[8];
+    while (popped + ring.get_overruns() < 200) {
+        uint8_t count = ring.pop(batch, 8);
+        for (uint8_t i = 0; i < count; i++) {
+            wrong += abs(sht3x_temperature_centi(batch[i].temperature_raw) - 2150) > 1;
+        }
+        popped += count;
+        std::this_thread::yield();
+    }
+    producer.join();
+    CHECK(wrong == 0);
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    in_order();
+    overruns_counted();
+    fetch_from_thread();
+    return test_result();
+}
@@ -0,0 +1,216 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-sampler.h"
+#include "sht3x-dis-conversion.h"
+
+/**
+ * Sht3xSnapshotCell under one writer and several reader threads,
+ * and Sht3xSampler on the model. Run it in a build with
+ * -DSHT3X_HOST_SANITIZE=thread to check the cell for races.
+ */
+
+/*The writer never yields, on one core it is preempted at random points*/
+#define STRESS_RUN_MS                   300
+#define CLOCK_CHECK_EVERY               1024
+#define STRESS_READERS                  8
+#define YIELD_EVERY                     64
+#define SAMPLER_RUN_MS                  10000UL
+
+
+// Executor whose sleep advances the simulated clock
+class SimExecutor : public Sht3xExecutor {
+    public:
+        bool spawn(void (*task)(void *), void *argument) override {
+            this->thread = std::thread(task, argument);
+            return true;
+        }
+
+        void join() override {
+            if (this->thread.joinable()) {
+                this->thread.join();
+            }
+        }
+
+        void sleep_ms(uint32_t ms) override {
+            delay(ms);
+            std::this_thread::yield();
+        }
+
+    private:
+        std::thread thread;
+};
+
+
+/*Snapshot number i, every field is derived from i*/
+static Sht3xSnapshot numbered(uint32_t i) {
+    Sht3xSnapshot snapshot;
+    snapshot.temperature_raw = (uint16_t)i;
+    snapshot.rh_raw = (uint16_t)~i;
+    snapshot.timestamp_ms = i;
+    snapshot.status = static_cast<Sht3x::I2C_STATUS>(i % 9);
+    return snapshot;
+}
+
+
+static bool consistent(const Sht3xSnapshot &snapshot) {
+    Sht3xSnapshot expected = numbered(snapshot.timestamp_ms);
+    return snapshot.temperature_raw == expected.temperature_raw
+        && snapshot.rh_raw == expected.rh_raw
+        && snapshot.status == expected.status;
+}
+
+
+static void cell_stress() {
+    test_case("snapshots are never torn under concurrent reads");
+    Sht3xSnapshotCell cell;
+    Sht3xSnapshot snapshot;
+    CHECK(!cell.read(snapshot));
+
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> reads{0};
+    std::atomic<uint32_t> torn{0};
+    std::atomic<uint32_t> backwards{0};
+    std::vector<std::thread> readers;
+    for (uint8_t r = 0; r < STRESS_READERS; r++) {
+        readers.emplace_back([&]() {
+            uint32_t last_ms = 0;
+            uint32_t count = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                Sht3xSnapshot copy;
+                if (cell.read(copy)) {
+                    if (!consistent(copy)) {
+                        torn++;
+                    }
+                    if (copy.timestamp_ms < last_ms) {
+                        backwards++;
+                    }
+                    last_ms = copy.timestamp_ms;
+                }
+                if (++count % YIELD_EVERY == 0) {
+                    std::this_thread::yield();
+                }
+            }
+            reads += count;
+        });
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now()
+        + std::chrono::milliseconds(STRESS_RUN_MS);
+    uint32_t publishes = 0;
+    do {
+        for (uint16_t i = 0; i < CLOCK_CHECK_EVERY; i++) {
+            cell.publish(numbered(++publishes));
+        }
+    } while (std::chrono::steady_clock::now() < end);
+    done.store(true, std::memory_order_release);
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    printf("%u publishes, %u reads by %u threads, %u torn, %u out of order\n",
+        publishes, reads.load(), STRESS_READERS, torn.load(), backwards.load());
+    CHECK(reads.load() > 0);
+    CHECK(torn.load() == 0);
+    CHECK(backwards.load() == 0);
+    CHECK(cell.read(snapshot));
+    CHECK(snapshot.timestamp_ms == publishes);
+}
+
+
+/**
+ * @brief Read the sampler from this thread for SAMPLER_RUN_MS of
+ *        simulated time, the sampler thread moves the clock
+ *
+ * @return uint32_t number of different snapshots seen
+ */
+static uint32_t watch(Sht3xSampler &sampler) {
+    uint32_t seen = 0;
+    uint32_t last_ms = 0;
+    uint64_t end_us = SimClock::now_us() + SAMPLER_RUN_MS * 1000;
+    while (SimClock::now_us() < end_us && sampler.is_running()) {
+        Sht3xSnapshot snapshot;
+        if (sampler.read(snapshot) && snapshot.timestamp_ms != last_ms) {
+            CHECK(snapshot.timestamp_ms > last_ms);
+            CHECK_STATUS(snapshot.status, Sht3x::I2C_STATUS::SUCCESS);
+            int16_t temperature = sht3x_temperature_centi(snapshot.temperature_raw);
+            uint16_t rh = sht3x_rh_centi(snapshot.rh_raw);
+            CHECK(temperature >= 2199 && temperature <= 2201);
+            CHECK(rh >= 4499 && rh <= 4501);
+            last_ms = snapshot.timestamp_ms;
+            seen++;
+        }
+        std::this_thread::yield();
+    }
+    return seen;
+}
+
+
+static void sampler_runs() {
+    test_case("the sampler publishes every sample and stops the sensor");
+    SimSht3x model;
+    model.set_environment(22.0, 45.0);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    SimExecutor executor;
+    Sht3xSampler sampler(sensor, executor);
+
+    CHECK(sampler.start(Mps::MPS_10));
+    CHECK(!sampler.start(Mps::MPS_10));
+    uint32_t seen = watch(sampler);
+    CHECK(sampler.is_running());
+    sampler.stop();
+    printf("%u snapshots seen, %u samples measured\n", seen, model.get_samples());
+    CHECK(model.get_mode() == SimSht3x::Mode::IDLE);
+    CHECK(model.get_samples() >= SAMPLER_RUN_MS / 100 - 1);
+    /*the reader may miss a sample while it waits for the clock*/
+    CHECK(seen > 0 && seen <= model.get_samples());
+    CHECK(model.get_protocol_errors() == 0);
+
+    test_step("restart while the application left the sensor periodic");
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_1, Repeatability::LOW_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    CHECK(sampler.start(Mps::MPS_4, Repeatability::MEDIUM_REPEATABILITY));
+    watch(sampler);
+    CHECK(sampler.is_running());
+    CHECK(model.get_mps() == Mps::MPS_4);
+    CHECK(model.get_repeatability() == Repeatability::MEDIUM_REPEATABILITY);
+    sampler.stop();
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    cell_stress();
+    sampler_runs();
+    return test_result();
+}
@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <vector>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+#include "sht3x-dis-scheduler.h"
+
+/**
+ * Sht3xFetchScheduler against a model whose clock runs a few
+ * percent fast or slow. The learned period has to converge on
+ * the period of the sensor clock, every sample has to be
+ * fetched exactly once, and the early fetches that probe the
+ * phase may cost at most SCHEDULER_NACK_BUDGET NACKs each.
+ */
+
+#define SCHEDULER_SAMPLES               (20 * SCHEDULER_PROBE_INTERVAL)
+/*Largest deviation of the learned period at the end, 1/256 = 0.4%*/
+#define CONVERGED_SHIFT                 8
+/*NACKs per phase probe, the early fetch and one retry*/
+#define SCHEDULER_NACK_BUDGET           2
+
+static const double CLOCK_ERROR[] = {-0.04, -0.02, 0.0, 0.02, 0.04};
+
+
+static void drift(Mps mps, double clock_error) {
+    char name[48];
+    snprintf(name, sizeof(name), "%u ms period, clock error %+.0f %%",
+        (unsigned)sht3x_period_ms(mps), clock_error * 100.0);
+    test_case(name);
+
+    /*Record when each fetched sample finished on the sensor clock*/
+    std::vector<double> sample_s;
+    SimSht3x model;
+    model.set_environment([&sample_s](double time_s, double &temperature, double &rh) {
+        sample_s.push_back(time_s);
+        temperature = 25.0;
+        rh = 50.0;
+    });
+    model.set_clock_error(clock_error);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(mps, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+
+    Sht3xFetchScheduler scheduler(sensor);
+    scheduler.start();
+    Wire.get_bus().reset_counters();
+    uint32_t readings = 0;
+    uint32_t failures = 0;
+    while (readings < SCHEDULER_SAMPLES && failures < SCHEDULER_SAMPLES) {
+        Sht3x::MeasurementState state = scheduler.fetch_if_ready();
+        if (state == Sht3x::MeasurementState::READY) {
+            readings++;
+        } else if (state == Sht3x::MeasurementState::FAILED) {
+            failures++;
+        }
+        int32_t wait_ms = (int32_t)(scheduler.next_fetch_due_ms() - millis());
+        delay(wait_ms > 1 ? wait_ms : 1);
+    }
+
+    double period_s = sht3x_period_ms(mps) * (1.0 + clock_error) / 1000.0;
+    uint32_t skipped = 0;
+    for (size_t i = 1; i < sample_s.size(); i++) {
+        skipped += sample_s[i] - sample_s[i - 1] > 1.5 * period_s;
+    }
+    uint32_t period_us = (uint32_t)(period_s * 1e6);
+    uint32_t error_us = scheduler.get_period_us() > period_us
+        ? scheduler.get_period_us() - period_us : period_us - scheduler.get_period_us();
+    const SimBus::Counters &counters = Wire.get_bus().get_counters();
+    printf("learned %lu us, sensor %lu us, %lu NACKs\n", (unsigned long)scheduler.get_period_us(),
+        (unsigned long)period_us, (unsigned long)counters.nacks);
+
+    CHECK(failures == 0);
+    CHECK(readings == SCHEDULER_SAMPLES);
+    CHECK(sample_s.size() == readings);
+    CHECK(skipped == 0);
+    CHECK(error_us <= period_us >> CONVERGED_SHIFT);
+    CHECK(counters.nacks <= SCHEDULER_NACK_BUDGET * (readings / SCHEDULER_PROBE_INTERVAL + 1));
+    CHECK(model.get_protocol_errors() == 0);
+}
+
+
+int main() {
+    for (double clock_error : CLOCK_ERROR) {
+        drift(Mps::MPS_10, clock_error);
+        drift(Mps::MPS_1, clock_error);
+    }
+    return test_result();
+}
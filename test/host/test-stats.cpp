@@ -0,0 +1,126 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <math.h>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-stats.h"
+
+/**
+ * Sht3xStats against statistics computed in double over the
+ * same stream, the median filter on spikes, and the size of the
+ * state per sensor.
+ */
+
+#define STREAM_LENGTH                   1000000UL
+
+
+static void long_stream() {
+    test_case("mean and variance stay precise over a long stream");
+    Sht3xRunningStats stats;
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    uint16_t min_raw = 0xFFFF;
+    uint16_t max_raw = 0;
+    uint32_t state = 1;
+    for (uint32_t i = 0; i < STREAM_LENGTH; i++) {
+        state = state * 1103515245UL + 12345UL;
+        uint16_t raw = (uint16_t)(40000 + ((state >> 16) % 201) - 100);
+        stats.add(raw);
+        sum += raw;
+        sum_squares += (double)raw * raw;
+        min_raw = raw < min_raw ? raw : min_raw;
+        max_raw = raw > max_raw ? raw : max_raw;
+    }
+    double mean = sum / STREAM_LENGTH;
+    double variance = (sum_squares - sum * mean) / (STREAM_LENGTH - 1);
+    printf("mean %.4f (exact %.4f), variance %.2f (exact %.2f)\n", stats.get_mean_raw(), mean,
+        stats.get_variance_raw(), variance);
+    CHECK(stats.get_count() == STREAM_LENGTH);
+    CHECK(fabs(stats.get_mean_raw() - mean) < 0.05);
+    CHECK(fabs(stats.get_variance_raw() - variance) / variance < 0.01);
+    CHECK(stats.get_min_raw() == min_raw);
+    CHECK(stats.get_max_raw() == max_raw);
+    CHECK(abs((int)stats.get_ema_raw() - 40000) < 100);
+}
+
+
+static void median_removes_spikes() {
+    test_case("a median of 5 removes single sample spikes");
+    Sht3xStats<5> filtered;
+    Sht3xStats<1> unfiltered;
+    for (uint16_t i = 0; i < 100; i++) {
+        uint16_t temperature_raw = i % 10 == 9 ? 65535 : 26000;
+        filtered.add(temperature_raw, 30000);
+        unfiltered.add(temperature_raw, 30000);
+    }
+    CHECK(filtered.get_temperature_stats().get_max_raw() == 26000);
+    CHECK(unfiltered.get_temperature_stats().get_max_raw() == 65535);
+    CHECK(filtered.get_stddev_temperature() == 0.0f);
+
+    filtered.reset();
+    CHECK(filtered.get_temperature_stats().get_count() == 0);
+    filtered.add(26000, 30000);
+    CHECK(filtered.get_temperature_stats().get_max_raw() == 26000);
+}
+
+
+static void driver_fetch() {
+    test_case("fetch() adds the periodic readings of the sensor");
+    SimSht3x model;
+    model.set_environment(21.5, 40.0);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+    sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+    Sht3xStats<3> stats;
+    for (uint8_t i = 0; i < 20; i++) {
+        delay(100);
+        CHECK_STATUS(stats.fetch(sensor), Sht3x::I2C_STATUS::SUCCESS);
+    }
+    CHECK(stats.get_temperature_stats().get_count() == 20);
+    CHECK(fabs(stats.get_mean_temperature() - 21.5f) < 0.01f);
+    CHECK(fabs(stats.get_mean_rh() - 40.0f) < 0.01f);
+}
+
+
+static void state_size() {
+    test_case("state per sensor");
+    printf("Sht3xRunningStats %u, Sht3xStats<1> %u, Sht3xStats<5> %u, Sht3xStats<15> %u bytes\n",
+        (unsigned)sizeof(Sht3xRunningStats), (unsigned)sizeof(Sht3xStats<1>),
+        (unsigned)sizeof(Sht3xStats<5>), (unsigned)sizeof(Sht3xStats<15>));
+    /*The sizes stated in sht3x-dis-stats.h for targets with 4 byte alignment*/
+    CHECK(sizeof(Sht3xStats<1>) == 64);
+    CHECK(sizeof(Sht3xStats<15>) == 120);
+}
+
+
+int main() {
+    long_stream();
+    median_removes_spikes();
+    driver_fetch();
+    state_size();
+    return test_result();
+}
@@ -0,0 +1,172 @@
+/*
+MIT License
+
+Copyright (c) 2023 barbarossa12
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+
+#include <chrono>
+#include <vector>
+#include "sht3x-dis-test.h"
+#include "sht3x-dis-arduino-lib.h"
+
+/**
+ * Sht3xTraceRecorder and Sht3xTraceReplay, built with
+ * SHT3X_TRACE. A script of 2000 fetches with injected NACKs,
+ * CRC errors and a general call reset is recorded from the
+ * model and replayed into a sensor on an empty bus. Both must
+ * see the same status and raw words for every fetch.
+ */
+
+#define FETCHES                         2000
+#define RESET_AT                        1000
+#define NACK_EVERY                      250
+#define CRC_ERROR_EVERY                 333
+#define REPLAY_ROUNDS                   20
+
+
+// Print that keeps the trace in memory
+class VectorTrace : public Print {
+    public:
+        std::vector<uint8_t> data;
+
+        size_t write(uint8_t c) override {
+            data.push_back(c);
+            return 1;
+        }
+};
+
+
+struct Fetch {
+    Sht3x::I2C_STATUS status;
+    uint16_t temperature_raw;
+    uint16_t rh_raw;
+};
+
+
+/**
+ * @brief Run the script on a sensor
+ *
+ * @param model device to inject faults into, nullptr for a
+ *        replay, whose trace holds the faults
+ * @param fetches result of every fetch
+ */
+static void script(Sht3x &sensor, SimSht3x *model, std::vector<Fetch> &fetches) {
+    fetches.clear();
+    CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY),
+        Sht3x::I2C_STATUS::SUCCESS);
+    for (uint16_t i = 0; i < FETCHES; i++) {
+        delay(100);
+        if (i == RESET_AT) {
+            CHECK_STATUS(sensor.general_call_reset(), Sht3x::I2C_STATUS::SUCCESS);
+            delay(2);
+            CHECK_STATUS(sensor.set_periodic_data_acquisition(Mps::MPS_10,
+                Repeatability::HIGH_REPEATABILITY), Sht3x::I2C_STATUS::SUCCESS);
+            delay(100);
+        }
+        if (model != nullptr && i % NACK_EVERY == NACK_EVERY - 1) {
+            model->inject(SimSht3x::Fault::NACK);
+        }
+        if (model != nullptr && i % CRC_ERROR_EVERY == CRC_ERROR_EVERY - 1) {
+            model->corrupt_crc();
+        }
+        Fetch fetch;
+        fetch.status = sensor.fetch_data();
+        fetch.temperature_raw = sensor.get_temperature_raw();
+        fetch.rh_raw = sensor.get_rh_raw();
+        fetches.push_back(fetch);
+    }
+    CHECK_STATUS(sensor.send_break_command(), Sht3x::I2C_STATUS::SUCCESS);
+}
+
+
+static void record_and_replay() {
+    test_case("a replay returns the recorded fetches");
+    SimSht3x model;
+    model.set_environment(22.0, 45.0);
+    model.set_noise(0.04 / 3, 0.08 / 3);
+    Wire.get_bus().attach(model);
+    Sht3x sensor(DEVICE_ADDRESS_A);
+    sensor.begin();
+
+    VectorTrace trace;
+    Sht3xTraceRecorder recorder(trace);
+    recorder.start();
+    sensor.set_trace_recorder(&recorder);
+    std::vector<Fetch> recorded;
+    script(sensor, &model, recorded);
+    sensor.set_trace_recorder(nullptr);
+
+    uint32_t failed = 0;
+    for (const Fetch &fetch : recorded) {
+        failed += fetch.status != Sht3x::I2C_STATUS::SUCCESS;
+    }
+    printf("%lu transactions in %lu bytes, %lu failed fetches\n", (unsigned long)recorder.get_records(),
+        (unsigned long)recorder.get_bytes_written(), (unsigned long)failed);
+    CHECK(recorder.get_bytes_written() == trace.data.size());
+    CHECK(trace.data.size() <= TRACE_HEADER_SIZE + 19UL * (FETCHES + 3));
+    CHECK(failed >= FETCHES / NACK_EVERY + FETCHES / CRC_ERROR_EVERY);
+
+    /*nothing is attached to Wire1, only the replay answers*/
+    Wire1.end();
+    Wire1.get_bus().detach_all();
+    Sht3x replayed(DEVICE_ADDRESS_A, Wire1);
+    replayed.begin();
+    Sht3xTraceReplay replay(trace.data.data(), trace.data.size());
+    replayed.set_trace_replay(&replay);
+    std::vector<Fetch> replayed_fetches;
+    script(replayed, nullptr, replayed_fetches);
+
+    uint32_t differences = 0;
+    for (uint16_t i = 0; i < FETCHES; i++) {
+        differences += recorded[i].status != replayed_fetches[i].status
+            || recorded[i].temperature_raw != replayed_fetches[i].temperature_raw
+            || recorded[i].rh_raw != replayed_fetches[i].rh_raw;
+    }
+    printf("%lu differences, %lu mismatches\n", (unsigned long)differences,
+        (unsigned long)replay.get_mismatches());
+    CHECK(differences == 0);
+    CHECK(replay.get_mismatches() == 0);
+    CHECK(replay.is_done());
+    CHECK(Wire1.get_bus().get_counters().transactions == 0);
+
+    test_step("replay throughput");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    float sum = 0;
+    for (uint8_t round = 0; round < REPLAY_ROUNDS; round++) {
+        replay.rewind();
+        replayed.set_periodic_data_acquisition(Mps::MPS_10, Repeatability::HIGH_REPEATABILITY);
+        for (uint16_t i = 0; i < RESET_AT; i++) {
+            replayed.fetch_data();
+            sum += replayed.get_temperature();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%.1fM fetches/s replayed (checksum %.0f)\n", REPLAY_ROUNDS * RESET_AT / seconds / 1e6, sum);
+    Wire1.end();
+}
+
+
+int main() {
+    record_and_replay();
+    return test_result();
+}